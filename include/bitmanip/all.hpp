@@ -3,13 +3,28 @@
 
 #include "build.hpp"
 #include "builtin.hpp"
+#include "cpu.hpp"
 
 #include "bitcount.hpp"
+#include "rankselect.hpp"
+#include "setbits.hpp"
 #include "bitileave.hpp"
+#include "ileavelayout.hpp"
 #include "bitrev.hpp"
 #include "bitrot.hpp"
+#include "bittrans.hpp"
+#include "wbits.hpp"
+#include "wileave.hpp"
+#include "roaring.hpp"
+#include "shuffle.hpp"
 
 #include "intdiv.hpp"
 #include "intlog.hpp"
 
+#include "hilbert.hpp"
+#include "morton.hpp"
+#include "mortonarray.hpp"
+#include "mortonsort.hpp"
+#include "mortontree.hpp"
+
 #endif
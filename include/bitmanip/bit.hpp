@@ -1,6 +1,8 @@
 #ifndef BITMANIP_BIT_HPP
 #define BITMANIP_BIT_HPP
 
+#include "build.hpp"
+
 #include <cstdint>
 #include <type_traits>
 
@@ -27,6 +29,13 @@ constexpr unsigned bits_v = sizeof(Int) * 8;
 template <BITMANIP_INTEGRAL_TYPENAME(Int)>
 constexpr unsigned log2bits_v = "0112222333333334"[sizeof(Int) - 1] + 3 - '0';
 
+// EXTENDED INTEGER TYPES ==============================================================================================
+
+#ifdef BITMANIP_HAS_INT128
+/// Unsigned 128-bit integer which is provided by the compiler as an extension.
+__extension__ typedef unsigned __int128 uint128_t;
+#endif
+
 // TRAITS ==============================================================================================================
 
 namespace detail {
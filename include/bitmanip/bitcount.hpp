@@ -3,13 +3,22 @@
 
 #include "bit.hpp"
 #include "builtin.hpp"
+#include "cpu.hpp"
 
+#include <cstddef>
+#include <cstdint>
 #include <type_traits>
+#include <utility>
 
 #ifndef BITMANIP_HAS_BUILTIN_POPCOUNT
 #include <bitset>
 #endif
 
+#if defined(BITMANIP_X64) && (defined(BITMANIP_MSVC) || defined(BITMANIP_GNU_OR_CLANG))
+// popcnt, AVX2 and AVX-512 are detected at runtime
+#define BITMANIP_HAS_SIMD_POPCOUNT
+#endif
+
 namespace bitmanip {
 
 // CLZ AND CTZ =========================================================================================================
@@ -157,6 +166,725 @@ template <BITMANIP_UNSIGNED_TYPENAME(Uint)>
 #endif
 }
 
+// BIT SELECTION =======================================================================================================
+
+namespace detail {
+
+template <typename Uint>
+[[nodiscard]] constexpr unsigned char selectBit_naive(Uint input, unsigned k) noexcept
+{
+    for (unsigned char i = 0; i < bits_v<Uint>; ++i) {
+        if ((input >> i) & 1) {
+            if (k == 0) {
+                return i;
+            }
+            --k;
+        }
+    }
+    return bits_v<Uint>;
+}
+
+inline constexpr std::uint64_t BYTE_LSBS = 0x0101'0101'0101'0101;
+inline constexpr std::uint64_t BYTE_MSBS = 0x8080'8080'8080'8080;
+
+/**
+ * @brief Returns the index of the first byte which is greater than k, or 8 if there is none.
+ * The bytes must be at most 128 and k must be less than 128, so that adding 127 - k to each byte sets its most
+ * significant bit exactly if it's greater than k, without any carry into the next byte.
+ */
+[[nodiscard]] constexpr unsigned firstByteGreater(std::uint64_t bytes, unsigned k) noexcept
+{
+    return countTrailingZeros((bytes + (127 - k) * BYTE_LSBS) & BYTE_MSBS) / 8u;
+}
+
+/*
+ * See Vigna, Broadword Implementation of Rank/Select Queries.
+ * Multiplying the popcount of each byte by BYTE_LSBS computes the prefix sums of the bytes, from which the byte
+ * containing the k-th bit is found by comparing all bytes at once.
+ * Instead of a lookup table, the same comparison is used to select within that byte, after spreading its bits into
+ * bytes.
+ */
+[[nodiscard]] constexpr unsigned char selectBit_broadword(std::uint64_t input, unsigned k) noexcept
+{
+    std::uint64_t counts = input - ((input >> 1) & 0x5555'5555'5555'5555);
+    counts = (counts & 0x3333'3333'3333'3333) + ((counts >> 2) & 0x3333'3333'3333'3333);
+    counts = (counts + (counts >> 4)) & 0x0f0f'0f0f'0f0f'0f0f;
+    const std::uint64_t sums = counts * BYTE_LSBS;
+
+    const unsigned byte = firstByteGreater(sums, k);
+    if (byte == 8) {
+        return 64;
+    }
+    const unsigned shift = byte * 8;
+    const unsigned rank = k - static_cast<unsigned>(((sums << 8) >> shift) & 0xff);
+
+    // byte j of spread is 2^j if bit j of the byte is set, adding 0x7f to each byte sets its msb only in that case
+    const std::uint64_t spread = (((input >> shift) & 0xff) * BYTE_LSBS) & 0x8040'2010'0804'0201;
+    const std::uint64_t bits = ((spread + 0x7f7f'7f7f'7f7f'7f7f) >> 7) & BYTE_LSBS;
+    return static_cast<unsigned char>(shift + firstByteGreater(bits * BYTE_LSBS, rank));
+}
+
+}  // namespace detail
+
+/**
+ * @brief Returns the position of the k-th one-bit in a number, where k = 0 is the least significant one-bit.
+ * If the input has no more than k one-bits, the number of bits of the input type is returned.
+ * With fast pdep, this is tzcnt(pdep(1 << k, input)), otherwise a broadword algorithm is used.
+ * Example: selectBit(u8{0b1011'0100}, 2) = 5
+ * @param input the number
+ * @param k the rank of the one-bit
+ */
+template <BITMANIP_UNSIGNED_TYPENAME(Uint)>
+[[nodiscard]] constexpr unsigned char selectBit(Uint input, unsigned k) noexcept
+{
+    static_assert(sizeof(Uint) <= sizeof(std::uint64_t), "Only integers with up to 64 bits are supported");
+    if (k >= bits_v<Uint>) {
+        return bits_v<Uint>;
+    }
+#ifdef BITMANIP_HAS_BUILTIN_PDEP
+    if (not builtin::isconsteval() && CPU_FEATURES.fastPdep) {
+        return countTrailingZeros(builtin::pdep(static_cast<Uint>(Uint{1} << k), input));
+    }
+#endif
+    const unsigned char result = detail::selectBit_broadword(input, k);
+    return result == 64 ? bits_v<Uint> : result;
+}
+
+// BULK BIT COUNTING ===================================================================================================
+
+namespace detail {
+
+/// A bitwise operation which is fused into the counting of one-bits, so that its result is never stored.
+enum class BitwiseOp { IDENTITY, AND, OR, XOR, AND_NOT };
+
+/// Applies a bitwise operation, where IDENTITY ignores the second operand.
+template <BitwiseOp OP>
+[[nodiscard]] constexpr std::uint64_t applyBitwiseOp(std::uint64_t a, std::uint64_t b) noexcept
+{
+    switch (OP) {
+    case BitwiseOp::IDENTITY: return a;
+    case BitwiseOp::AND: return a & b;
+    case BitwiseOp::OR: return a | b;
+    case BitwiseOp::XOR: return a ^ b;
+    case BitwiseOp::AND_NOT: return a & ~b;
+    }
+    return a;
+}
+
+template <BitwiseOp OP>
+[[nodiscard]] constexpr std::size_t popCount_loop(const std::uint64_t a[],
+                                                  const std::uint64_t b[],
+                                                  std::size_t count) noexcept
+{
+    std::size_t result = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        result += popCount(applyBitwiseOp<OP>(a[i], b[i]));
+    }
+    return result;
+}
+
+/// Adds three numbers bitwise, storing the carry bits in high and the sum bits in low.
+constexpr void carrySaveAdd(std::uint64_t &high,
+                            std::uint64_t &low,
+                            std::uint64_t a,
+                            std::uint64_t b,
+                            std::uint64_t c) noexcept
+{
+    const std::uint64_t u = a ^ b;
+    high = (a & b) | (u & c);
+    low = u ^ c;
+}
+
+/*
+ * Harley-Seal (see Hacker's Delight, 5-1 Counting 1-Bits, or Mula, Kurz and Lemire, Faster Population Counts Using
+ * AVX2 Instructions).
+ * A tree of carry-save adders reduces 16 words into bit-sliced counters for the ones, twos, fours and eights, which
+ * are carried over to the next block, and a sixteens word.
+ * Only the sixteens word has to be counted per block of 16 words, instead of every single word.
+ */
+template <BitwiseOp OP>
+[[nodiscard]] constexpr std::size_t popCount_harleySeal(const std::uint64_t a[],
+                                                        const std::uint64_t b[],
+                                                        std::size_t count) noexcept
+{
+    std::uint64_t ones = 0, twos = 0, fours = 0, eights = 0;
+    std::uint64_t twosA = 0, twosB = 0, foursA = 0, foursB = 0, eightsA = 0, eightsB = 0, sixteens = 0;
+    std::size_t result = 0;
+
+    std::size_t i = 0;
+    const auto in = [a, b, &i](std::size_t j) {
+        return applyBitwiseOp<OP>(a[i + j], b[i + j]);
+    };
+    for (; i + 16 <= count; i += 16) {
+        carrySaveAdd(twosA, ones, ones, in(0), in(1));
+        carrySaveAdd(twosB, ones, ones, in(2), in(3));
+        carrySaveAdd(foursA, twos, twos, twosA, twosB);
+        carrySaveAdd(twosA, ones, ones, in(4), in(5));
+        carrySaveAdd(twosB, ones, ones, in(6), in(7));
+        carrySaveAdd(foursB, twos, twos, twosA, twosB);
+        carrySaveAdd(eightsA, fours, fours, foursA, foursB);
+        carrySaveAdd(twosA, ones, ones, in(8), in(9));
+        carrySaveAdd(twosB, ones, ones, in(10), in(11));
+        carrySaveAdd(foursA, twos, twos, twosA, twosB);
+        carrySaveAdd(twosA, ones, ones, in(12), in(13));
+        carrySaveAdd(twosB, ones, ones, in(14), in(15));
+        carrySaveAdd(foursB, twos, twos, twosA, twosB);
+        carrySaveAdd(eightsB, fours, fours, foursA, foursB);
+        carrySaveAdd(sixteens, eights, eights, eightsA, eightsB);
+        result += popCount(sixteens);
+    }
+
+    result = 16 * result + 8 * popCount(eights) + 4 * popCount(fours) + 2 * popCount(twos) + popCount(ones);
+    return result + popCount_loop<OP>(a + i, b + i, count - i);
+}
+
+#ifdef BITMANIP_HAS_SIMD_POPCOUNT
+// without the popcnt target, __builtin_popcountll would be compiled to a software fallback
+template <BitwiseOp OP>
+BITMANIP_TARGET("popcnt")
+inline std::size_t popCount_popcnt(const std::uint64_t a[], const std::uint64_t b[], std::size_t count) noexcept
+{
+    std::uint64_t result = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        result += static_cast<std::uint64_t>(_mm_popcnt_u64(applyBitwiseOp<OP>(a[i], b[i])));
+    }
+    return static_cast<std::size_t>(result);
+}
+
+/// Loads the i-th vector of a and b and applies a bitwise operation.
+template <BitwiseOp OP>
+BITMANIP_TARGET("avx2")
+inline __m256i loadBitwiseOp_avx2(const __m256i a[], const __m256i b[], std::size_t i) noexcept
+{
+    const __m256i x = _mm256_loadu_si256(a + i);
+    switch (OP) {
+    case BitwiseOp::IDENTITY: return x;
+    case BitwiseOp::AND: return _mm256_and_si256(x, _mm256_loadu_si256(b + i));
+    case BitwiseOp::OR: return _mm256_or_si256(x, _mm256_loadu_si256(b + i));
+    case BitwiseOp::XOR: return _mm256_xor_si256(x, _mm256_loadu_si256(b + i));
+    case BitwiseOp::AND_NOT: return _mm256_andnot_si256(_mm256_loadu_si256(b + i), x);
+    }
+    return x;
+}
+
+/// Counts the bits in each byte using a table lookup per nibble, then sums up the counts of each 64-bit lane.
+BITMANIP_TARGET("avx2")
+inline __m256i popCountLanes_avx2(__m256i x) noexcept
+{
+    const __m256i table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,  //
+                                           0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i nibbleMask = _mm256_set1_epi8(0x0f);
+    const __m256i lo = _mm256_shuffle_epi8(table, _mm256_and_si256(x, nibbleMask));
+    const __m256i hi = _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(x, 4), nibbleMask));
+    return _mm256_sad_epu8(_mm256_add_epi8(lo, hi), _mm256_setzero_si256());
+}
+
+BITMANIP_TARGET("avx2")
+inline void carrySaveAdd_avx2(__m256i &high, __m256i &low, __m256i a, __m256i b, __m256i c) noexcept
+{
+    const __m256i u = _mm256_xor_si256(a, b);
+    high = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(u, c));
+    low = _mm256_xor_si256(u, c);
+}
+
+/**
+ * @brief Performs Harley-Seal on blocks of 16 vectors.
+ * @param result receives the number of one-bits in the words which have been processed
+ * @return the number of words which have been processed, which is a multiple of 64
+ */
+template <BitwiseOp OP>
+BITMANIP_TARGET("avx2")
+inline std::size_t popCount_avx2(const std::uint64_t a[],
+                                 const std::uint64_t b[],
+                                 std::size_t count,
+                                 std::size_t &result) noexcept
+{
+    const auto *const va = reinterpret_cast<const __m256i *>(a);
+    const auto *const vb = reinterpret_cast<const __m256i *>(b);
+    const std::size_t vectorCount = count / 4 / 16 * 16;
+
+    __m256i total = _mm256_setzero_si256();
+    __m256i ones = _mm256_setzero_si256(), twos = ones, fours = ones, eights = ones;
+    __m256i twosA, twosB, foursA, foursB, eightsA, eightsB, sixteens;
+
+    for (std::size_t i = 0; i < vectorCount; i += 16) {
+        const __m256i *const pa = va + i;
+        const __m256i *const pb = vb + i;
+        carrySaveAdd_avx2(twosA, ones, ones, loadBitwiseOp_avx2<OP>(pa, pb, 0), loadBitwiseOp_avx2<OP>(pa, pb, 1));
+        carrySaveAdd_avx2(twosB, ones, ones, loadBitwiseOp_avx2<OP>(pa, pb, 2), loadBitwiseOp_avx2<OP>(pa, pb, 3));
+        carrySaveAdd_avx2(foursA, twos, twos, twosA, twosB);
+        carrySaveAdd_avx2(twosA, ones, ones, loadBitwiseOp_avx2<OP>(pa, pb, 4), loadBitwiseOp_avx2<OP>(pa, pb, 5));
+        carrySaveAdd_avx2(twosB, ones, ones, loadBitwiseOp_avx2<OP>(pa, pb, 6), loadBitwiseOp_avx2<OP>(pa, pb, 7));
+        carrySaveAdd_avx2(foursB, twos, twos, twosA, twosB);
+        carrySaveAdd_avx2(eightsA, fours, fours, foursA, foursB);
+        carrySaveAdd_avx2(twosA, ones, ones, loadBitwiseOp_avx2<OP>(pa, pb, 8), loadBitwiseOp_avx2<OP>(pa, pb, 9));
+        carrySaveAdd_avx2(twosB, ones, ones, loadBitwiseOp_avx2<OP>(pa, pb, 10), loadBitwiseOp_avx2<OP>(pa, pb, 11));
+        carrySaveAdd_avx2(foursA, twos, twos, twosA, twosB);
+        carrySaveAdd_avx2(twosA, ones, ones, loadBitwiseOp_avx2<OP>(pa, pb, 12), loadBitwiseOp_avx2<OP>(pa, pb, 13));
+        carrySaveAdd_avx2(twosB, ones, ones, loadBitwiseOp_avx2<OP>(pa, pb, 14), loadBitwiseOp_avx2<OP>(pa, pb, 15));
+        carrySaveAdd_avx2(foursB, twos, twos, twosA, twosB);
+        carrySaveAdd_avx2(eightsB, fours, fours, foursA, foursB);
+        carrySaveAdd_avx2(sixteens, eights, eights, eightsA, eightsB);
+        total = _mm256_add_epi64(total, popCountLanes_avx2(sixteens));
+    }
+
+    total = _mm256_slli_epi64(total, 4);
+    total = _mm256_add_epi64(total, _mm256_slli_epi64(popCountLanes_avx2(eights), 3));
+    total = _mm256_add_epi64(total, _mm256_slli_epi64(popCountLanes_avx2(fours), 2));
+    total = _mm256_add_epi64(total, _mm256_slli_epi64(popCountLanes_avx2(twos), 1));
+    total = _mm256_add_epi64(total, popCountLanes_avx2(ones));
+
+    const __m128i sum = _mm_add_epi64(_mm256_castsi256_si128(total), _mm256_extracti128_si256(total, 1));
+    result = static_cast<std::size_t>(_mm_cvtsi128_si64(sum) + _mm_extract_epi64(sum, 1));
+    return vectorCount * 4;
+}
+
+/// Applies a bitwise operation to vectors which have been loaded from a and b.
+template <BitwiseOp OP>
+BITMANIP_TARGET("avx512f")
+inline __m512i applyBitwiseOp_avx512(__m512i a, __m512i b) noexcept
+{
+    switch (OP) {
+    case BitwiseOp::IDENTITY: return a;
+    case BitwiseOp::AND: return _mm512_and_si512(a, b);
+    case BitwiseOp::OR: return _mm512_or_si512(a, b);
+    case BitwiseOp::XOR: return _mm512_xor_si512(a, b);
+    // _mm512_andnot_si512 triggers -Wmaybe-uninitialized in the headers of GCC 12, 0x30 is the truth table of a & ~b
+    case BitwiseOp::AND_NOT: return _mm512_ternarylogic_epi64(a, b, b, 0x30);
+    }
+    return a;
+}
+
+template <BitwiseOp OP>
+BITMANIP_TARGET("avx512f,avx512vpopcntdq")
+inline __m512i popCountStep_avx512(__m512i total, const std::uint64_t a[], const std::uint64_t b[]) noexcept
+{
+    // for IDENTITY, the load from b is unused and optimized away
+    const __m512i x = applyBitwiseOp_avx512<OP>(_mm512_loadu_si512(a), _mm512_loadu_si512(b));
+    return _mm512_add_epi64(total, _mm512_popcnt_epi64(x));
+}
+
+template <BitwiseOp OP>
+BITMANIP_TARGET("avx512f,avx512vpopcntdq")
+inline std::size_t popCount_avx512(const std::uint64_t a[], const std::uint64_t b[], std::size_t count) noexcept
+{
+    // independent accumulators hide the latency of vpopcntq
+    __m512i total0 = _mm512_setzero_si512(), total1 = total0, total2 = total0, total3 = total0;
+
+    std::size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        total0 = popCountStep_avx512<OP>(total0, a + i + 0, b + i + 0);
+        total1 = popCountStep_avx512<OP>(total1, a + i + 8, b + i + 8);
+        total2 = popCountStep_avx512<OP>(total2, a + i + 16, b + i + 16);
+        total3 = popCountStep_avx512<OP>(total3, a + i + 24, b + i + 24);
+    }
+    for (; i + 8 <= count; i += 8) {
+        total0 = popCountStep_avx512<OP>(total0, a + i, b + i);
+    }
+    // the masked loads don't touch the words past the end, and every operation maps zeros to zero
+    const auto tailMask = static_cast<__mmask8>((1u << (count - i)) - 1);
+    const __m512i tail =
+        applyBitwiseOp_avx512<OP>(_mm512_maskz_loadu_epi64(tailMask, a + i), _mm512_maskz_loadu_epi64(tailMask, b + i));
+    total1 = _mm512_add_epi64(total1, _mm512_popcnt_epi64(tail));
+
+    const __m512i total = _mm512_add_epi64(_mm512_add_epi64(total0, total1), _mm512_add_epi64(total2, total3));
+    // _mm512_reduce_add_epi64 triggers -Wuninitialized in the headers of GCC 12
+    std::uint64_t lanes[8];
+    _mm512_storeu_si512(lanes, total);
+    std::uint64_t result = 0;
+    for (std::uint64_t lane : lanes) {
+        result += lane;
+    }
+    return static_cast<std::size_t>(result);
+}
+#endif
+
+template <BitwiseOp OP>
+[[nodiscard]] constexpr std::size_t popCount_dispatch(const std::uint64_t a[],
+                                                      const std::uint64_t b[],
+                                                      std::size_t count) noexcept
+{
+    if (builtin::isconsteval()) {
+        return popCount_loop<OP>(a, b, count);
+    }
+#ifdef BITMANIP_HAS_SIMD_POPCOUNT
+    if (CPU_FEATURES.avx512vpopcntdq) {
+        return popCount_avx512<OP>(a, b, count);
+    }
+    if (CPU_FEATURES.avx2) {
+        std::size_t result = 0;
+        const std::size_t done = popCount_avx2<OP>(a, b, count, result);
+        // every CPU with AVX2 also has popcnt
+        return result + popCount_popcnt<OP>(a + done, b + done, count - done);
+    }
+#endif
+    return popCount_harleySeal<OP>(a, b, count);
+}
+
+}  // namespace detail
+
+/**
+ * @brief Counts the number of one-bits in an array of words.
+ * This is equivalent to the sum of popCount(input[i]) for every i < count.
+ *
+ * The fastest available implementation is chosen at runtime:
+ * vpopcntq with AVX-512, Harley-Seal with AVX2, or Harley-Seal on scalar words.
+ * The latter is faster than popcnt on every word, even if the sixteens are counted without popcnt.
+ * In constant evaluation, every word is counted separately.
+ * @param input the words
+ * @param count the number of words
+ */
+[[nodiscard]] constexpr std::size_t popCount(const std::uint64_t input[], std::size_t count) noexcept
+{
+    return detail::popCount_dispatch<detail::BitwiseOp::IDENTITY>(input, input, count);
+}
+
+/**
+ * @brief Counts the number of one-bits in the bitwise AND of two arrays, without storing the AND.
+ * This is equivalent to the sum of popCount(a[i] & b[i]) for every i < count, which is the size of the intersection
+ * of two bitsets.
+ * The implementation is chosen like in popCount(input, count).
+ */
+[[nodiscard]] constexpr std::size_t popCountAnd(const std::uint64_t a[],
+                                                const std::uint64_t b[],
+                                                std::size_t count) noexcept
+{
+    return detail::popCount_dispatch<detail::BitwiseOp::AND>(a, b, count);
+}
+
+/**
+ * @brief Counts the number of one-bits in the bitwise OR of two arrays, without storing the OR.
+ * This is equivalent to the sum of popCount(a[i] | b[i]) for every i < count, which is the size of the union of two
+ * bitsets.
+ */
+[[nodiscard]] constexpr std::size_t popCountOr(const std::uint64_t a[],
+                                               const std::uint64_t b[],
+                                               std::size_t count) noexcept
+{
+    return detail::popCount_dispatch<detail::BitwiseOp::OR>(a, b, count);
+}
+
+/**
+ * @brief Counts the number of one-bits in the bitwise XOR of two arrays, without storing the XOR.
+ * This is equivalent to the sum of popCount(a[i] ^ b[i]) for every i < count, which is the Hamming distance.
+ */
+[[nodiscard]] constexpr std::size_t popCountXor(const std::uint64_t a[],
+                                                const std::uint64_t b[],
+                                                std::size_t count) noexcept
+{
+    return detail::popCount_dispatch<detail::BitwiseOp::XOR>(a, b, count);
+}
+
+/**
+ * @brief Counts the number of one-bits in a AND NOT b, without storing the result.
+ * This is equivalent to the sum of popCount(a[i] & ~b[i]) for every i < count, which is the size of the difference
+ * of two bitsets.
+ */
+[[nodiscard]] constexpr std::size_t popCountAndNot(const std::uint64_t a[],
+                                                   const std::uint64_t b[],
+                                                   std::size_t count) noexcept
+{
+    return detail::popCount_dispatch<detail::BitwiseOp::AND_NOT>(a, b, count);
+}
+
+// POSITIONAL BIT COUNTING =============================================================================================
+
+namespace detail {
+
+template <typename Uint>
+constexpr void positionalPopCount_naive(const Uint input[], std::size_t count, std::uint64_t counts[]) noexcept
+{
+    for (std::size_t b = 0; b < bits_v<Uint>; ++b) {
+        counts[b] = 0;
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+        for (std::size_t b = 0; b < bits_v<Uint>; ++b) {
+            counts[b] += (input[i] >> b) & 1;
+        }
+    }
+}
+
+/// Adds weight to the count of every bit position where a word has a one-bit.
+template <typename Uint>
+constexpr void addPositionalBits(std::uint64_t word, std::uint64_t weight, std::uint64_t counts[]) noexcept
+{
+    for (std::size_t b = 0; b < bits_v<Uint>; ++b) {
+        counts[b] += ((word >> b) & 1) * weight;
+    }
+}
+
+/*
+ * The carry-save adders of popCount_harleySeal() don't mix different bit positions, so they reduce 16 words into
+ * bit-sliced counters for each bit position at once.
+ * Only the positions of the sixteens word have to be counted separately per block of 16 words.
+ * Every word is zero-extended to 64 bits, where the bits above bits_v<Uint> remain zero.
+ */
+template <typename Uint>
+constexpr void positionalPopCount_harleySeal(const Uint input[], std::size_t count, std::uint64_t counts[]) noexcept
+{
+    std::uint64_t ones = 0, twos = 0, fours = 0, eights = 0;
+    std::uint64_t twosA = 0, twosB = 0, foursA = 0, foursB = 0, eightsA = 0, eightsB = 0, sixteens = 0;
+    std::uint64_t sixteensCounts[bits_v<Uint>]{};
+
+    std::size_t i = 0;
+    const auto in = [input, &i](std::size_t j) -> std::uint64_t {
+        return input[i + j];
+    };
+    for (; i + 16 <= count; i += 16) {
+        carrySaveAdd(twosA, ones, ones, in(0), in(1));
+        carrySaveAdd(twosB, ones, ones, in(2), in(3));
+        carrySaveAdd(foursA, twos, twos, twosA, twosB);
+        carrySaveAdd(twosA, ones, ones, in(4), in(5));
+        carrySaveAdd(twosB, ones, ones, in(6), in(7));
+        carrySaveAdd(foursB, twos, twos, twosA, twosB);
+        carrySaveAdd(eightsA, fours, fours, foursA, foursB);
+        carrySaveAdd(twosA, ones, ones, in(8), in(9));
+        carrySaveAdd(twosB, ones, ones, in(10), in(11));
+        carrySaveAdd(foursA, twos, twos, twosA, twosB);
+        carrySaveAdd(twosA, ones, ones, in(12), in(13));
+        carrySaveAdd(twosB, ones, ones, in(14), in(15));
+        carrySaveAdd(foursB, twos, twos, twosA, twosB);
+        carrySaveAdd(eightsB, fours, fours, foursA, foursB);
+        carrySaveAdd(sixteens, eights, eights, eightsA, eightsB);
+        addPositionalBits<Uint>(sixteens, 1, sixteensCounts);
+    }
+
+    for (std::size_t b = 0; b < bits_v<Uint>; ++b) {
+        counts[b] = 16 * sixteensCounts[b];
+    }
+    addPositionalBits<Uint>(eights, 8, counts);
+    addPositionalBits<Uint>(fours, 4, counts);
+    addPositionalBits<Uint>(twos, 2, counts);
+    addPositionalBits<Uint>(ones, 1, counts);
+    for (; i < count; ++i) {
+        addPositionalBits<Uint>(input[i], 1, counts);
+    }
+}
+
+#ifdef BITMANIP_HAS_SIMD_POPCOUNT
+/*
+ * The SIMD implementations treat the words as bytes, where bit j of byte k is bit position k % sizeof(Uint) * 8 + j
+ * on a little-endian CPU.
+ * The bits of the sixteens vector are accumulated in eight vectors of byte counters, one for each bit j.
+ * Each block of 16 vectors adds at most one to each byte counter, so they are flushed every 255 blocks.
+ */
+
+/// Adds weight times the byte counters of bit j to the counts of their bit positions.
+template <typename Uint>
+inline void addPositionalBytes(const std::uint8_t bytes[],
+                               std::size_t size,
+                               unsigned j,
+                               std::uint64_t weight,
+                               std::uint64_t counts[]) noexcept
+{
+    for (std::size_t k = 0; k < size; ++k) {
+        counts[k % sizeof(Uint) * 8 + j] += bytes[k] * weight;
+    }
+}
+
+/// Adds weight to the count of every bit position where the bytes have a one-bit.
+template <typename Uint>
+inline void addPositionalBitsOfBytes(const std::uint8_t bytes[],
+                                     std::size_t size,
+                                     std::uint64_t weight,
+                                     std::uint64_t counts[]) noexcept
+{
+    for (std::size_t k = 0; k < size; ++k) {
+        for (unsigned j = 0; j < 8; ++j) {
+            counts[k % sizeof(Uint) * 8 + j] += ((bytes[k] >> j) & 1u) * weight;
+        }
+    }
+}
+
+template <std::size_t... J>
+BITMANIP_TARGET("avx2")
+inline void accumulateBitPlanes_avx2(__m256i acc[8], __m256i x, std::index_sequence<J...>) noexcept
+{
+    const __m256i one = _mm256_set1_epi8(1);
+    ((acc[J] = _mm256_add_epi8(acc[J], _mm256_and_si256(_mm256_srli_epi16(x, J), one))), ...);
+}
+
+template <typename Uint>
+BITMANIP_TARGET("avx2")
+inline void flushBitPlanes_avx2(__m256i acc[8], std::uint64_t counts[]) noexcept
+{
+    alignas(32) std::uint8_t bytes[32];
+    for (unsigned j = 0; j < 8; ++j) {
+        _mm256_store_si256(reinterpret_cast<__m256i *>(bytes), acc[j]);
+        addPositionalBytes<Uint>(bytes, 32, j, 16, counts);
+        acc[j] = _mm256_setzero_si256();
+    }
+}
+
+template <typename Uint>
+BITMANIP_TARGET("avx2")
+inline void addPositionalBits_avx2(__m256i x, std::uint64_t weight, std::uint64_t counts[]) noexcept
+{
+    alignas(32) std::uint8_t bytes[32];
+    _mm256_store_si256(reinterpret_cast<__m256i *>(bytes), x);
+    addPositionalBitsOfBytes<Uint>(bytes, 32, weight, counts);
+}
+
+/**
+ * @brief Adds the positional counts of the words in whole blocks of 16 vectors to counts.
+ * @return the number of words which have been processed
+ */
+template <typename Uint>
+BITMANIP_TARGET("avx2")
+inline std::size_t positionalPopCount_avx2(const Uint input[], std::size_t count, std::uint64_t counts[]) noexcept
+{
+    constexpr std::size_t wordsPerBlock = 16 * 32 / sizeof(Uint);
+    const std::size_t blockCount = count / wordsPerBlock;
+    const auto *const in = reinterpret_cast<const __m256i *>(input);
+
+    __m256i ones = _mm256_setzero_si256(), twos = ones, fours = ones, eights = ones;
+    __m256i twosA, twosB, foursA, foursB, eightsA, eightsB, sixteens;
+    __m256i acc[8]{};
+
+    for (std::size_t block = 0; block < blockCount; ++block) {
+        const __m256i *const p = in + block * 16;
+        carrySaveAdd_avx2(twosA, ones, ones, _mm256_loadu_si256(p + 0), _mm256_loadu_si256(p + 1));
+        carrySaveAdd_avx2(twosB, ones, ones, _mm256_loadu_si256(p + 2), _mm256_loadu_si256(p + 3));
+        carrySaveAdd_avx2(foursA, twos, twos, twosA, twosB);
+        carrySaveAdd_avx2(twosA, ones, ones, _mm256_loadu_si256(p + 4), _mm256_loadu_si256(p + 5));
+        carrySaveAdd_avx2(twosB, ones, ones, _mm256_loadu_si256(p + 6), _mm256_loadu_si256(p + 7));
+        carrySaveAdd_avx2(foursB, twos, twos, twosA, twosB);
+        carrySaveAdd_avx2(eightsA, fours, fours, foursA, foursB);
+        carrySaveAdd_avx2(twosA, ones, ones, _mm256_loadu_si256(p + 8), _mm256_loadu_si256(p + 9));
+        carrySaveAdd_avx2(twosB, ones, ones, _mm256_loadu_si256(p + 10), _mm256_loadu_si256(p + 11));
+        carrySaveAdd_avx2(foursA, twos, twos, twosA, twosB);
+        carrySaveAdd_avx2(twosA, ones, ones, _mm256_loadu_si256(p + 12), _mm256_loadu_si256(p + 13));
+        carrySaveAdd_avx2(twosB, ones, ones, _mm256_loadu_si256(p + 14), _mm256_loadu_si256(p + 15));
+        carrySaveAdd_avx2(foursB, twos, twos, twosA, twosB);
+        carrySaveAdd_avx2(eightsB, fours, fours, foursA, foursB);
+        carrySaveAdd_avx2(sixteens, eights, eights, eightsA, eightsB);
+        accumulateBitPlanes_avx2(acc, sixteens, std::make_index_sequence<8>{});
+        if (block % 255 == 254) {
+            flushBitPlanes_avx2<Uint>(acc, counts);
+        }
+    }
+
+    flushBitPlanes_avx2<Uint>(acc, counts);
+    addPositionalBits_avx2<Uint>(eights, 8, counts);
+    addPositionalBits_avx2<Uint>(fours, 4, counts);
+    addPositionalBits_avx2<Uint>(twos, 2, counts);
+    addPositionalBits_avx2<Uint>(ones, 1, counts);
+    return blockCount * wordsPerBlock;
+}
+
+BITMANIP_TARGET("avx512f,avx512bw")
+inline void carrySaveAdd_avx512(__m512i &high, __m512i &low, __m512i a, __m512i b, __m512i c) noexcept
+{
+    // 0xe8 is the truth table of the majority of a, b and c, 0x96 the one of a ^ b ^ c
+    high = _mm512_ternarylogic_epi64(a, b, c, 0xe8);
+    low = _mm512_ternarylogic_epi64(a, b, c, 0x96);
+}
+
+template <std::size_t... J>
+BITMANIP_TARGET("avx512f,avx512bw")
+inline void accumulateBitPlanes_avx512(__m512i acc[8], __m512i x, std::index_sequence<J...>) noexcept
+{
+    const __m512i one = _mm512_set1_epi8(1);
+    ((acc[J] = _mm512_add_epi8(acc[J], _mm512_and_si512(_mm512_srli_epi16(x, J), one))), ...);
+}
+
+template <typename Uint>
+BITMANIP_TARGET("avx512f,avx512bw")
+inline void flushBitPlanes_avx512(__m512i acc[8], std::uint64_t counts[]) noexcept
+{
+    alignas(64) std::uint8_t bytes[64];
+    for (unsigned j = 0; j < 8; ++j) {
+        _mm512_store_si512(bytes, acc[j]);
+        addPositionalBytes<Uint>(bytes, 64, j, 16, counts);
+        acc[j] = _mm512_setzero_si512();
+    }
+}
+
+template <typename Uint>
+BITMANIP_TARGET("avx512f,avx512bw")
+inline void addPositionalBits_avx512(__m512i x, std::uint64_t weight, std::uint64_t counts[]) noexcept
+{
+    alignas(64) std::uint8_t bytes[64];
+    _mm512_store_si512(bytes, x);
+    addPositionalBitsOfBytes<Uint>(bytes, 64, weight, counts);
+}
+
+/// Like positionalPopCount_avx2(), but with vectors of 64 bytes.
+template <typename Uint>
+BITMANIP_TARGET("avx512f,avx512bw")
+inline std::size_t positionalPopCount_avx512(const Uint input[], std::size_t count, std::uint64_t counts[]) noexcept
+{
+    constexpr std::size_t wordsPerBlock = 16 * 64 / sizeof(Uint);
+    const std::size_t blockCount = count / wordsPerBlock;
+    const auto *const in = reinterpret_cast<const __m512i *>(input);
+
+    __m512i ones = _mm512_setzero_si512(), twos = ones, fours = ones, eights = ones;
+    __m512i twosA, twosB, foursA, foursB, eightsA, eightsB, sixteens;
+    __m512i acc[8]{};
+
+    for (std::size_t block = 0; block < blockCount; ++block) {
+        const __m512i *const p = in + block * 16;
+        carrySaveAdd_avx512(twosA, ones, ones, _mm512_loadu_si512(p + 0), _mm512_loadu_si512(p + 1));
+        carrySaveAdd_avx512(twosB, ones, ones, _mm512_loadu_si512(p + 2), _mm512_loadu_si512(p + 3));
+        carrySaveAdd_avx512(foursA, twos, twos, twosA, twosB);
+        carrySaveAdd_avx512(twosA, ones, ones, _mm512_loadu_si512(p + 4), _mm512_loadu_si512(p + 5));
+        carrySaveAdd_avx512(twosB, ones, ones, _mm512_loadu_si512(p + 6), _mm512_loadu_si512(p + 7));
+        carrySaveAdd_avx512(foursB, twos, twos, twosA, twosB);
+        carrySaveAdd_avx512(eightsA, fours, fours, foursA, foursB);
+        carrySaveAdd_avx512(twosA, ones, ones, _mm512_loadu_si512(p + 8), _mm512_loadu_si512(p + 9));
+        carrySaveAdd_avx512(twosB, ones, ones, _mm512_loadu_si512(p + 10), _mm512_loadu_si512(p + 11));
+        carrySaveAdd_avx512(foursA, twos, twos, twosA, twosB);
+        carrySaveAdd_avx512(twosA, ones, ones, _mm512_loadu_si512(p + 12), _mm512_loadu_si512(p + 13));
+        carrySaveAdd_avx512(twosB, ones, ones, _mm512_loadu_si512(p + 14), _mm512_loadu_si512(p + 15));
+        carrySaveAdd_avx512(foursB, twos, twos, twosA, twosB);
+        carrySaveAdd_avx512(eightsB, fours, fours, foursA, foursB);
+        carrySaveAdd_avx512(sixteens, eights, eights, eightsA, eightsB);
+        accumulateBitPlanes_avx512(acc, sixteens, std::make_index_sequence<8>{});
+        if (block % 255 == 254) {
+            flushBitPlanes_avx512<Uint>(acc, counts);
+        }
+    }
+
+    flushBitPlanes_avx512<Uint>(acc, counts);
+    addPositionalBits_avx512<Uint>(eights, 8, counts);
+    addPositionalBits_avx512<Uint>(fours, 4, counts);
+    addPositionalBits_avx512<Uint>(twos, 2, counts);
+    addPositionalBits_avx512<Uint>(ones, 1, counts);
+    return blockCount * wordsPerBlock;
+}
+#endif
+
+}  // namespace detail
+
+/**
+ * @brief Counts, for every bit position, how many words have a one-bit at that position.
+ * This is equivalent to counts[b] = the sum of (input[i] >> b) & 1 for every i < count, for every b < bits_v<Uint>.
+ *
+ * Carry-save adders reduce blocks of 16 words to a single word of which the bit positions are counted.
+ * With AVX-512 or AVX2, the blocks consist of 16 vectors instead, chosen at runtime.
+ * @param input the words
+ * @param count the number of words
+ * @param counts receives the count of each bit position; previous contents are replaced
+ */
+template <BITMANIP_UNSIGNED_TYPENAME(Uint)>
+constexpr void positionalPopCount(const Uint input[], std::size_t count, std::uint64_t counts[bits_v<Uint>]) noexcept
+{
+    static_assert(sizeof(Uint) <= sizeof(std::uint64_t), "Words may have at most 64 bits");
+#ifdef BITMANIP_HAS_SIMD_POPCOUNT
+    if (not builtin::isconsteval() && (CPU_FEATURES.avx512bw || CPU_FEATURES.avx2)) {
+        std::uint64_t simdCounts[bits_v<Uint>]{};
+        const std::size_t done = CPU_FEATURES.avx512bw ? detail::positionalPopCount_avx512(input, count, simdCounts)
+                                                       : detail::positionalPopCount_avx2(input, count, simdCounts);
+        detail::positionalPopCount_harleySeal(input + done, count - done, counts);
+        for (std::size_t b = 0; b < bits_v<Uint>; ++b) {
+            counts[b] += simdCounts[b];
+        }
+        return;
+    }
+#endif
+    detail::positionalPopCount_harleySeal(input, count, counts);
+}
+
 }  // namespace bitmanip
 
 #endif
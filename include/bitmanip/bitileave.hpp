@@ -9,6 +9,8 @@
  */
 
 #include "bit.hpp"
+#include "builtin.hpp"
+#include "cpu.hpp"
 #include "intdiv.hpp"
 #include "intlog.hpp"
 
@@ -66,6 +68,21 @@ namespace detail {
     return result;
 }
 
+/**
+ * @brief Masks which are used by the shift-based zero-interleaving and de-interleaving cascades.
+ * MASKS[i] contains groups of 2^i one-bits which are separated by 2^i * BITS zero-bits.
+ * Both the scalar and the vectorized cascades share these tables.
+ */
+template <unsigned BITS>
+inline constexpr std::uint64_t ILEAVE_ZEROS_MASKS[6] = {
+    detail::duplBits_naive(detail::ileaveZeros_naive(~std::uint32_t(0), BITS), 1),
+    detail::duplBits_naive(detail::ileaveZeros_naive(~std::uint32_t(0), BITS), 2),
+    detail::duplBits_naive(detail::ileaveZeros_naive(~std::uint32_t(0), BITS), 4),
+    detail::duplBits_naive(detail::ileaveZeros_naive(~std::uint32_t(0), BITS), 8),
+    detail::duplBits_naive(detail::ileaveZeros_naive(~std::uint32_t(0), BITS), 16),
+    detail::duplBits_naive(detail::ileaveZeros_naive(~std::uint32_t(0), BITS), 32),
+};
+
 template <unsigned BITS>
 [[nodiscard]] constexpr std::uint64_t ileaveZeros_shift(std::uint32_t input) noexcept
 {
@@ -73,13 +90,7 @@ template <unsigned BITS>
         return input;
     }
     else {
-        constexpr std::uint64_t MASKS[] = {
-            detail::duplBits_naive(detail::ileaveZeros_naive(~std::uint32_t(0), BITS), 1),
-            detail::duplBits_naive(detail::ileaveZeros_naive(~std::uint32_t(0), BITS), 2),
-            detail::duplBits_naive(detail::ileaveZeros_naive(~std::uint32_t(0), BITS), 4),
-            detail::duplBits_naive(detail::ileaveZeros_naive(~std::uint32_t(0), BITS), 8),
-            detail::duplBits_naive(detail::ileaveZeros_naive(~std::uint32_t(0), BITS), 16),
-        };
+        constexpr auto &MASKS = detail::ILEAVE_ZEROS_MASKS<BITS>;
         // log2_floor(0) == 0 so this is always safe, even for 1 bit
         constexpr int start = 4 - static_cast<int>(bitmanip::log2floor(BITS >> 1));
 
@@ -94,13 +105,46 @@ template <unsigned BITS>
     }
 }
 
+template <unsigned BITS>
+[[nodiscard]] constexpr Table<std::uint64_t, 256> makeIleaveZerosLut() noexcept
+{
+    Table<std::uint64_t, 256> result{};
+    for (std::uint32_t i = 0; i < 256; ++i) {
+        result[i] = detail::ileaveZeros_naive(i, BITS);
+    }
+    return result;
+}
+
+/// Maps each byte to the byte interleaved with BITS zero-bits.
+template <unsigned BITS>
+inline constexpr Table<std::uint64_t, 256> ILEAVE_ZEROS_LUT = detail::makeIleaveZerosLut<BITS>();
+
+// the lookups are unrolled using a fold expression because the variable shifts of a loop are considerably slower
+template <unsigned BITS, std::size_t... I>
+[[nodiscard]] constexpr std::uint64_t ileaveZeros_lut_impl(std::index_sequence<I...>, std::uint32_t input) noexcept
+{
+    constexpr unsigned outputBitsPerByte = 8 * (BITS + 1);
+    return ((ILEAVE_ZEROS_LUT<BITS>[(input >> (I * 8)) & 0xff] << (I * outputBitsPerByte)) | ...);
+}
+
+template <unsigned BITS>
+[[nodiscard]] constexpr std::uint64_t ileaveZeros_lut(std::uint32_t input) noexcept
+{
+    static_assert(BITS != 0 && BITS < 8, "Tables are only provided for interleaving 2 to 8 numbers");
+    // bytes which would be shifted out of the 64-bit result entirely are skipped
+    constexpr std::size_t lookups = std::min<std::size_t>(4, 1 + 63 / (8 * (BITS + 1)));
+
+    return detail::ileaveZeros_lut_impl<BITS>(std::make_index_sequence<lookups>{}, input);
+}
+
 #ifdef BITMANIP_HAS_BUILTIN_PDEP
 #define BITMANIP_HAS_BUILTIN_ILEAVE_ZEROS
+// must only be called if CPU_FEATURES.bmi2 is set
 template <unsigned BITS, unsigned SHIFT = 0>
-[[nodiscard]] inline std::uint64_t ileaveZeros_builtin(std::uint32_t input) noexcept
+[[nodiscard]] BITMANIP_TARGET("bmi2") inline std::uint64_t ileaveZeros_builtin(std::uint32_t input) noexcept
 {
     constexpr std::uint64_t mask = detail::ileaveZeros_naive(~std::uint32_t(0), BITS) << SHIFT;
-    return builtin::depositBits(std::uint64_t{input}, mask);
+    return builtin::pdep(std::uint64_t{input}, mask);
 }
 #endif
 
@@ -110,6 +154,8 @@ template <unsigned BITS, unsigned SHIFT = 0>
  * @brief Interleaves BITS zero-bits inbetween each input bit and optionally leftshifts the result by SHIFT bits.
  *
  * SHIFT is an additional parameter because left-shifting is a no-op when the builtin implementation is available.
+ * The builtin pdep implementation is chosen at runtime, only if the CPU implements pdep in hardware.
+ * Otherwise, a lookup table is used for 3 to 8 interleaved numbers and a shift cascade for everything else.
  * @param input the input number
  * @tparam BITS the number of bits to be interleaved or zero for an identity mapping
  * @tparam SHIFT the number of bits to left-shift the input by after interleaving zeros
@@ -118,11 +164,17 @@ template <unsigned BITS, unsigned SHIFT = 0>
 template <unsigned BITS, unsigned SHIFT = 0>
 [[nodiscard]] constexpr std::uint64_t ileaveZeros_const(std::uint32_t input) noexcept
 {
+    if (not builtin::isconsteval()) {
 #ifdef BITMANIP_HAS_BUILTIN_ILEAVE_ZEROS
-    if (not isConstantEvaluated()) {
-        return detail::ileaveZeros_builtin<BITS, SHIFT>(input);
-    }
+        if (CPU_FEATURES.fastPdep) {
+            return detail::ileaveZeros_builtin<BITS, SHIFT>(input);
+        }
 #endif
+        // for BITS == 1, the table lookups are slower than the shift cascade
+        if constexpr (BITS >= 2 && BITS < 8) {
+            return detail::ileaveZeros_lut<BITS>(input) << SHIFT;
+        }
+    }
     return detail::ileaveZeros_shift<BITS>(input) << SHIFT;
 }
 
@@ -159,14 +211,7 @@ template <unsigned BITS>
         return input;
     }
     else {
-        constexpr std::uint64_t MASKS[] = {
-            detail::duplBits_naive(detail::ileaveZeros_naive(~std::uint32_t(0), BITS), 1),
-            detail::duplBits_naive(detail::ileaveZeros_naive(~std::uint32_t(0), BITS), 2),
-            detail::duplBits_naive(detail::ileaveZeros_naive(~std::uint32_t(0), BITS), 4),
-            detail::duplBits_naive(detail::ileaveZeros_naive(~std::uint32_t(0), BITS), 8),
-            detail::duplBits_naive(detail::ileaveZeros_naive(~std::uint32_t(0), BITS), 16),
-            detail::duplBits_naive(detail::ileaveZeros_naive(~std::uint32_t(0), BITS), 32),
-        };
+        constexpr auto &MASKS = detail::ILEAVE_ZEROS_MASKS<BITS>;
         // log2_floor(0) == 0 so this is always safe, even for 1 bit
         constexpr std::size_t iterations = 5 - bitmanip::log2floor(BITS >> 1);
 
@@ -182,13 +227,54 @@ template <unsigned BITS>
     }
 }
 
+/// The number of interleaved input bits which are used as an index into REM_ILEAVED_BITS_LUT.
+template <unsigned BITS>
+inline constexpr unsigned REM_ILEAVED_BITS_LUT_INDEX_BITS = 9 / (BITS + 1) * (BITS + 1);
+
+template <unsigned BITS>
+[[nodiscard]] constexpr auto makeRemIleavedBitsLut() noexcept
+{
+    constexpr std::size_t size = std::size_t{1} << REM_ILEAVED_BITS_LUT_INDEX_BITS<BITS>;
+
+    Table<std::uint8_t, size> result{};
+    for (std::size_t i = 0; i < size; ++i) {
+        result[i] = static_cast<std::uint8_t>(detail::remIleavedBits_naive(i, BITS));
+    }
+    return result;
+}
+
+/// Maps up to 9 interleaved bits to the bits which remain after removing BITS bits inbetween.
+template <unsigned BITS>
+inline constexpr auto REM_ILEAVED_BITS_LUT = detail::makeRemIleavedBitsLut<BITS>();
+
+template <unsigned BITS, std::size_t... I>
+[[nodiscard]] constexpr std::uint64_t remIleavedBits_lut_impl(std::index_sequence<I...>, std::uint64_t input) noexcept
+{
+    constexpr unsigned inputBits = REM_ILEAVED_BITS_LUT_INDEX_BITS<BITS>;
+    constexpr unsigned outputBits = inputBits / (BITS + 1);
+    constexpr std::uint64_t indexMask = (std::uint64_t{1} << inputBits) - 1;
+
+    return ((std::uint64_t{REM_ILEAVED_BITS_LUT<BITS>[(input >> (I * inputBits)) & indexMask]} << (I * outputBits)) |
+            ...);
+}
+
+template <unsigned BITS>
+[[nodiscard]] constexpr std::uint64_t remIleavedBits_lut(std::uint64_t input) noexcept
+{
+    static_assert(BITS != 0 && BITS < 8, "Tables are only provided for de-interleaving 2 to 8 numbers");
+    constexpr std::size_t lookups = 1 + 63 / REM_ILEAVED_BITS_LUT_INDEX_BITS<BITS>;
+
+    return detail::remIleavedBits_lut_impl<BITS>(std::make_index_sequence<lookups>{}, input);
+}
+
 #ifdef BITMANIP_HAS_BUILTIN_PEXT
 #define BITMANIP_HAS_BUILTIN_REM_ILEAVED_BITS
-template <unsigned BITS, unsigned SHIFT>
-inline std::uint64_t remIleavedBits_builtin(std::uint64_t input) noexcept
+// must only be called if CPU_FEATURES.bmi2 is set
+template <unsigned BITS, unsigned SHIFT = 0>
+[[nodiscard]] BITMANIP_TARGET("bmi2") inline std::uint64_t remIleavedBits_builtin(std::uint64_t input) noexcept
 {
     constexpr std::uint64_t mask = detail::ileaveZeros_naive(~std::uint32_t(0), BITS) << SHIFT;
-    return builtin::extractBits(std::uint64_t{input}, mask);
+    return builtin::pext(std::uint64_t{input}, mask);
 }
 #endif
 
@@ -197,6 +283,7 @@ inline std::uint64_t remIleavedBits_builtin(std::uint64_t input) noexcept
 /**
  * @brief Removes each interleaved <BITS> bits. Example: 0b010101 --rem 1--> 0b111
  * If BITS is zero, no bits are removed and the input is returned.
+ * The builtin pext implementation is chosen at runtime, only if the CPU implements pext in hardware.
  * @param input the input number
  * @param bits input bits per output bit
  * @return the the output with removed bits
@@ -205,7 +292,7 @@ template <unsigned BITS, unsigned SHIFT = 0>
 [[nodiscard]] constexpr std::uint64_t remIleavedBits_const(std::uint64_t input) noexcept
 {
 #ifdef BITMANIP_HAS_BUILTIN_REM_ILEAVED_BITS
-    if (not isConstantEvaluated()) {
+    if (not builtin::isconsteval() && CPU_FEATURES.fastPdep) {
         return detail::remIleavedBits_builtin<BITS, SHIFT>(input);
     }
 #endif
@@ -239,7 +326,7 @@ template <typename... Uint, std::size_t... I>
 }
 
 template <typename Uint, std::size_t... I>
-[[nodiscard]] constexpr auto ileave_arr_impl(std::index_sequence<I...>, Uint args[]) noexcept -> ull_type
+[[nodiscard]] constexpr auto ileave_arr_impl(std::index_sequence<I...>, const Uint args[]) noexcept -> ull_type
 {
     constexpr std::size_t max = sizeof...(I) - 1;
     return (ileaveZeros_const<max, max - I>(args[I]) | ...);
@@ -275,6 +362,306 @@ template <typename Uint, std::size_t N>
     return detail::ileave_arr_impl(std::make_index_sequence<N>{}, out);
 }
 
+// BATCH INTERLEAVING ==================================================================================================
+
+namespace detail {
+
+template <std::size_t DIMS, typename Uint>
+constexpr void ileaveBatch_soa_naive(const Uint *const inputs[],
+                                     ull_type out[],
+                                     std::size_t i,
+                                     std::size_t count) noexcept
+{
+    for (; i < count; ++i) {
+        Uint point[DIMS]{};
+        for (std::size_t d = 0; d < DIMS; ++d) {
+            point[d] = inputs[d][i];
+        }
+        out[i] = detail::ileave_arr_impl(std::make_index_sequence<DIMS>{}, point);
+    }
+}
+
+template <std::size_t DIMS, typename Uint>
+constexpr void ileaveBatch_aos_naive(const Uint points[], ull_type out[], std::size_t i, std::size_t count) noexcept
+{
+    for (; i < count; ++i) {
+        out[i] = detail::ileave_arr_impl(std::make_index_sequence<DIMS>{}, points + i * DIMS);
+    }
+}
+
+#if defined(BITMANIP_X64) && (defined(BITMANIP_MSVC) || defined(BITMANIP_GNU_OR_CLANG))
+// AVX2 and AVX-512 are detected at runtime
+#define BITMANIP_HAS_SIMD_ILEAVE_BATCH
+
+/// Vectorized ileaveZeros_shift which processes four 64-bit lanes at once.
+template <unsigned BITS>
+BITMANIP_TARGET("avx2")
+[[nodiscard]] inline __m256i ileaveZeros_avx2(__m256i n) noexcept
+{
+    if constexpr (BITS != 0) {
+        constexpr int start = 4 - static_cast<int>(bitmanip::log2floor(BITS >> 1));
+
+        for (int i = start; i != -1; --i) {
+            const __m128i shift = _mm_cvtsi32_si128(static_cast<int>(BITS * (1u << i)));
+            const __m256i mask = _mm256_set1_epi64x(static_cast<long long>(ILEAVE_ZEROS_MASKS<BITS>[i]));
+            n = _mm256_and_si256(_mm256_or_si256(n, _mm256_sll_epi64(n, shift)), mask);
+        }
+    }
+    return n;
+}
+
+/// Interleaves the zero-extended coordinates of dimension d of four points into the result.
+template <std::size_t DIMS>
+BITMANIP_TARGET("avx2")
+[[nodiscard]] inline __m256i ileaveLane_avx2(__m256i result, __m256i coordinates, unsigned d) noexcept
+{
+    constexpr unsigned max = DIMS - 1;
+    const __m256i ileaved = ileaveZeros_avx2<max>(coordinates);
+    return _mm256_or_si256(result, _mm256_sll_epi64(ileaved, _mm_cvtsi32_si128(static_cast<int>(max - d))));
+}
+
+/// Interleaves four points at a time and returns the number of points which have been processed.
+template <std::size_t DIMS>
+BITMANIP_TARGET("avx2")
+[[nodiscard]] inline std::size_t ileaveBatch_soa_avx2(const std::uint32_t *const inputs[],
+                                                      ull_type out[],
+                                                      std::size_t count) noexcept
+{
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256i result = _mm256_setzero_si256();
+        for (unsigned d = 0; d < DIMS; ++d) {
+            const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(inputs[d] + i));
+            result = ileaveLane_avx2<DIMS>(result, _mm256_cvtepu32_epi64(x), d);
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), result);
+    }
+    return i;
+}
+
+/// Interleaves four points at a time, whose coordinates are gathered, see ileaveBatch_soa_avx2().
+template <std::size_t DIMS>
+BITMANIP_TARGET("avx2")
+[[nodiscard]] inline std::size_t ileaveBatch_aos_avx2(const std::uint32_t points[],
+                                                      ull_type out[],
+                                                      std::size_t count) noexcept
+{
+    constexpr int stride = static_cast<int>(DIMS);
+    const int *base = reinterpret_cast<const int *>(points);
+    const __m128i index = _mm_setr_epi32(0, stride, 2 * stride, 3 * stride);
+
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256i result = _mm256_setzero_si256();
+        for (unsigned d = 0; d < DIMS; ++d) {
+            const __m128i x = _mm_i32gather_epi32(base + i * DIMS + d, index, 4);
+            result = ileaveLane_avx2<DIMS>(result, _mm256_cvtepu32_epi64(x), d);
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), result);
+    }
+    return i;
+}
+
+/// Vectorized ileaveZeros_shift which processes eight 64-bit lanes at once.
+template <unsigned BITS>
+BITMANIP_TARGET("avx512f")
+[[nodiscard]] inline __m512i ileaveZeros_avx512(__m512i n) noexcept
+{
+    if constexpr (BITS != 0) {
+        constexpr int start = 4 - static_cast<int>(bitmanip::log2floor(BITS >> 1));
+
+        for (int i = start; i != -1; --i) {
+            const __m128i shift = _mm_cvtsi32_si128(static_cast<int>(BITS * (1u << i)));
+            const __m512i mask = _mm512_set1_epi64(static_cast<long long>(ILEAVE_ZEROS_MASKS<BITS>[i]));
+            // _mm512_sll_epi64 triggers -Wuninitialized in the headers of GCC 12
+            n = _mm512_and_si512(_mm512_or_si512(n, _mm512_maskz_sll_epi64(0xff, n, shift)), mask);
+        }
+    }
+    return n;
+}
+
+/// Interleaves the zero-extended coordinates of dimension d of eight points into the result.
+template <std::size_t DIMS>
+BITMANIP_TARGET("avx512f")
+[[nodiscard]] inline __m512i ileaveLane_avx512(__m512i result, __m512i coordinates, unsigned d) noexcept
+{
+    constexpr unsigned max = DIMS - 1;
+    const __m512i ileaved = ileaveZeros_avx512<max>(coordinates);
+    // _mm512_sll_epi64 triggers -Wuninitialized in the headers of GCC 12
+    const __m128i shift = _mm_cvtsi32_si128(static_cast<int>(max - d));
+    return _mm512_or_si512(result, _mm512_maskz_sll_epi64(0xff, ileaved, shift));
+}
+
+/// Interleaves eight points at a time and returns the number of points which have been processed.
+template <std::size_t DIMS>
+BITMANIP_TARGET("avx512f")
+[[nodiscard]] inline std::size_t ileaveBatch_soa_avx512(const std::uint32_t *const inputs[],
+                                                        ull_type out[],
+                                                        std::size_t count) noexcept
+{
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m512i result = _mm512_setzero_si512();
+        for (unsigned d = 0; d < DIMS; ++d) {
+            const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(inputs[d] + i));
+            // _mm512_cvtepu32_epi64 triggers -Wuninitialized in the headers of GCC 12
+            result = ileaveLane_avx512<DIMS>(result, _mm512_maskz_cvtepu32_epi64(0xff, x), d);
+        }
+        _mm512_storeu_si512(out + i, result);
+    }
+    return i;
+}
+
+/// Interleaves eight points at a time, whose coordinates are gathered, see ileaveBatch_soa_avx512().
+template <std::size_t DIMS>
+BITMANIP_TARGET("avx512f")
+[[nodiscard]] inline std::size_t ileaveBatch_aos_avx512(const std::uint32_t points[],
+                                                        ull_type out[],
+                                                        std::size_t count) noexcept
+{
+    constexpr int stride = static_cast<int>(DIMS);
+    const int *base = reinterpret_cast<const int *>(points);
+    const __m256i index =
+        _mm256_setr_epi32(0, stride, 2 * stride, 3 * stride, 4 * stride, 5 * stride, 6 * stride, 7 * stride);
+
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m512i result = _mm512_setzero_si512();
+        for (unsigned d = 0; d < DIMS; ++d) {
+            const __m256i x = _mm256_i32gather_epi32(base + i * DIMS + d, index, 4);
+            // _mm512_cvtepu32_epi64 triggers -Wuninitialized in the headers of GCC 12
+            result = ileaveLane_avx512<DIMS>(result, _mm512_maskz_cvtepu32_epi64(0xff, x), d);
+        }
+        _mm512_storeu_si512(out + i, result);
+    }
+    return i;
+}
+
+/// Interleaves as many points as possible using the widest available vectors and returns their number.
+template <std::size_t DIMS>
+[[nodiscard]] inline std::size_t ileaveBatch_soa_simd(const std::uint32_t *const inputs[],
+                                                      ull_type out[],
+                                                      std::size_t count) noexcept
+{
+    if (CPU_FEATURES.avx512f) {
+        return detail::ileaveBatch_soa_avx512<DIMS>(inputs, out, count);
+    }
+    if (CPU_FEATURES.avx2) {
+        return detail::ileaveBatch_soa_avx2<DIMS>(inputs, out, count);
+    }
+    return 0;
+}
+
+template <std::size_t DIMS>
+[[nodiscard]] inline std::size_t ileaveBatch_aos_simd(const std::uint32_t points[],
+                                                      ull_type out[],
+                                                      std::size_t count) noexcept
+{
+    if (CPU_FEATURES.avx512f) {
+        return detail::ileaveBatch_aos_avx512<DIMS>(points, out, count);
+    }
+    if (CPU_FEATURES.avx2) {
+        return detail::ileaveBatch_aos_avx2<DIMS>(points, out, count);
+    }
+    return 0;
+}
+#endif
+
+template <std::size_t DIMS, typename Uint>
+constexpr void ileaveBatch_soa(const Uint *const inputs[], ull_type out[], std::size_t count) noexcept
+{
+    static_assert(DIMS != 0 && DIMS <= 8, "Between one and eight coordinates can be interleaved");
+
+    std::size_t i = 0;
+#ifdef BITMANIP_HAS_SIMD_ILEAVE_BATCH
+    if constexpr (std::is_same_v<Uint, std::uint32_t>) {
+        if (not builtin::isconsteval()) {
+            i = detail::ileaveBatch_soa_simd<DIMS>(inputs, out, count);
+        }
+    }
+#endif
+    detail::ileaveBatch_soa_naive<DIMS>(inputs, out, i, count);
+}
+
+template <std::size_t DIMS, typename Uint>
+constexpr void ileaveBatch_aos(const Uint points[], ull_type out[], std::size_t count) noexcept
+{
+    static_assert(DIMS != 0 && DIMS <= 8, "Between one and eight coordinates can be interleaved");
+
+    std::size_t i = 0;
+#ifdef BITMANIP_HAS_SIMD_ILEAVE_BATCH
+    if constexpr (std::is_same_v<Uint, std::uint32_t>) {
+        if (not builtin::isconsteval()) {
+            i = detail::ileaveBatch_aos_simd<DIMS>(points, out, count);
+        }
+    }
+#endif
+    detail::ileaveBatch_aos_naive<DIMS>(points, out, i, count);
+}
+
+}  // namespace detail
+
+/**
+ * @brief Interleaves count pairs of integers which are stored as a structure of arrays.
+ * This is equivalent to out[i] = ileave(x[i], y[i]) for every i < count.
+ *
+ * For std::uint32_t inputs, multiple points are interleaved at once using AVX2 or AVX-512, if available.
+ * Otherwise, every point is interleaved using ileave().
+ *
+ * @param x the highest bits
+ * @param y the lowest bits
+ * @param out the output Morton codes
+ * @param count the number of points
+ */
+template <typename Uint>
+constexpr auto ileaveBatch(const Uint x[], const Uint y[], unsigned long long out[], std::size_t count) noexcept
+    -> std::enable_if_t<areUnsigned<Uint>, void>
+{
+    const Uint *const inputs[]{x, y};
+    detail::ileaveBatch_soa<2>(inputs, out, count);
+}
+
+/**
+ * @brief Interleaves count triples of integers which are stored as a structure of arrays.
+ * This is equivalent to out[i] = ileave(x[i], y[i], z[i]) for every i < count.
+ *
+ * For std::uint32_t inputs, multiple points are interleaved at once using AVX2 or AVX-512, if available.
+ * Otherwise, every point is interleaved using ileave().
+ *
+ * @param x the highest bits
+ * @param y the middle bits
+ * @param z the lowest bits
+ * @param out the output Morton codes
+ * @param count the number of points
+ */
+template <typename Uint>
+constexpr auto ileaveBatch(
+    const Uint x[], const Uint y[], const Uint z[], unsigned long long out[], std::size_t count) noexcept
+    -> std::enable_if_t<areUnsigned<Uint>, void>
+{
+    const Uint *const inputs[]{x, y, z};
+    detail::ileaveBatch_soa<3>(inputs, out, count);
+}
+
+/**
+ * @brief Interleaves count points of DIMS integers each which are stored as an array of structures.
+ * This is equivalent to out[i] = ileave<DIMS>(points + i * DIMS) for every i < count.
+ *
+ * For std::uint32_t inputs, multiple points are interleaved at once using AVX2 or AVX-512, if available.
+ * Otherwise, every point is interleaved using ileave().
+ *
+ * @tparam DIMS the number of coordinates per point
+ * @param points the points, where the first coordinate of each point comprises the highest bits
+ * @param out the output Morton codes
+ * @param count the number of points
+ */
+template <std::size_t DIMS, typename Uint>
+constexpr auto ileaveBatch(const Uint points[], unsigned long long out[], std::size_t count) noexcept
+    -> std::enable_if_t<areUnsigned<Uint>, void>
+{
+    detail::ileaveBatch_aos<DIMS>(points, out, count);
+}
+
 // NUMBER DE-INTERLEAVING ==============================================================================================
 
 namespace detail {
@@ -335,6 +722,279 @@ constexpr auto dileave(unsigned long long n, Uint (&out)[N]) noexcept -> std::en
     detail::dileave_arr_impl(std::make_index_sequence<N>{}, n, out);
 }
 
+// BATCH DE-INTERLEAVING ===============================================================================================
+
+namespace detail {
+
+template <std::size_t DIMS, typename Uint>
+constexpr void dileaveBatch_soa_naive(const ull_type codes[],
+                                      Uint *const outputs[],
+                                      std::size_t i,
+                                      std::size_t count) noexcept
+{
+    for (; i < count; ++i) {
+        Uint point[DIMS]{};
+        detail::dileave_arr_impl(std::make_index_sequence<DIMS>{}, codes[i], point);
+        for (std::size_t d = 0; d < DIMS; ++d) {
+            outputs[d][i] = point[d];
+        }
+    }
+}
+
+#ifdef BITMANIP_HAS_SIMD_ILEAVE_BATCH
+/// Vectorized remIleavedBits_shift which processes four 64-bit lanes at once.
+template <unsigned BITS>
+BITMANIP_TARGET("avx2")
+[[nodiscard]] inline __m256i remIleavedBits_avx2(__m256i n) noexcept
+{
+    if constexpr (BITS != 0) {
+        constexpr std::size_t iterations = 5 - bitmanip::log2floor(BITS >> 1);
+
+        n = _mm256_and_si256(n, _mm256_set1_epi64x(static_cast<long long>(ILEAVE_ZEROS_MASKS<BITS>[0])));
+        for (std::size_t i = 0; i < iterations; ++i) {
+            const __m128i shift = _mm_cvtsi32_si128(static_cast<int>(BITS * (1u << i)));
+            const __m256i mask = _mm256_set1_epi64x(static_cast<long long>(ILEAVE_ZEROS_MASKS<BITS>[i + 1]));
+            n = _mm256_and_si256(_mm256_or_si256(n, _mm256_srl_epi64(n, shift)), mask);
+        }
+    }
+    return n;
+}
+
+/**
+ * @brief De-interleaves four codes at a time and returns the number of codes which have been processed.
+ * The results are truncated to 32 bits and stored in separate arrays for each dimension.
+ */
+template <std::size_t DIMS>
+BITMANIP_TARGET("avx2")
+[[nodiscard]] inline std::size_t dileaveBatch_soa_avx2(const ull_type codes[],
+                                                       std::uint32_t *const outputs[],
+                                                       std::size_t count) noexcept
+{
+    constexpr unsigned max = DIMS - 1;
+    // gathers the low halves of all four 64-bit lanes in the lower 128 bits
+    const __m256i narrowing = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m256i n = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(codes + i));
+        for (unsigned d = 0; d < DIMS; ++d) {
+            const __m256i shifted = _mm256_srl_epi64(n, _mm_cvtsi32_si128(static_cast<int>(max - d)));
+            const __m256i result = _mm256_permutevar8x32_epi32(remIleavedBits_avx2<max>(shifted), narrowing);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(outputs[d] + i), _mm256_castsi256_si128(result));
+        }
+    }
+    return i;
+}
+
+/// Vectorized remIleavedBits_shift which processes eight 64-bit lanes at once.
+template <unsigned BITS>
+BITMANIP_TARGET("avx512f")
+[[nodiscard]] inline __m512i remIleavedBits_avx512(__m512i n) noexcept
+{
+    if constexpr (BITS != 0) {
+        constexpr std::size_t iterations = 5 - bitmanip::log2floor(BITS >> 1);
+
+        n = _mm512_and_si512(n, _mm512_set1_epi64(static_cast<long long>(ILEAVE_ZEROS_MASKS<BITS>[0])));
+        for (std::size_t i = 0; i < iterations; ++i) {
+            const __m128i shift = _mm_cvtsi32_si128(static_cast<int>(BITS * (1u << i)));
+            const __m512i mask = _mm512_set1_epi64(static_cast<long long>(ILEAVE_ZEROS_MASKS<BITS>[i + 1]));
+            // _mm512_srl_epi64 triggers -Wuninitialized in the headers of GCC 12
+            n = _mm512_and_si512(_mm512_or_si512(n, _mm512_maskz_srl_epi64(0xff, n, shift)), mask);
+        }
+    }
+    return n;
+}
+
+/// De-interleaves eight codes at a time, see dileaveBatch_soa_avx2().
+template <std::size_t DIMS>
+BITMANIP_TARGET("avx512f")
+[[nodiscard]] inline std::size_t dileaveBatch_soa_avx512(const ull_type codes[],
+                                                         std::uint32_t *const outputs[],
+                                                         std::size_t count) noexcept
+{
+    constexpr unsigned max = DIMS - 1;
+
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m512i n = _mm512_loadu_si512(codes + i);
+        for (unsigned d = 0; d < DIMS; ++d) {
+            // _mm512_srl_epi64 and _mm512_cvtepi64_epi32 trigger -Wuninitialized in the headers of GCC 12
+            const __m512i shifted = _mm512_maskz_srl_epi64(0xff, n, _mm_cvtsi32_si128(static_cast<int>(max - d)));
+            const __m256i result = _mm512_maskz_cvtepi64_epi32(0xff, remIleavedBits_avx512<max>(shifted));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(outputs[d] + i), result);
+        }
+    }
+    return i;
+}
+
+/// De-interleaves as many codes as possible using the widest available vectors and returns their number.
+template <std::size_t DIMS>
+[[nodiscard]] inline std::size_t dileaveBatch_soa_simd(const ull_type codes[],
+                                                       std::uint32_t *const outputs[],
+                                                       std::size_t count) noexcept
+{
+    if (CPU_FEATURES.avx512f) {
+        return detail::dileaveBatch_soa_avx512<DIMS>(codes, outputs, count);
+    }
+    if (CPU_FEATURES.avx2) {
+        return detail::dileaveBatch_soa_avx2<DIMS>(codes, outputs, count);
+    }
+    return 0;
+}
+#endif
+
+template <std::size_t DIMS, typename Uint>
+constexpr void dileaveBatch_soa(const ull_type codes[], Uint *const outputs[], std::size_t count) noexcept
+{
+    static_assert(DIMS != 0 && DIMS <= 8, "Between one and eight coordinates can be de-interleaved");
+
+    std::size_t i = 0;
+#ifdef BITMANIP_HAS_SIMD_ILEAVE_BATCH
+    if constexpr (std::is_same_v<Uint, std::uint32_t>) {
+        if (not builtin::isconsteval()) {
+            i = detail::dileaveBatch_soa_simd<DIMS>(codes, outputs, count);
+        }
+    }
+#endif
+    detail::dileaveBatch_soa_naive<DIMS>(codes, outputs, i, count);
+}
+
+}  // namespace detail
+
+/**
+ * @brief De-interleaves count Morton codes into two separate arrays (structure of arrays).
+ * This is equivalent to dileave(codes[i], x[i], y[i]) for every i < count.
+ *
+ * For std::uint32_t outputs, multiple codes are de-interleaved at once using AVX2 or AVX-512, if available.
+ * Otherwise, every code is de-interleaved using dileave().
+ *
+ * @param codes the Morton codes
+ * @param x the highest bits
+ * @param y the lowest bits
+ * @param count the number of codes
+ */
+template <typename Uint>
+constexpr auto dileaveBatch(const unsigned long long codes[], Uint x[], Uint y[], std::size_t count) noexcept
+    -> std::enable_if_t<areUnsigned<Uint>, void>
+{
+    Uint *const outputs[]{x, y};
+    detail::dileaveBatch_soa<2>(codes, outputs, count);
+}
+
+/**
+ * @brief De-interleaves count Morton codes into three separate arrays (structure of arrays).
+ * This is equivalent to dileave(codes[i], x[i], y[i], z[i]) for every i < count.
+ *
+ * For std::uint32_t outputs, multiple codes are de-interleaved at once using AVX2 or AVX-512, if available.
+ * Otherwise, every code is de-interleaved using dileave().
+ *
+ * @param codes the Morton codes
+ * @param x the highest bits
+ * @param y the middle bits
+ * @param z the lowest bits
+ * @param count the number of codes
+ */
+template <typename Uint>
+constexpr auto dileaveBatch(const unsigned long long codes[], Uint x[], Uint y[], Uint z[], std::size_t count) noexcept
+    -> std::enable_if_t<areUnsigned<Uint>, void>
+{
+    Uint *const outputs[]{x, y, z};
+    detail::dileaveBatch_soa<3>(codes, outputs, count);
+}
+
+// 128-BIT NUMBER INTERLEAVING =========================================================================================
+
+#ifdef BITMANIP_HAS_INT128
+namespace detail {
+
+/// The number of bits of a number that ileaveZeros_const can interleave with BITS zero-bits at once.
+template <unsigned BITS>
+inline constexpr unsigned ILEAVE_CHUNK_BITS = 64 / (BITS + 1) < 32 ? 64 / (BITS + 1) : 32;
+
+/**
+ * @brief Like ileaveZeros_const, but for a 64-bit input and a 128-bit output.
+ * The input is split into chunks which are small enough to be interleaved by ileaveZeros_const, so that the same
+ * implementation strategy is used.
+ */
+template <unsigned BITS, unsigned SHIFT>
+[[nodiscard]] constexpr uint128_t ileaveZeros128(std::uint64_t input) noexcept
+{
+    constexpr unsigned chunkBits = ILEAVE_CHUNK_BITS<BITS>;
+    constexpr unsigned outputChunkBits = chunkBits * (BITS + 1);
+    constexpr std::uint64_t chunkMask = (std::uint64_t{1} << chunkBits) - 1;
+
+    uint128_t result = 0;
+    for (unsigned i = 0, shift = 0; i < 64 && shift < 128; i += chunkBits, shift += outputChunkBits) {
+        const auto chunk = static_cast<std::uint32_t>((input >> i) & chunkMask);
+        result |= uint128_t{ileaveZeros_const<BITS, SHIFT>(chunk)} << shift;
+    }
+    return result;
+}
+
+/**
+ * @brief Like remIleavedBits_const, but for a 128-bit input.
+ */
+template <unsigned BITS, unsigned SHIFT>
+[[nodiscard]] constexpr std::uint64_t remIleavedBits128(uint128_t input) noexcept
+{
+    constexpr unsigned chunkBits = ILEAVE_CHUNK_BITS<BITS>;
+    constexpr unsigned outputChunkBits = chunkBits * (BITS + 1);
+    constexpr std::uint64_t chunkMask = (std::uint64_t{1} << chunkBits) - 1;
+
+    std::uint64_t result = 0;
+    for (unsigned i = 0, shift = 0; i < 64 && shift < 128; i += chunkBits, shift += outputChunkBits) {
+        const auto chunk = static_cast<std::uint64_t>(input >> shift);
+        result |= (remIleavedBits_const<BITS, SHIFT>(chunk) & chunkMask) << i;
+    }
+    return result;
+}
+
+template <typename... Uint, std::size_t... I>
+[[nodiscard]] constexpr uint128_t ileave128_impl(std::index_sequence<I...>, Uint... args) noexcept
+{
+    constexpr std::size_t max = sizeof...(I) - 1;
+    return (ileaveZeros128<max, max - I>(args) | ...);
+}
+
+template <typename... Uint, std::size_t... I>
+constexpr void dileave128_impl(std::index_sequence<I...>, uint128_t n, Uint &... out) noexcept
+{
+    constexpr std::size_t max = sizeof...(I) - 1;
+    ((out = static_cast<Uint>(remIleavedBits128<max, max - I>(n))), ...);
+}
+
+}  // namespace detail
+
+/**
+ * @brief Interleaves integers into a 128-bit Morton code, where the first argument comprises the uppermost bits.
+ * This allows for up to 64 bits per number in 2D, 42 bits in 3D and 32 bits in 4D.
+ *
+ * @param args the numbers to interleave
+ * @return the interleaved bits
+ */
+template <typename... Uint>
+[[nodiscard]] constexpr auto ileave128(Uint... args) noexcept
+    -> std::enable_if_t<areUnsigned<Uint...>, uint128_t>
+{
+    static_assert(sizeof...(Uint) != 0, "At least one number must be interleaved");
+    return detail::ileave128_impl(std::make_index_sequence<sizeof...(Uint)>{}, static_cast<std::uint64_t>(args)...);
+}
+
+/**
+ * @brief Deinterleaves integers which are interleaved in a single 128-bit number.
+ * This is the inverse of ileave128.
+ *
+ * @param n the number
+ * @param out the de-interleaved numbers, where the first output receives the uppermost bits
+ */
+template <typename... Uint>
+constexpr auto dileave128(uint128_t n, Uint &... out) noexcept -> std::enable_if_t<areUnsigned<Uint...>, void>
+{
+    static_assert(sizeof...(Uint) != 0, "At least one number must be de-interleaved");
+    detail::dileave128_impl(std::make_index_sequence<sizeof...(Uint)>{}, n, out...);
+}
+#endif
+
 // BYTE INTERLEAVING ===================================================================================================
 
 /**
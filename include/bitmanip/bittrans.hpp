@@ -0,0 +1,308 @@
+#ifndef BITMANIP_BITTRANS_HPP
+#define BITMANIP_BITTRANS_HPP
+/*
+ * bittrans.hpp
+ * -----------
+ * Provides transposition of square bit matrices.
+ *
+ * An 8x8 matrix is stored in a single std::uint64_t, where byte i is row i and bit j of each byte is column j.
+ * A 64x64 matrix is stored in 64 std::uint64_t, where element i is row i and bit j of each element is column j.
+ *
+ * Both are transposed using recursive block swaps (see Hacker's Delight, 7-3 Transposing a Bit Matrix).
+ * Swapping the two off-diagonal blocks of every 2j x 2j sub-matrix exchanges bit j of the row index with bit j of the
+ * column index, so log2(size) such rounds transpose the whole matrix.
+ * These rounds are independent of each other and can be performed in any order.
+ */
+
+#include "build.hpp"
+#include "builtin.hpp"
+#include "cpu.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(BITMANIP_X64) && (defined(BITMANIP_MSVC) || defined(BITMANIP_GNU_OR_CLANG))
+// SSE2 is part of x86-64, AVX2 is detected at runtime
+#define BITMANIP_HAS_SIMD_TRANSPOSE
+#endif
+
+namespace bitmanip {
+
+// 8x8 TRANSPOSITION ===================================================================================================
+
+namespace detail {
+
+[[nodiscard]] constexpr std::uint64_t transpose8x8_naive(std::uint64_t matrix) noexcept
+{
+    std::uint64_t result = 0;
+    for (unsigned i = 0; i < 8; ++i) {
+        for (unsigned j = 0; j < 8; ++j) {
+            result |= ((matrix >> (i * 8 + j)) & 1) << (j * 8 + i);
+        }
+    }
+    return result;
+}
+
+[[nodiscard]] constexpr std::uint64_t transpose8x8_shift(std::uint64_t x) noexcept
+{
+    x = (x & 0xaa55'aa55'aa55'aa55) | ((x & 0x00aa'00aa'00aa'00aa) << 7) | ((x >> 7) & 0x00aa'00aa'00aa'00aa);
+    x = (x & 0xcccc'3333'cccc'3333) | ((x & 0x0000'cccc'0000'cccc) << 14) | ((x >> 14) & 0x0000'cccc'0000'cccc);
+    x = (x & 0xf0f0'f0f0'0f0f'0f0f) | ((x & 0x0000'0000'f0f0'f0f0) << 28) | ((x >> 28) & 0x0000'0000'f0f0'f0f0);
+    return x;
+}
+
+#ifdef BITMANIP_HAS_SIMD_TRANSPOSE
+/// Swaps the bits selected by MASK with the bits SHIFT positions above them, in every 64-bit lane.
+template <int SHIFT, std::uint64_t MASK>
+inline __m128i deltaSwap_sse2(__m128i x) noexcept
+{
+    const __m128i t = _mm_and_si128(_mm_xor_si128(x, _mm_srli_epi64(x, SHIFT)), _mm_set1_epi64x(MASK));
+    return _mm_xor_si128(_mm_xor_si128(x, t), _mm_slli_epi64(t, SHIFT));
+}
+
+/// Performs transpose8x8() on every 64-bit lane.
+inline __m128i transpose8x8_sse2(__m128i x) noexcept
+{
+    x = deltaSwap_sse2<7, 0x00aa'00aa'00aa'00aa>(x);
+    x = deltaSwap_sse2<14, 0x0000'cccc'0000'cccc>(x);
+    return deltaSwap_sse2<28, 0x0000'0000'f0f0'f0f0>(x);
+}
+
+template <int SHIFT, std::uint64_t MASK>
+BITMANIP_TARGET("avx2")
+inline __m256i deltaSwap_avx2(__m256i x) noexcept
+{
+    const __m256i t = _mm256_and_si256(_mm256_xor_si256(x, _mm256_srli_epi64(x, SHIFT)), _mm256_set1_epi64x(MASK));
+    return _mm256_xor_si256(_mm256_xor_si256(x, t), _mm256_slli_epi64(t, SHIFT));
+}
+
+BITMANIP_TARGET("avx2")
+inline __m256i transpose8x8_avx2(__m256i x) noexcept
+{
+    x = deltaSwap_avx2<7, 0x00aa'00aa'00aa'00aa>(x);
+    x = deltaSwap_avx2<14, 0x0000'cccc'0000'cccc>(x);
+    return deltaSwap_avx2<28, 0x0000'0000'f0f0'f0f0>(x);
+}
+
+/// Returns the number of matrices which were transposed, which is a multiple of 4.
+BITMANIP_TARGET("avx2")
+inline std::size_t transpose8x8Batch_avx2(const std::uint64_t in[], std::uint64_t out[], std::size_t count) noexcept
+{
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), transpose8x8_avx2(x));
+    }
+    return i;
+}
+
+/// Returns the number of matrices which were transposed, which is a multiple of 2.
+inline std::size_t transpose8x8Batch_sse2(const std::uint64_t in[],
+                                          std::uint64_t out[],
+                                          std::size_t i,
+                                          std::size_t count) noexcept
+{
+    for (; i + 2 <= count; i += 2) {
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), transpose8x8_sse2(x));
+    }
+    return i;
+}
+#endif
+
+}  // namespace detail
+
+/**
+ * @brief Transposes an 8x8 bit matrix, where byte i is row i and bit j of each byte is column j.
+ * This is equivalent to moving bit (i * 8 + j) to bit (j * 8 + i) for every i, j < 8.
+ * Example: transpose8x8(0xff) = 0x0101'0101'0101'0101
+ * @param matrix the matrix
+ * @return the transposed matrix
+ */
+[[nodiscard]] constexpr std::uint64_t transpose8x8(std::uint64_t matrix) noexcept
+{
+    return detail::transpose8x8_shift(matrix);
+}
+
+/**
+ * @brief Transposes multiple 8x8 bit matrices.
+ * This is equivalent to out[i] = transpose8x8(in[i]) for every i < count.
+ * Four matrices at a time are transposed using AVX2, if available, or two at a time using SSE2.
+ * @param in the matrices
+ * @param out the transposed matrices, which may be identical to in, but must not overlap it otherwise
+ * @param count the number of matrices
+ */
+inline void transpose8x8Batch(const std::uint64_t in[], std::uint64_t out[], std::size_t count) noexcept
+{
+    std::size_t i = 0;
+#ifdef BITMANIP_HAS_SIMD_TRANSPOSE
+    if (CPU_FEATURES.avx2) {
+        i = detail::transpose8x8Batch_avx2(in, out, count);
+    }
+    i = detail::transpose8x8Batch_sse2(in, out, i, count);
+#endif
+    for (; i < count; ++i) {
+        out[i] = detail::transpose8x8_shift(in[i]);
+    }
+}
+
+// 64x64 TRANSPOSITION =================================================================================================
+
+namespace detail {
+
+constexpr void transpose64x64_naive(std::uint64_t matrix[64]) noexcept
+{
+    for (unsigned i = 0; i < 64; ++i) {
+        for (unsigned j = i + 1; j < 64; ++j) {
+            const std::uint64_t a = (matrix[i] >> j) & 1;
+            const std::uint64_t b = (matrix[j] >> i) & 1;
+            matrix[i] ^= (a ^ b) << j;
+            matrix[j] ^= (a ^ b) << i;
+        }
+    }
+}
+
+constexpr void transpose64x64_shift(std::uint64_t matrix[64]) noexcept
+{
+    // the mask selects the lower j columns of every 2j columns
+    std::uint64_t mask = 0x0000'0000'ffff'ffff;
+    for (unsigned j = 32; j != 0; j >>= 1, mask ^= mask << j) {
+        // k iterates over all rows in the upper half of every 2j rows
+        for (unsigned k = 0; k < 64; k = ((k | j) + 1) & ~j) {
+            const std::uint64_t t = ((matrix[k] >> j) ^ matrix[k | j]) & mask;
+            matrix[k] ^= t << j;
+            matrix[k | j] ^= t;
+        }
+    }
+}
+
+#ifdef BITMANIP_HAS_SIMD_TRANSPOSE
+/*
+ * Each vector holds four consecutive rows.
+ * Rounds in which the swapped rows are at least four rows apart are performed between whole vectors.
+ * The rounds for j = 2 and j = 1 swap rows within each vector, so the partner rows are moved into place first.
+ *
+ * The matrix is transposed in two passes over groups of four vectors, so that each group fits into registers.
+ * The first pass performs the rounds j = 8, 4, 2, 1 on 16 consecutive rows, the second one the rounds j = 32, 16 on
+ * rows which are 16 apart.
+ */
+
+/// Performs a round of the block swap between the rows in lo and the rows j = SHIFT rows below them in hi.
+template <int SHIFT, std::uint64_t MASK>
+BITMANIP_TARGET("avx2")
+inline void blockSwap_avx2(__m256i &lo, __m256i &hi) noexcept
+{
+    const __m256i t = _mm256_and_si256(_mm256_xor_si256(_mm256_srli_epi64(lo, SHIFT), hi), _mm256_set1_epi64x(MASK));
+    lo = _mm256_xor_si256(lo, _mm256_slli_epi64(t, SHIFT));
+    hi = _mm256_xor_si256(hi, t);
+}
+
+/**
+ * @brief Performs a round of the block swap between the rows of a single vector.
+ * @tparam HI the blend mask of the 32-bit lanes which hold the second row of each swapped pair
+ * @param partner x, where each row has been exchanged with the row it is swapped with
+ */
+template <int SHIFT, std::uint64_t MASK, int HI>
+BITMANIP_TARGET("avx2")
+inline __m256i blockSwapRows_avx2(__m256i x, __m256i partner) noexcept
+{
+    const __m256i lo = _mm256_blend_epi32(x, partner, HI);
+    const __m256i hi = _mm256_blend_epi32(partner, x, HI);
+    const __m256i t = _mm256_and_si256(_mm256_xor_si256(_mm256_srli_epi64(lo, SHIFT), hi), _mm256_set1_epi64x(MASK));
+    return _mm256_xor_si256(x, _mm256_blend_epi32(_mm256_slli_epi64(t, SHIFT), t, HI));
+}
+
+BITMANIP_TARGET("avx2")
+inline void transpose64x64_avx2(std::uint64_t matrix[64]) noexcept
+{
+    auto *const rows = reinterpret_cast<__m256i *>(matrix);
+
+    for (std::size_t g = 0; g < 16; g += 4) {
+        __m256i v0 = _mm256_loadu_si256(rows + g + 0);
+        __m256i v1 = _mm256_loadu_si256(rows + g + 1);
+        __m256i v2 = _mm256_loadu_si256(rows + g + 2);
+        __m256i v3 = _mm256_loadu_si256(rows + g + 3);
+
+        blockSwap_avx2<8, 0x00ff'00ff'00ff'00ff>(v0, v2);
+        blockSwap_avx2<8, 0x00ff'00ff'00ff'00ff>(v1, v3);
+        blockSwap_avx2<4, 0x0f0f'0f0f'0f0f'0f0f>(v0, v1);
+        blockSwap_avx2<4, 0x0f0f'0f0f'0f0f'0f0f>(v2, v3);
+
+        v0 = blockSwapRows_avx2<2, 0x3333'3333'3333'3333, 0xf0>(v0, _mm256_permute4x64_epi64(v0, 0x4e));
+        v1 = blockSwapRows_avx2<2, 0x3333'3333'3333'3333, 0xf0>(v1, _mm256_permute4x64_epi64(v1, 0x4e));
+        v2 = blockSwapRows_avx2<2, 0x3333'3333'3333'3333, 0xf0>(v2, _mm256_permute4x64_epi64(v2, 0x4e));
+        v3 = blockSwapRows_avx2<2, 0x3333'3333'3333'3333, 0xf0>(v3, _mm256_permute4x64_epi64(v3, 0x4e));
+
+        v0 = blockSwapRows_avx2<1, 0x5555'5555'5555'5555, 0xcc>(v0, _mm256_shuffle_epi32(v0, 0x4e));
+        v1 = blockSwapRows_avx2<1, 0x5555'5555'5555'5555, 0xcc>(v1, _mm256_shuffle_epi32(v1, 0x4e));
+        v2 = blockSwapRows_avx2<1, 0x5555'5555'5555'5555, 0xcc>(v2, _mm256_shuffle_epi32(v2, 0x4e));
+        v3 = blockSwapRows_avx2<1, 0x5555'5555'5555'5555, 0xcc>(v3, _mm256_shuffle_epi32(v3, 0x4e));
+
+        _mm256_storeu_si256(rows + g + 0, v0);
+        _mm256_storeu_si256(rows + g + 1, v1);
+        _mm256_storeu_si256(rows + g + 2, v2);
+        _mm256_storeu_si256(rows + g + 3, v3);
+    }
+
+    for (std::size_t g = 0; g < 4; ++g) {
+        __m256i v0 = _mm256_loadu_si256(rows + g + 0);
+        __m256i v1 = _mm256_loadu_si256(rows + g + 4);
+        __m256i v2 = _mm256_loadu_si256(rows + g + 8);
+        __m256i v3 = _mm256_loadu_si256(rows + g + 12);
+
+        blockSwap_avx2<32, 0x0000'0000'ffff'ffff>(v0, v2);
+        blockSwap_avx2<32, 0x0000'0000'ffff'ffff>(v1, v3);
+        blockSwap_avx2<16, 0x0000'ffff'0000'ffff>(v0, v1);
+        blockSwap_avx2<16, 0x0000'ffff'0000'ffff>(v2, v3);
+
+        _mm256_storeu_si256(rows + g + 0, v0);
+        _mm256_storeu_si256(rows + g + 4, v1);
+        _mm256_storeu_si256(rows + g + 8, v2);
+        _mm256_storeu_si256(rows + g + 12, v3);
+    }
+}
+#endif
+
+}  // namespace detail
+
+/**
+ * @brief Transposes a 64x64 bit matrix in place, where element i is row i and bit j of each element is column j.
+ * This is equivalent to swapping bit j of matrix[i] with bit i of matrix[j] for every i < j < 64.
+ * The matrix is transposed using AVX2, if available.
+ * @param matrix the 64 rows of the matrix
+ */
+constexpr void transpose64x64(std::uint64_t matrix[64]) noexcept
+{
+#ifdef BITMANIP_HAS_SIMD_TRANSPOSE
+    if (not builtin::isconsteval() && CPU_FEATURES.avx2) {
+        detail::transpose64x64_avx2(matrix);
+        return;
+    }
+#endif
+    detail::transpose64x64_shift(matrix);
+}
+
+/**
+ * @brief Transposes multiple 64x64 bit matrices in place.
+ * This is equivalent to transpose64x64(matrices + i * 64) for every i < count.
+ * @param matrices the matrices, each consisting of 64 consecutive rows
+ * @param count the number of matrices
+ */
+inline void transpose64x64Batch(std::uint64_t matrices[], std::size_t count) noexcept
+{
+#ifdef BITMANIP_HAS_SIMD_TRANSPOSE
+    if (CPU_FEATURES.avx2) {
+        for (std::size_t i = 0; i < count; ++i) {
+            detail::transpose64x64_avx2(matrices + i * 64);
+        }
+        return;
+    }
+#endif
+    for (std::size_t i = 0; i < count; ++i) {
+        detail::transpose64x64_shift(matrices + i * 64);
+    }
+}
+
+}  // namespace bitmanip
+
+#endif  // BITMANIP_BITTRANS_HPP
@@ -69,6 +69,12 @@
 #define BITMANIP_FWDHEADER(header) <header>
 #endif
 
+// EXTENDED INTEGER TYPE DETECTION =====================================================================================
+
+#ifdef __SIZEOF_INT128__
+#define BITMANIP_HAS_INT128
+#endif
+
 // ARCH DETECTION ======================================================================================================
 
 #ifdef __i386__
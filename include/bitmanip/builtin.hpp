@@ -13,6 +13,7 @@
 #endif
 
 #if defined(BITMANIP_X86_OR_X64) && defined(BITMANIP_GNU_OR_CLANG)
+#include <cpuid.h>
 #include <immintrin.h>
 #endif
 
@@ -68,6 +69,18 @@
 #define BITMANIP_ASSUME(condition)
 #endif
 
+// BITMANIP_TARGET(isa):
+//     Allows a single function to use the instructions of an instruction set extension such as "bmi2" or "avx2",
+//     even if the translation unit is not compiled for it.
+//     Such functions must only be called after verifying at runtime that the CPU supports the extension.
+//     This macro is always defined, but does nothing for compilers which make all intrinsics available anyways.
+#if defined(BITMANIP_X86_OR_X64) && defined(BITMANIP_GNU_OR_CLANG)
+#define BITMANIP_HAS_BUILTIN_TARGET
+#define BITMANIP_TARGET(isa) __attribute__((target(isa)))
+#else
+#define BITMANIP_TARGET(isa)
+#endif
+
 namespace bitmanip::builtin {
 
 // void trap():
@@ -591,14 +604,63 @@ Uint bitrev(Uint x) noexcept
 }
 #endif
 
+// CPU IDENTIFICATION ==================================================================================================
+
+// void cpuid(unsigned leaf, unsigned subleaf, unsigned out[4]):
+//     Executes the cpuid instruction and stores the resulting eax, ebx, ecx, edx registers in out.
+//     See https://www.felixcloutier.com/x86/cpuid
+// std::uint64_t xgetbv(unsigned index):
+//     Reads an extended control register. XCR0 tells which register states (such as AVX) the OS preserves.
+//     This must only be called if cpuid reports OSXSAVE support.
+#if defined(BITMANIP_X86_OR_X64) && defined(BITMANIP_GNU_OR_CLANG)
+#define BITMANIP_HAS_BUILTIN_CPUID
+inline void cpuid(unsigned leaf, unsigned subleaf, unsigned out[4]) noexcept
+{
+    out[0] = out[1] = out[2] = out[3] = 0;
+    if (leaf <= __get_cpuid_max(leaf & 0x8000'0000u, nullptr)) {
+        __cpuid_count(leaf, subleaf, out[0], out[1], out[2], out[3]);
+    }
+}
+
+inline std::uint64_t xgetbv(unsigned index) noexcept
+{
+    std::uint32_t eax, edx;
+    __asm__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(index));
+    return (std::uint64_t{edx} << 32) | eax;
+}
+
+#elif defined(BITMANIP_X86_OR_X64) && defined(BITMANIP_MSVC)
+#define BITMANIP_HAS_BUILTIN_CPUID
+__forceinline void cpuid(unsigned leaf, unsigned subleaf, unsigned out[4]) noexcept
+{
+    int regs[4];
+    __cpuid(regs, static_cast<int>(leaf & 0x8000'0000u));
+    if (leaf > static_cast<unsigned>(regs[0])) {
+        out[0] = out[1] = out[2] = out[3] = 0;
+        return;
+    }
+    __cpuidex(regs, static_cast<int>(leaf), static_cast<int>(subleaf));
+    for (int i = 0; i < 4; ++i) {
+        out[i] = static_cast<unsigned>(regs[i]);
+    }
+}
+
+__forceinline std::uint64_t xgetbv(unsigned index) noexcept
+{
+    return _xgetbv(index);
+}
+#endif
+
 // BMI2 BITWISE OPS ====================================================================================================
 
 // uintXX_t pdep(uintXX_t val, uintXX_t mask):
 //     See https://www.felixcloutier.com/x86/pdep
-#if defined(BITMANIP_X86_OR_X64) && (defined(BITMANIP_MSVC) || defined(BITMANIP_GNU_OR_CLANG) && defined(__BMI2__))
+//     Unless __BMI2__ is defined, this function is compiled using BITMANIP_TARGET("bmi2") and must only be called if
+//     CPU_FEATURES.bmi2 is set (see cpu.hpp).
+#if defined(BITMANIP_X86_OR_X64) && (defined(BITMANIP_MSVC) || defined(BITMANIP_GNU_OR_CLANG))
 #define BITMANIP_HAS_BUILTIN_PDEP
 template <typename Uint, std::enable_if_t<(std::is_unsigned_v<Uint> && sizeof(Uint) <= 8), int> = 0>
-Uint pdep(Uint val, Uint mask)
+BITMANIP_TARGET("bmi2") inline Uint pdep(Uint val, Uint mask)
 {
     if constexpr (sizeof(Uint) < 8) {
         return _pdep_u32(static_cast<uint32_t>(val), static_cast<uint32_t>(mask));
@@ -610,12 +672,13 @@ Uint pdep(Uint val, Uint mask)
 
 // uintXX_t pext(uintXX_t val, uintXX_t mask):
 //     See https://www.felixcloutier.com/x86/pext
+//     The same restrictions as for pdep apply.
 #define BITMANIP_HAS_BUILTIN_PEXT
 template <typename Uint, std::enable_if_t<(std::is_unsigned_v<Uint> && sizeof(Uint) <= 8), int> = 0>
-Uint pext(Uint val, Uint mask)
+BITMANIP_TARGET("bmi2") inline Uint pext(Uint val, Uint mask)
 {
     if constexpr (sizeof(Uint) < 8) {
-        return _pext_u32(static_cast<uint64_t>(val), static_cast<uint64_t>(mask));
+        return _pext_u32(static_cast<uint32_t>(val), static_cast<uint32_t>(mask));
     }
     else {
         return _pext_u64(val, mask);
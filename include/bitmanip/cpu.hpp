@@ -0,0 +1,82 @@
+#ifndef BITMANIP_CPU_HPP
+#define BITMANIP_CPU_HPP
+/*
+ * cpu.hpp
+ * -----------
+ * Detects the features of the CPU which the program is running on.
+ * This allows choosing the fastest implementation at runtime, so that a single binary which is compiled for a generic
+ * baseline such as x86-64 can still use instructions like pdep or vpopcntq when they are available and fast.
+ */
+
+#include "build.hpp"
+#include "builtin.hpp"
+
+namespace bitmanip {
+
+/**
+ * @brief Describes the instruction set extensions of a CPU which are relevant to this library.
+ * Vector extensions are only reported if the OS also preserves the corresponding registers.
+ */
+struct CpuFeatures {
+    bool ssse3;
+    bool popcnt;
+    bool bmi2;
+    /// True if pdep/pext are implemented in hardware, not in microcode like on AMD CPUs prior to Zen 3.
+    bool fastPdep;
+    bool avx2;
+    bool avx512f;
+    bool avx512bw;
+    bool avx512vpopcntdq;
+};
+
+namespace detail {
+
+[[nodiscard]] inline CpuFeatures detectCpuFeatures() noexcept
+{
+    CpuFeatures result{};
+#ifdef BITMANIP_HAS_BUILTIN_CPUID
+    unsigned vendor[4], info[4], ext[4];
+    builtin::cpuid(0, 0, vendor);
+    builtin::cpuid(1, 0, info);
+    builtin::cpuid(7, 0, ext);
+
+    // "AuthenticAMD" and "HygonGenuine" (a Zen 1 derivative) both store "Auth"/"Hygo" in ebx
+    const bool isAmdOrHygon = vendor[1] == 0x6874'7541u || vendor[1] == 0x6f67'7948u;
+
+    unsigned family = (info[0] >> 8) & 0xf;
+    if (family == 0xf) {
+        family += (info[0] >> 20) & 0xff;
+    }
+
+    const bool osxsave = (info[2] >> 27) & 1;
+    const std::uint64_t xcr0 = osxsave ? builtin::xgetbv(0) : 0;
+    // XMM and YMM state
+    const bool osAvx = (xcr0 & 0x6) == 0x6;
+    // opmask, upper ZMM and high ZMM state
+    const bool osAvx512 = osAvx && (xcr0 & 0xe0) == 0xe0;
+
+    result.ssse3 = (info[2] >> 9) & 1;
+    result.popcnt = (info[2] >> 23) & 1;
+    result.bmi2 = (ext[1] >> 8) & 1;
+    // family 0x19 is Zen 3, the first AMD microarchitecture with hardware pdep/pext
+    result.fastPdep = result.bmi2 && not(isAmdOrHygon && family < 0x19);
+    result.avx2 = osAvx && ((ext[1] >> 5) & 1);
+    result.avx512f = osAvx512 && ((ext[1] >> 16) & 1);
+    result.avx512bw = osAvx512 && ((ext[1] >> 30) & 1);
+    result.avx512vpopcntdq = osAvx512 && ((ext[2] >> 14) & 1);
+#endif
+    return result;
+}
+
+}  // namespace detail
+
+/**
+ * @brief The features of the CPU which the program is running on.
+ * This is detected once during dynamic initialization.
+ * Before that, all features are zero-initialized to false, so that only portable code paths are taken.
+ */
+inline const CpuFeatures CPU_FEATURES = detail::detectCpuFeatures();
+
+}  // namespace bitmanip
+
+#endif  // BITMANIP_CPU_HPP
@@ -0,0 +1,466 @@
+#ifndef BITMANIP_HILBERT_HPP
+#define BITMANIP_HILBERT_HPP
+/*
+ * hilbert.hpp
+ * -----------
+ * Provides encoding and decoding of Hilbert curve indices in two and three dimensions.
+ *
+ * Unlike the Z-order curve of Morton codes (see ileave() in bitileave.hpp), the Hilbert curve never jumps: consecutive
+ * indices always belong to neighboring cells.
+ * The curve is the one described by John Skilling (Programming the Hilbert curve, 2004).
+ *
+ * Hilbert indices are computed from Morton codes with a state machine, which maps each group of DIMS interleaved bits
+ * to the corresponding group of the Hilbert index.
+ * The interleaving itself is done by ileave() and dileave(), which use pdep/pext where available.
+ *
+ * Two-dimensional indices use all 32 bits of each coordinate, three-dimensional indices use the lower 21 bits.
+ */
+
+#include "bitileave.hpp"
+#include "intlog.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace bitmanip {
+
+// STATE MACHINE =======================================================================================================
+
+namespace detail {
+
+struct HilbertTransition {
+    /// The DIMS bits of the Hilbert index.
+    unsigned char digit;
+    /// The state for the next lower level.
+    unsigned char next;
+};
+
+// Both tables are indexed by [state][digit of the Morton code], where state 0 is the initial state.
+// They were derived from Skilling's algorithm and are verified against hilbertEncode_naive in the tests.
+
+inline constexpr HilbertTransition HILBERT_TRANSITIONS_2[4][4]{
+    {{0, 1}, {1, 0}, {3, 2}, {2, 0}},
+    {{0, 0}, {3, 3}, {1, 1}, {2, 1}},
+    {{2, 2}, {1, 2}, {3, 0}, {0, 3}},
+    {{2, 3}, {3, 1}, {1, 3}, {0, 2}},
+};
+
+inline constexpr HilbertTransition HILBERT_TRANSITIONS_3[24][8]{
+    {{0, 1}, {1, 2}, {3, 3}, {2, 0}, {7, 4}, {6, 5}, {4, 6}, {5, 0}},
+    {{0, 7}, {7, 8}, {1, 9}, {6, 10}, {3, 11}, {4, 2}, {2, 1}, {5, 1}},
+    {{0, 6}, {1, 0}, {7, 12}, {6, 13}, {3, 14}, {2, 2}, {4, 1}, {5, 2}},
+    {{6, 15}, {1, 16}, {5, 3}, {2, 3}, {7, 9}, {0, 10}, {4, 17}, {3, 0}},
+    {{4, 18}, {3, 5}, {5, 4}, {2, 4}, {7, 15}, {0, 16}, {6, 9}, {1, 10}},
+    {{4, 19}, {5, 5}, {3, 4}, {2, 5}, {7, 3}, {6, 0}, {0, 20}, {1, 13}},
+    {{0, 9}, {7, 10}, {3, 17}, {4, 0}, {1, 7}, {6, 8}, {2, 6}, {5, 6}},
+    {{0, 0}, {3, 21}, {7, 13}, {4, 9}, {1, 6}, {2, 7}, {6, 12}, {5, 7}},
+    {{4, 22}, {7, 17}, {3, 10}, {0, 23}, {5, 8}, {6, 6}, {2, 8}, {1, 12}},
+    {{0, 2}, {3, 15}, {1, 1}, {2, 9}, {7, 5}, {4, 7}, {6, 4}, {5, 9}},
+    {{4, 16}, {7, 11}, {5, 10}, {6, 1}, {3, 8}, {0, 18}, {2, 10}, {1, 4}},
+    {{6, 17}, {7, 6}, {1, 23}, {0, 12}, {5, 11}, {4, 14}, {2, 11}, {3, 1}},
+    {{4, 23}, {3, 13}, {7, 21}, {0, 22}, {5, 12}, {2, 12}, {6, 7}, {1, 8}},
+    {{4, 20}, {5, 13}, {7, 14}, {6, 2}, {3, 12}, {2, 13}, {0, 19}, {1, 5}},
+    {{6, 21}, {1, 22}, {7, 7}, {0, 8}, {5, 14}, {2, 14}, {4, 11}, {3, 2}},
+    {{6, 3}, {5, 15}, {1, 20}, {2, 15}, {7, 0}, {4, 21}, {0, 13}, {3, 9}},
+    {{2, 16}, {1, 3}, {5, 16}, {6, 20}, {3, 22}, {0, 17}, {4, 10}, {7, 23}},
+    {{6, 11}, {7, 1}, {5, 17}, {4, 3}, {1, 18}, {0, 4}, {2, 17}, {3, 6}},
+    {{2, 18}, {3, 19}, {5, 18}, {4, 4}, {1, 17}, {0, 3}, {6, 23}, {7, 20}},
+    {{2, 19}, {5, 19}, {3, 18}, {4, 5}, {1, 21}, {6, 22}, {0, 15}, {7, 16}},
+    {{2, 20}, {5, 20}, {1, 15}, {6, 16}, {3, 23}, {4, 13}, {0, 21}, {7, 22}},
+    {{6, 14}, {5, 21}, {7, 2}, {4, 15}, {1, 19}, {2, 21}, {0, 5}, {3, 7}},
+    {{2, 22}, {1, 14}, {3, 16}, {0, 11}, {5, 22}, {6, 19}, {4, 8}, {7, 18}},
+    {{2, 23}, {3, 20}, {1, 11}, {0, 14}, {5, 23}, {4, 12}, {6, 18}, {7, 19}},
+};
+
+template <std::size_t DIMS>
+[[nodiscard]] constexpr HilbertTransition hilbertTransition(unsigned state, unsigned mortonDigit) noexcept
+{
+    static_assert(DIMS == 2 || DIMS == 3, "Hilbert curves are only provided for two and three dimensions");
+    if constexpr (DIMS == 2) {
+        return HILBERT_TRANSITIONS_2[state][mortonDigit];
+    }
+    else {
+        return HILBERT_TRANSITIONS_3[state][mortonDigit];
+    }
+}
+
+template <std::size_t DIMS>
+inline constexpr unsigned HILBERT_STATE_COUNT = DIMS == 2 ? 4 : 24;
+
+/// The number of bits per coordinate.
+template <std::size_t DIMS>
+inline constexpr unsigned HILBERT_LEVELS = 64 / DIMS;
+
+/// The number of levels which are processed with a single table lookup.
+template <std::size_t DIMS>
+inline constexpr unsigned HILBERT_LUT_LEVELS = DIMS == 2 ? 4 : 3;
+
+template <std::size_t DIMS>
+inline constexpr unsigned HILBERT_LUT_INDEX_BITS = DIMS * HILBERT_LUT_LEVELS<DIMS>;
+
+template <std::size_t DIMS>
+inline constexpr std::size_t HILBERT_LUT_SIZE = std::size_t{HILBERT_STATE_COUNT<DIMS>} << HILBERT_LUT_INDEX_BITS<DIMS>;
+
+// Each entry of the tables below is indexed by (state << INDEX_BITS | input) and stores (next << INDEX_BITS | output).
+// This way, the next state is already shifted into place for the next lookup.
+
+template <std::size_t DIMS>
+[[nodiscard]] constexpr Table<std::uint16_t, HILBERT_LUT_SIZE<DIMS>> makeMortonToHilbertLut() noexcept
+{
+    constexpr unsigned indexBits = HILBERT_LUT_INDEX_BITS<DIMS>;
+    constexpr unsigned digitMask = (1u << DIMS) - 1;
+
+    Table<std::uint16_t, HILBERT_LUT_SIZE<DIMS>> result{};
+    for (unsigned state = 0; state < HILBERT_STATE_COUNT<DIMS>; ++state) {
+        for (unsigned morton = 0; morton < (1u << indexBits); ++morton) {
+            unsigned next = state;
+            unsigned hilbert = 0;
+            for (unsigned level = HILBERT_LUT_LEVELS<DIMS>; level-- != 0;) {
+                const HilbertTransition t = hilbertTransition<DIMS>(next, (morton >> (level * DIMS)) & digitMask);
+                hilbert |= unsigned{t.digit} << (level * DIMS);
+                next = t.next;
+            }
+            result[state << indexBits | morton] = static_cast<std::uint16_t>(next << indexBits | hilbert);
+        }
+    }
+    return result;
+}
+
+template <std::size_t DIMS>
+[[nodiscard]] constexpr Table<std::uint16_t, HILBERT_LUT_SIZE<DIMS>> makeHilbertToMortonLut() noexcept
+{
+    constexpr unsigned indexBits = HILBERT_LUT_INDEX_BITS<DIMS>;
+    constexpr unsigned indexMask = (1u << indexBits) - 1;
+    constexpr auto encodeLut = makeMortonToHilbertLut<DIMS>();
+
+    // every state maps the Morton digits bijectively, so inverting the encoding table covers every entry
+    Table<std::uint16_t, HILBERT_LUT_SIZE<DIMS>> result{};
+    for (unsigned i = 0; i < HILBERT_LUT_SIZE<DIMS>; ++i) {
+        const unsigned state = i >> indexBits;
+        const unsigned morton = i & indexMask;
+        const unsigned entry = encodeLut[i];
+        result[state << indexBits | (entry & indexMask)] = static_cast<std::uint16_t>((entry & ~indexMask) | morton);
+    }
+    return result;
+}
+
+template <std::size_t DIMS>
+inline constexpr Table<std::uint16_t, HILBERT_LUT_SIZE<DIMS>> MORTON_TO_HILBERT_LUT = makeMortonToHilbertLut<DIMS>();
+
+template <std::size_t DIMS>
+inline constexpr Table<std::uint16_t, HILBERT_LUT_SIZE<DIMS>> HILBERT_TO_MORTON_LUT = makeHilbertToMortonLut<DIMS>();
+
+// the lookups are unrolled using a fold expression, much like ileaveZeros_lut
+template <std::size_t DIMS, std::size_t... I>
+[[nodiscard]] constexpr unsigned long long hilbertLut_impl(std::index_sequence<I...>,
+                                                           const Table<std::uint16_t, HILBERT_LUT_SIZE<DIMS>> &lut,
+                                                           unsigned long long input) noexcept
+{
+    constexpr unsigned indexBits = HILBERT_LUT_INDEX_BITS<DIMS>;
+    constexpr unsigned indexMask = (1u << indexBits) - 1;
+    constexpr unsigned lookups = sizeof...(I);
+
+    unsigned long long result = 0;
+    unsigned entry = 0;
+    ((entry = lut[(entry & ~indexMask) | ((input >> ((lookups - 1 - I) * indexBits)) & indexMask)],
+      result |= static_cast<unsigned long long>(entry & indexMask) << ((lookups - 1 - I) * indexBits)),
+     ...);
+    return result;
+}
+
+template <std::size_t DIMS>
+[[nodiscard]] constexpr unsigned long long hilbertLut(const Table<std::uint16_t, HILBERT_LUT_SIZE<DIMS>> &lut,
+                                                      unsigned long long input) noexcept
+{
+    constexpr std::size_t lookups = HILBERT_LEVELS<DIMS> / HILBERT_LUT_LEVELS<DIMS>;
+    static_assert(lookups * HILBERT_LUT_LEVELS<DIMS> == HILBERT_LEVELS<DIMS>, "Levels must be divisible by lookups");
+    return hilbertLut_impl<DIMS>(std::make_index_sequence<lookups>{}, lut, input);
+}
+
+}  // namespace detail
+
+// MORTON CONVERSION ===================================================================================================
+
+/**
+ * @brief Converts a Morton code to the index of the same point on the Hilbert curve.
+ * For three dimensions, the uppermost bit of the Morton code is ignored.
+ * @tparam DIMS the number of dimensions, either 2 or 3
+ * @param code the Morton code, as obtained from ileave()
+ * @return the Hilbert index
+ */
+template <std::size_t DIMS>
+[[nodiscard]] constexpr unsigned long long mortonToHilbert(unsigned long long code) noexcept
+{
+    return detail::hilbertLut<DIMS>(detail::MORTON_TO_HILBERT_LUT<DIMS>, code);
+}
+
+/**
+ * @brief Converts a Hilbert index to the Morton code of the same point.
+ * For three dimensions, the uppermost bit of the Hilbert index is ignored.
+ * @tparam DIMS the number of dimensions, either 2 or 3
+ * @param index the Hilbert index
+ * @return the Morton code, which can be de-interleaved using dileave()
+ */
+template <std::size_t DIMS>
+[[nodiscard]] constexpr unsigned long long hilbertToMorton(unsigned long long index) noexcept
+{
+    return detail::hilbertLut<DIMS>(detail::HILBERT_TO_MORTON_LUT<DIMS>, index);
+}
+
+// HILBERT ENCODING ====================================================================================================
+
+namespace detail {
+
+/// Single-level state machine, one step per bit of each coordinate.
+template <std::size_t DIMS>
+[[nodiscard]] constexpr unsigned long long mortonToHilbert_naive(unsigned long long code) noexcept
+{
+    constexpr unsigned digitMask = (1u << DIMS) - 1;
+
+    unsigned long long result = 0;
+    unsigned state = 0;
+    for (unsigned level = HILBERT_LEVELS<DIMS>; level-- != 0;) {
+        const HilbertTransition t = hilbertTransition<DIMS>(state, (code >> (level * DIMS)) & digitMask);
+        result |= static_cast<unsigned long long>(t.digit) << (level * DIMS);
+        state = t.next;
+    }
+    return result;
+}
+
+/// Skilling's algorithm, which serves as the reference implementation. The coordinates are modified.
+template <std::size_t DIMS>
+[[nodiscard]] constexpr unsigned long long hilbertEncode_naive(std::uint32_t x[DIMS]) noexcept
+{
+    constexpr std::uint64_t top = std::uint64_t{1} << (HILBERT_LEVELS<DIMS> - 1);
+
+    for (std::size_t i = 0; i < DIMS; ++i) {
+        x[i] = static_cast<std::uint32_t>(x[i] & ((top << 1) - 1));
+    }
+    // inverse undo
+    for (std::uint64_t q = top; q > 1; q >>= 1) {
+        const auto p = static_cast<std::uint32_t>(q - 1);
+        for (std::size_t i = 0; i < DIMS; ++i) {
+            if (x[i] & q) {
+                x[0] ^= p;
+            }
+            else {
+                const std::uint32_t t = (x[0] ^ x[i]) & p;
+                x[0] ^= t;
+                x[i] ^= t;
+            }
+        }
+    }
+    // gray encode
+    for (std::size_t i = 1; i < DIMS; ++i) {
+        x[i] ^= x[i - 1];
+    }
+    std::uint32_t t = 0;
+    for (std::uint64_t q = top; q > 1; q >>= 1) {
+        if (x[DIMS - 1] & q) {
+            t ^= static_cast<std::uint32_t>(q - 1);
+        }
+    }
+    for (std::size_t i = 0; i < DIMS; ++i) {
+        x[i] ^= t;
+    }
+    return ileave_arr_impl(std::make_index_sequence<DIMS>{}, x);
+}
+
+/// Inverse of hilbertEncode_naive.
+template <std::size_t DIMS>
+constexpr void hilbertDecode_naive(unsigned long long index, std::uint32_t out[DIMS]) noexcept
+{
+    constexpr std::uint64_t end = std::uint64_t{1} << HILBERT_LEVELS<DIMS>;
+
+    dileave_arr_impl(std::make_index_sequence<DIMS>{}, index, out);
+    for (std::size_t i = 0; i < DIMS; ++i) {
+        out[i] = static_cast<std::uint32_t>(out[i] & (end - 1));
+    }
+    // gray decode
+    std::uint32_t t = out[DIMS - 1] >> 1;
+    for (std::size_t i = DIMS - 1; i > 0; --i) {
+        out[i] ^= out[i - 1];
+    }
+    out[0] ^= t;
+    // undo excess work
+    for (std::uint64_t q = 2; q != end; q <<= 1) {
+        const auto p = static_cast<std::uint32_t>(q - 1);
+        for (std::size_t i = DIMS; i-- != 0;) {
+            if (out[i] & q) {
+                out[0] ^= p;
+            }
+            else {
+                t = (out[0] ^ out[i]) & p;
+                out[0] ^= t;
+                out[i] ^= t;
+            }
+        }
+    }
+}
+
+}  // namespace detail
+
+/**
+ * @brief Computes the index of a point on the two-dimensional Hilbert curve.
+ * @param x the first coordinate
+ * @param y the second coordinate
+ * @return the Hilbert index
+ */
+[[nodiscard]] constexpr unsigned long long hilbertEncode(std::uint32_t x, std::uint32_t y) noexcept
+{
+    return mortonToHilbert<2>(ileave(x, y));
+}
+
+/**
+ * @brief Computes the index of a point on the three-dimensional Hilbert curve.
+ * Only the lower 21 bits of each coordinate are used.
+ * @param x the first coordinate
+ * @param y the second coordinate
+ * @param z the third coordinate
+ * @return the Hilbert index
+ */
+[[nodiscard]] constexpr unsigned long long hilbertEncode(std::uint32_t x, std::uint32_t y, std::uint32_t z) noexcept
+{
+    constexpr std::uint32_t mask = (std::uint32_t{1} << 21) - 1;
+    return mortonToHilbert<3>(ileave(x & mask, y & mask, z & mask));
+}
+
+// HILBERT DECODING ====================================================================================================
+
+/**
+ * @brief Computes the point at an index of the two-dimensional Hilbert curve.
+ * @param index the Hilbert index
+ * @param x receives the first coordinate
+ * @param y receives the second coordinate
+ */
+constexpr void hilbertDecode(unsigned long long index, std::uint32_t &x, std::uint32_t &y) noexcept
+{
+    dileave(hilbertToMorton<2>(index), x, y);
+}
+
+/**
+ * @brief Computes the point at an index of the three-dimensional Hilbert curve.
+ * The uppermost bit of the index is ignored.
+ * @param index the Hilbert index
+ * @param x receives the first coordinate
+ * @param y receives the second coordinate
+ * @param z receives the third coordinate
+ */
+constexpr void hilbertDecode(unsigned long long index, std::uint32_t &x, std::uint32_t &y, std::uint32_t &z) noexcept
+{
+    dileave(hilbertToMorton<3>(index), x, y, z);
+}
+
+// BATCH ENCODING ======================================================================================================
+
+namespace detail {
+
+/// The number of Morton codes which are buffered on the stack by the batch functions.
+inline constexpr std::size_t HILBERT_BATCH_CHUNK = 256;
+
+template <std::size_t DIMS>
+constexpr void mortonToHilbertBatch(unsigned long long codes[], std::size_t count) noexcept
+{
+    for (std::size_t i = 0; i < count; ++i) {
+        codes[i] = mortonToHilbert<DIMS>(codes[i]);
+    }
+}
+
+}  // namespace detail
+
+/**
+ * @brief Computes the Hilbert indices of count points which are stored as a structure of arrays.
+ * This is equivalent to out[i] = hilbertEncode(x[i], y[i]) for every i < count.
+ * The points are interleaved using ileaveBatch() and then converted in place.
+ * @param x the first coordinates
+ * @param y the second coordinates
+ * @param out the output Hilbert indices
+ * @param count the number of points
+ */
+constexpr void hilbertEncodeBatch(const std::uint32_t x[],
+                                  const std::uint32_t y[],
+                                  unsigned long long out[],
+                                  std::size_t count) noexcept
+{
+    ileaveBatch(x, y, out, count);
+    detail::mortonToHilbertBatch<2>(out, count);
+}
+
+/**
+ * @brief Computes the Hilbert indices of count points which are stored as a structure of arrays.
+ * This is equivalent to out[i] = hilbertEncode(x[i], y[i], z[i]) for every i < count.
+ * The points are interleaved using ileaveBatch() and then converted in place.
+ * @param x the first coordinates
+ * @param y the second coordinates
+ * @param z the third coordinates
+ * @param out the output Hilbert indices
+ * @param count the number of points
+ */
+constexpr void hilbertEncodeBatch(const std::uint32_t x[],
+                                  const std::uint32_t y[],
+                                  const std::uint32_t z[],
+                                  unsigned long long out[],
+                                  std::size_t count) noexcept
+{
+    // bits of x and y which exceed 21 bits are shifted out of the Morton code and those of z end up in the ignored
+    // uppermost bit, so no masking is necessary
+    ileaveBatch(x, y, z, out, count);
+    detail::mortonToHilbertBatch<3>(out, count);
+}
+
+// BATCH DECODING ======================================================================================================
+
+/**
+ * @brief Computes the points at count indices of the two-dimensional Hilbert curve.
+ * This is equivalent to hilbertDecode(indices[i], x[i], y[i]) for every i < count.
+ * The indices are converted to Morton codes in chunks, which are then de-interleaved using dileaveBatch().
+ * @param indices the Hilbert indices
+ * @param x receives the first coordinates
+ * @param y receives the second coordinates
+ * @param count the number of indices
+ */
+constexpr void hilbertDecodeBatch(const unsigned long long indices[],
+                                  std::uint32_t x[],
+                                  std::uint32_t y[],
+                                  std::size_t count) noexcept
+{
+    unsigned long long codes[detail::HILBERT_BATCH_CHUNK]{};
+    for (std::size_t i = 0; i < count; i += detail::HILBERT_BATCH_CHUNK) {
+        const std::size_t chunk = std::min(count - i, detail::HILBERT_BATCH_CHUNK);
+        for (std::size_t j = 0; j < chunk; ++j) {
+            codes[j] = hilbertToMorton<2>(indices[i + j]);
+        }
+        dileaveBatch(codes, x + i, y + i, chunk);
+    }
+}
+
+/**
+ * @brief Computes the points at count indices of the three-dimensional Hilbert curve.
+ * This is equivalent to hilbertDecode(indices[i], x[i], y[i], z[i]) for every i < count.
+ * The indices are converted to Morton codes in chunks, which are then de-interleaved using dileaveBatch().
+ * @param indices the Hilbert indices
+ * @param x receives the first coordinates
+ * @param y receives the second coordinates
+ * @param z receives the third coordinates
+ * @param count the number of indices
+ */
+constexpr void hilbertDecodeBatch(const unsigned long long indices[],
+                                  std::uint32_t x[],
+                                  std::uint32_t y[],
+                                  std::uint32_t z[],
+                                  std::size_t count) noexcept
+{
+    unsigned long long codes[detail::HILBERT_BATCH_CHUNK]{};
+    for (std::size_t i = 0; i < count; i += detail::HILBERT_BATCH_CHUNK) {
+        const std::size_t chunk = std::min(count - i, detail::HILBERT_BATCH_CHUNK);
+        for (std::size_t j = 0; j < chunk; ++j) {
+            codes[j] = hilbertToMorton<3>(indices[i + j]);
+        }
+        dileaveBatch(codes, x + i, y + i, z + i, chunk);
+    }
+}
+
+}  // namespace bitmanip
+
+#endif  // BITMANIP_HILBERT_HPP
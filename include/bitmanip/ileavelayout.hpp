@@ -0,0 +1,301 @@
+#ifndef BITMANIP_ILEAVELAYOUT_HPP
+#define BITMANIP_ILEAVELAYOUT_HPP
+/*
+ * ileavelayout.hpp
+ * -----------
+ * Provides interleaving with arbitrary, compile-time layouts, such as a different order of axes or a different number
+ * of bits per axis.
+ *
+ * A layout determines the mask of the bits of each axis at compile time.
+ * Interleaving then deposits the bits of each axis into its mask, which is a single pdep instruction if pdep is fast.
+ * Otherwise, the bits are moved into place using a shift cascade (see Hacker's Delight, 7-4 Compress, or Generalized
+ * Extract), whose masks are also computed at compile time and whose unnecessary steps are left out.
+ */
+
+#include "bitcount.hpp"
+#include "bitileave.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace bitmanip {
+
+// CONSTANT MASK DEPOSIT/EXTRACT =======================================================================================
+
+namespace detail {
+
+[[nodiscard]] constexpr std::uint64_t depositBits_naive(std::uint64_t input, std::uint64_t mask) noexcept
+{
+    std::uint64_t result = 0;
+    for (std::uint64_t bit = 1; mask != 0; bit <<= 1, mask &= mask - 1) {
+        if (input & bit) {
+            result |= isolateLsb(mask);
+        }
+    }
+    return result;
+}
+
+[[nodiscard]] constexpr std::uint64_t extractBits_naive(std::uint64_t input, std::uint64_t mask) noexcept
+{
+    std::uint64_t result = 0;
+    for (std::uint64_t bit = 1; mask != 0; bit <<= 1, mask &= mask - 1) {
+        if (input & isolateLsb(mask)) {
+            result |= bit;
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Computes the masks of the bits which are moved in each step of the shift cascade.
+ * In step i, the bits in moves[i] are moved by 2^i bits.
+ */
+[[nodiscard]] constexpr Table<std::uint64_t, 6> makeBitMoves(std::uint64_t mask) noexcept
+{
+    Table<std::uint64_t, 6> moves{};
+    // the parallel prefix XOR of mk has a 1-bit where an odd number of zeros of the mask lie to the right of it
+    std::uint64_t mk = ~mask << 1;
+    for (unsigned i = 0; i < 6; ++i) {
+        std::uint64_t mp = mk;
+        for (unsigned s = 1; s < 64; s <<= 1) {
+            mp ^= mp << s;
+        }
+        const std::uint64_t mv = mp & mask;
+        moves[i] = mv;
+        mask = (mask ^ mv) | (mv >> (1u << i));
+        mk &= ~mp;
+    }
+    return moves;
+}
+
+template <std::uint64_t MASK>
+inline constexpr Table<std::uint64_t, 6> BIT_MOVES = makeBitMoves(MASK);
+
+template <std::uint64_t MOVE, unsigned SHIFT>
+[[nodiscard]] constexpr std::uint64_t depositStep(std::uint64_t x) noexcept
+{
+    if constexpr (MOVE == 0) {
+        return x;
+    }
+    else {
+        return (x & ~MOVE) | ((x << SHIFT) & MOVE);
+    }
+}
+
+template <std::uint64_t MOVE, unsigned SHIFT>
+[[nodiscard]] constexpr std::uint64_t extractStep(std::uint64_t x) noexcept
+{
+    if constexpr (MOVE == 0) {
+        return x;
+    }
+    else {
+        const std::uint64_t t = x & MOVE;
+        return (x ^ t) | (t >> SHIFT);
+    }
+}
+
+// the steps are performed in reverse order for depositing
+template <std::uint64_t MASK, std::size_t... I>
+[[nodiscard]] constexpr std::uint64_t depositBits_shift_impl(std::index_sequence<I...>, std::uint64_t x) noexcept
+{
+    ((x = depositStep<BIT_MOVES<MASK>[5 - I], 1u << (5 - I)>(x)), ...);
+    return x & MASK;
+}
+
+template <std::uint64_t MASK, std::size_t... I>
+[[nodiscard]] constexpr std::uint64_t extractBits_shift_impl(std::index_sequence<I...>, std::uint64_t x) noexcept
+{
+    x &= MASK;
+    ((x = extractStep<BIT_MOVES<MASK>[I], 1u << I>(x)), ...);
+    return x;
+}
+
+}  // namespace detail
+
+/**
+ * @brief Deposits the lowest bits of the input into the bits of a constant mask, from the lowest to the highest.
+ * This is equivalent to the pdep instruction, which is chosen at runtime if the CPU implements it in hardware.
+ * Otherwise, a shift cascade with at most 6 steps is used.
+ * Example: depositBits_const<0b1010>(0b11) = 0b1010
+ * @tparam MASK the mask
+ * @param input the input number
+ */
+template <std::uint64_t MASK>
+[[nodiscard]] constexpr std::uint64_t depositBits_const(std::uint64_t input) noexcept
+{
+    if constexpr (MASK == 0) {
+        return 0;
+    }
+    else {
+#ifdef BITMANIP_HAS_BUILTIN_PDEP
+        if (not builtin::isconsteval() && CPU_FEATURES.fastPdep) {
+            return builtin::pdep(input, MASK);
+        }
+#endif
+        // the trailing zeros of the mask are a simple shift
+        constexpr unsigned shift = countTrailingZeros(MASK);
+        return detail::depositBits_shift_impl<(MASK >> shift)>(std::make_index_sequence<6>{}, input) << shift;
+    }
+}
+
+/**
+ * @brief Extracts the bits of a constant mask from the input into the lowest bits of the result.
+ * This is equivalent to the pext instruction, which is chosen at runtime if the CPU implements it in hardware.
+ * Otherwise, a shift cascade with at most 6 steps is used.
+ * Example: extractBits_const<0b1010>(0b1000) = 0b10
+ * @tparam MASK the mask
+ * @param input the input number
+ */
+template <std::uint64_t MASK>
+[[nodiscard]] constexpr std::uint64_t extractBits_const(std::uint64_t input) noexcept
+{
+    if constexpr (MASK == 0) {
+        return 0;
+    }
+    else {
+#ifdef BITMANIP_HAS_BUILTIN_PEXT
+        if (not builtin::isconsteval() && CPU_FEATURES.fastPdep) {
+            return builtin::pext(input, MASK);
+        }
+#endif
+        constexpr unsigned shift = countTrailingZeros(MASK);
+        return detail::extractBits_shift_impl<(MASK >> shift)>(std::make_index_sequence<6>{}, input >> shift);
+    }
+}
+
+// INTERLEAVE LAYOUTS ==================================================================================================
+
+namespace detail {
+
+template <std::size_t... AXES>
+[[nodiscard]] constexpr std::size_t ileaveLayoutAxisCount() noexcept
+{
+    std::size_t result = 0;
+    ((result = AXES + 1 > result ? AXES + 1 : result), ...);
+    return result;
+}
+
+template <std::size_t AXIS_COUNT, std::size_t... AXES>
+[[nodiscard]] constexpr Table<std::uint64_t, AXIS_COUNT> makeIleaveLayoutMasks() noexcept
+{
+    constexpr std::size_t period = sizeof...(AXES);
+    constexpr std::size_t axes[period]{AXES...};
+
+    Table<std::uint64_t, AXIS_COUNT> masks{};
+    for (std::size_t bit = 0; bit < 64; ++bit) {
+        masks[axes[period - 1 - bit % period]] |= std::uint64_t{1} << bit;
+    }
+    return masks;
+}
+
+template <std::size_t AXIS_COUNT, std::size_t... AXES>
+[[nodiscard]] constexpr bool isIleaveLayoutComplete() noexcept
+{
+    bool present[AXIS_COUNT]{};
+    ((present[AXES] = true), ...);
+    for (bool p : present) {
+        if (not p) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <std::size_t... AXES, std::size_t... I>
+[[nodiscard]] constexpr bool isIleaveLayoutSymmetric(std::index_sequence<I...>) noexcept
+{
+    return ((AXES == I) && ...);
+}
+
+}  // namespace detail
+
+/**
+ * @brief Describes the order of the bits of multiple axes in an interleaved number.
+ * AXES lists the axis of each bit within one period of the pattern, starting with the most significant bit.
+ * The pattern repeats from the least significant bit of the interleaved number upwards.
+ *
+ * For example, IleaveLayout<0, 1, 2> is the layout of ileave(x, y, z) and IleaveLayout<2, 1, 0> reverses the order
+ * of the axes.
+ * IleaveLayout<0, 1, 2, 2> interleaves two bits of z with every bit of x and y.
+ * @tparam AXES the axes, where every axis in [0, AXIS_COUNT) must occur at least once
+ */
+template <std::size_t... AXES>
+struct IleaveLayout {
+    static_assert(sizeof...(AXES) != 0 && sizeof...(AXES) <= 64, "A layout must have a period of 1 to 64 bits");
+
+    /// The number of axes, which is the number of interleaved numbers.
+    static constexpr std::size_t AXIS_COUNT = detail::ileaveLayoutAxisCount<AXES...>();
+    /// The number of bits after which the pattern repeats.
+    static constexpr std::size_t PERIOD = sizeof...(AXES);
+    /// The mask of the bits of each axis in the interleaved number.
+    static constexpr detail::Table<std::uint64_t, AXIS_COUNT> MASKS =
+        detail::makeIleaveLayoutMasks<AXIS_COUNT, AXES...>();
+    /// True if this is the layout of ileave() with AXIS_COUNT numbers.
+    static constexpr bool SYMMETRIC =
+        detail::isIleaveLayoutSymmetric<AXES...>(std::make_index_sequence<sizeof...(AXES)>{});
+
+    static_assert(detail::isIleaveLayoutComplete<AXIS_COUNT, AXES...>(), "Every axis must occur in the layout");
+};
+
+namespace detail {
+
+template <typename Layout, typename... Uint, std::size_t... I>
+[[nodiscard]] constexpr ull_type ileaveLayout_impl(std::index_sequence<I...>, Uint... args) noexcept
+{
+    return (depositBits_const<Layout::MASKS[I]>(args) | ...);
+}
+
+template <typename Layout, typename... Uint, std::size_t... I>
+constexpr void dileaveLayout_impl(std::index_sequence<I...>, ull_type n, Uint &... out) noexcept
+{
+    ((out = static_cast<Uint>(extractBits_const<Layout::MASKS[I]>(n))), ...);
+}
+
+}  // namespace detail
+
+/**
+ * @brief Interleaves integers using a layout.
+ * The lowest bits of each argument are deposited into the bits of its axis, the remaining bits are ignored.
+ * For symmetric layouts, this is equivalent to ileave(args...).
+ * Example: ileaveLayout<IleaveLayout<1, 0>>(x, y) = ileave(y, x)
+ * @tparam Layout the IleaveLayout
+ * @param args one number per axis, where the first number is axis 0
+ * @return the interleaved bits
+ */
+template <typename Layout, typename... Uint>
+[[nodiscard]] constexpr auto ileaveLayout(Uint... args) noexcept
+    -> std::enable_if_t<areUnsigned<Uint...>, unsigned long long>
+{
+    static_assert(sizeof...(Uint) == Layout::AXIS_COUNT, "There must be one number per axis");
+    if constexpr (Layout::SYMMETRIC && sizeof...(Uint) > 1) {
+        return ileave(args...);
+    }
+    else {
+        return detail::ileaveLayout_impl<Layout>(std::make_index_sequence<sizeof...(Uint)>{}, args...);
+    }
+}
+
+/**
+ * @brief Reverses ileaveLayout().
+ * Bits of an axis which don't fit into the corresponding output are discarded.
+ * @tparam Layout the IleaveLayout
+ * @param n the interleaved number
+ * @param out one number per axis, where the first number is axis 0
+ */
+template <typename Layout, typename... Uint>
+constexpr auto dileaveLayout(unsigned long long n, Uint &... out) noexcept
+    -> std::enable_if_t<areUnsigned<Uint...>, void>
+{
+    static_assert(sizeof...(Uint) == Layout::AXIS_COUNT, "There must be one number per axis");
+    if constexpr (Layout::SYMMETRIC && sizeof...(Uint) > 1) {
+        dileave(n, out...);
+    }
+    else {
+        detail::dileaveLayout_impl<Layout>(std::make_index_sequence<sizeof...(Uint)>{}, n, out...);
+    }
+}
+
+}  // namespace bitmanip
+
+#endif  // BITMANIP_ILEAVELAYOUT_HPP
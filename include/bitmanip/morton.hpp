@@ -0,0 +1,429 @@
+#ifndef BITMANIP_MORTON_HPP
+#define BITMANIP_MORTON_HPP
+/*
+ * morton.hpp
+ * -----------
+ * Provides arithmetic on Morton codes (see ileave() in bitileave.hpp) without de-interleaving them.
+ *
+ * The bits of each axis in a Morton code form a so called dilated integer.
+ * Dilated integers can be added by filling the gaps between their bits with ones, so that carries propagate through
+ * the bits of other axes, and then masking the other axes out again.
+ *
+ * Just like in ileave(), axis 0 is the axis of the first argument, which comprises the uppermost bits.
+ */
+
+#include "bitileave.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace bitmanip {
+
+// AXIS MASKS ==========================================================================================================
+
+/**
+ * @brief Returns the mask of all bits which belong to an axis of a Morton code.
+ * Example: mortonAxisMask<0, 2>() = 0b...1010
+ * @tparam AXIS the axis, where 0 is the axis of the uppermost bits
+ * @tparam DIMS the number of dimensions (interleaved numbers)
+ */
+template <std::size_t AXIS, std::size_t DIMS>
+[[nodiscard]] constexpr unsigned long long mortonAxisMask() noexcept
+{
+    static_assert(DIMS != 0 && AXIS < DIMS, "AXIS must be one of the DIMS axes");
+    return detail::ileaveZeros_naive(~std::uint32_t{0}, DIMS - 1) << (DIMS - 1 - AXIS);
+}
+
+// MORTON ARITHMETIC ===================================================================================================
+
+namespace detail {
+
+template <std::size_t DIMS, std::size_t... I>
+[[nodiscard]] constexpr unsigned long long mortonAdd_impl(std::index_sequence<I...>,
+                                                          unsigned long long a,
+                                                          unsigned long long b) noexcept
+{
+    return ((((a | ~mortonAxisMask<I, DIMS>()) + (b & mortonAxisMask<I, DIMS>())) & mortonAxisMask<I, DIMS>()) | ...);
+}
+
+template <std::size_t DIMS, std::size_t... I>
+[[nodiscard]] constexpr unsigned long long mortonSub_impl(std::index_sequence<I...>,
+                                                          unsigned long long a,
+                                                          unsigned long long b) noexcept
+{
+    return ((((a & mortonAxisMask<I, DIMS>()) - (b & mortonAxisMask<I, DIMS>())) & mortonAxisMask<I, DIMS>()) | ...);
+}
+
+}  // namespace detail
+
+/**
+ * @brief Adds two Morton codes axis by axis.
+ * This is equivalent to de-interleaving both codes, adding each pair of coordinates and interleaving the sums, but
+ * without de-interleaving and interleaving.
+ * Each coordinate wraps around on overflow.
+ * @tparam DIMS the number of dimensions
+ * @param a the first summand
+ * @param b the second summand
+ * @return the Morton code of the sum
+ */
+template <std::size_t DIMS>
+[[nodiscard]] constexpr unsigned long long mortonAdd(unsigned long long a, unsigned long long b) noexcept
+{
+    return detail::mortonAdd_impl<DIMS>(std::make_index_sequence<DIMS>{}, a, b);
+}
+
+/**
+ * @brief Subtracts two Morton codes axis by axis.
+ * Each coordinate wraps around on underflow.
+ * @tparam DIMS the number of dimensions
+ * @param a the minuend
+ * @param b the subtrahend
+ * @return the Morton code of the difference
+ */
+template <std::size_t DIMS>
+[[nodiscard]] constexpr unsigned long long mortonSub(unsigned long long a, unsigned long long b) noexcept
+{
+    return detail::mortonSub_impl<DIMS>(std::make_index_sequence<DIMS>{}, a, b);
+}
+
+/**
+ * @brief Increments a single coordinate of a Morton code.
+ * The coordinate wraps around on overflow, the other coordinates are not affected.
+ * Example: mortonIncAxis<1, 2>(ileave(x, y)) = ileave(x, y + 1)
+ * @tparam AXIS the axis to increment
+ * @tparam DIMS the number of dimensions
+ * @param code the Morton code
+ */
+template <std::size_t AXIS, std::size_t DIMS>
+[[nodiscard]] constexpr unsigned long long mortonIncAxis(unsigned long long code) noexcept
+{
+    constexpr unsigned long long mask = mortonAxisMask<AXIS, DIMS>();
+    constexpr unsigned long long one = isolateLsb(mask);
+
+    return (((code | ~mask) + one) & mask) | (code & ~mask);
+}
+
+/**
+ * @brief Decrements a single coordinate of a Morton code.
+ * The coordinate wraps around on underflow, the other coordinates are not affected.
+ * Example: mortonDecAxis<0, 2>(ileave(x, y)) = ileave(x - 1, y)
+ * @tparam AXIS the axis to decrement
+ * @tparam DIMS the number of dimensions
+ * @param code the Morton code
+ */
+template <std::size_t AXIS, std::size_t DIMS>
+[[nodiscard]] constexpr unsigned long long mortonDecAxis(unsigned long long code) noexcept
+{
+    constexpr unsigned long long mask = mortonAxisMask<AXIS, DIMS>();
+    constexpr unsigned long long one = isolateLsb(mask);
+
+    return (((code & mask) - one) & mask) | (code & ~mask);
+}
+
+// RANGE QUERIES =======================================================================================================
+
+namespace detail {
+
+template <std::size_t DIMS, std::size_t... I>
+[[nodiscard]] constexpr bool mortonInBox_impl(std::index_sequence<I...>,
+                                              unsigned long long code,
+                                              unsigned long long min,
+                                              unsigned long long max) noexcept
+{
+    // dilated integers of the same axis can be compared directly after masking out the other axes
+    return (((code & mortonAxisMask<I, DIMS>()) >= (min & mortonAxisMask<I, DIMS>()) &&
+             (code & mortonAxisMask<I, DIMS>()) <= (max & mortonAxisMask<I, DIMS>())) &&
+            ...);
+}
+
+template <std::size_t DIMS, std::size_t... I>
+[[nodiscard]] constexpr unsigned long long mortonAxisMaskOfBit_impl(std::index_sequence<I...>, unsigned bit) noexcept
+{
+    return ((bit % DIMS == DIMS - 1 - I ? mortonAxisMask<I, DIMS>() : 0) | ...);
+}
+
+/// Returns the mask of the axis which the given bit of a Morton code belongs to.
+template <std::size_t DIMS>
+[[nodiscard]] constexpr unsigned long long mortonAxisMaskOfBit(unsigned bit) noexcept
+{
+    return detail::mortonAxisMaskOfBit_impl<DIMS>(std::make_index_sequence<DIMS>{}, bit);
+}
+
+/// Sets the bit to 1 and all lower bits of the same axis to 0 ("load 1000" in the literature).
+template <std::size_t DIMS>
+[[nodiscard]] constexpr unsigned long long mortonLoadMin(unsigned long long code, unsigned bit) noexcept
+{
+    const unsigned long long single = 1ull << bit;
+    const unsigned long long lower = mortonAxisMaskOfBit<DIMS>(bit) & (single - 1);
+    return (code & ~lower) | single;
+}
+
+/// Sets the bit to 0 and all lower bits of the same axis to 1 ("load 0111" in the literature).
+template <std::size_t DIMS>
+[[nodiscard]] constexpr unsigned long long mortonLoadMax(unsigned long long code, unsigned bit) noexcept
+{
+    const unsigned long long single = 1ull << bit;
+    const unsigned long long lower = mortonAxisMaskOfBit<DIMS>(bit) & (single - 1);
+    return (code & ~single) | lower;
+}
+
+}  // namespace detail
+
+/**
+ * @brief Returns whether a Morton code lies within an axis-aligned box.
+ * @tparam DIMS the number of dimensions
+ * @param code the Morton code to test
+ * @param min the Morton code of the minimum corner of the box (inclusive)
+ * @param max the Morton code of the maximum corner of the box (inclusive)
+ */
+template <std::size_t DIMS>
+[[nodiscard]] constexpr bool mortonInBox(unsigned long long code,
+                                         unsigned long long min,
+                                         unsigned long long max) noexcept
+{
+    return detail::mortonInBox_impl<DIMS>(std::make_index_sequence<DIMS>{}, code, min, max);
+}
+
+/**
+ * @brief Finds the smallest Morton code which is greater than or equal to code and lies within a box.
+ * This is known as BIGMIN in the literature (Tropf, Herzog: Multidimensional Range Search in Dynamically Balanced
+ * Trees, 1981).
+ * When scanning a sorted array of Morton codes, this allows skipping all codes which lie outside of the box.
+ * @tparam DIMS the number of dimensions
+ * @param code the Morton code to start at
+ * @param min the Morton code of the minimum corner of the box (inclusive)
+ * @param max the Morton code of the maximum corner of the box (inclusive)
+ * @param out receives the result, if any
+ * @return true if there is such a code, false if code is greater than every code in the box
+ */
+template <std::size_t DIMS>
+[[nodiscard]] constexpr bool mortonNextInBox(unsigned long long code,
+                                             unsigned long long min,
+                                             unsigned long long max,
+                                             unsigned long long &out) noexcept
+{
+    if (mortonInBox<DIMS>(code, min, max)) {
+        out = code;
+        return true;
+    }
+
+    bool found = false;
+    for (unsigned bit = 64; bit-- != 0;) {
+        const unsigned selector = (((code >> bit) & 1) << 2) | (((min >> bit) & 1) << 1) | ((max >> bit) & 1);
+        switch (selector) {
+        case 0b001:
+            out = detail::mortonLoadMin<DIMS>(min, bit);
+            found = true;
+            max = detail::mortonLoadMax<DIMS>(max, bit);
+            break;
+        case 0b011: out = min; return true;
+        case 0b100: return found;
+        case 0b101: min = detail::mortonLoadMin<DIMS>(min, bit); break;
+        // 0b010 and 0b110 are impossible for min <= max; 0b000 and 0b111 don't affect the result
+        default: break;
+        }
+    }
+    return found;
+}
+
+/**
+ * @brief Finds the greatest Morton code which is less than or equal to code and lies within a box.
+ * This is known as LITMAX in the literature and is the counterpart of mortonNextInBox for descending scans.
+ * @tparam DIMS the number of dimensions
+ * @param code the Morton code to start at
+ * @param min the Morton code of the minimum corner of the box (inclusive)
+ * @param max the Morton code of the maximum corner of the box (inclusive)
+ * @param out receives the result, if any
+ * @return true if there is such a code, false if code is less than every code in the box
+ */
+template <std::size_t DIMS>
+[[nodiscard]] constexpr bool mortonPrevInBox(unsigned long long code,
+                                             unsigned long long min,
+                                             unsigned long long max,
+                                             unsigned long long &out) noexcept
+{
+    if (mortonInBox<DIMS>(code, min, max)) {
+        out = code;
+        return true;
+    }
+
+    bool found = false;
+    for (unsigned bit = 64; bit-- != 0;) {
+        const unsigned selector = (((code >> bit) & 1) << 2) | (((min >> bit) & 1) << 1) | ((max >> bit) & 1);
+        switch (selector) {
+        case 0b001: max = detail::mortonLoadMax<DIMS>(max, bit); break;
+        case 0b011: return found;
+        case 0b100: out = max; return true;
+        case 0b101:
+            out = detail::mortonLoadMax<DIMS>(max, bit);
+            found = true;
+            min = detail::mortonLoadMin<DIMS>(min, bit);
+            break;
+        default: break;
+        }
+    }
+    return found;
+}
+
+// NEIGHBORS ===========================================================================================================
+
+/// The neighbors of a cell which are enumerated by mortonNeighbors().
+enum class MortonStencil {
+    /// The 2 * DIMS neighbors which share a face with the cell, e.g. 6 neighbors in 3D.
+    FACES,
+    /// The 3^DIMS - 1 neighbors which share at least a corner with the cell, e.g. 26 neighbors in 3D.
+    FULL
+};
+
+namespace detail {
+
+[[nodiscard]] constexpr std::size_t pow3(std::size_t exponent) noexcept
+{
+    return exponent == 0 ? 1 : 3 * pow3(exponent - 1);
+}
+
+template <std::size_t DIMS, std::size_t... I>
+[[nodiscard]] constexpr Table<unsigned long long, DIMS> makeMortonAxisMasks(std::index_sequence<I...>) noexcept
+{
+    return {mortonAxisMask<I, DIMS>()...};
+}
+
+template <std::size_t DIMS>
+inline constexpr Table<unsigned long long, DIMS> MORTON_AXIS_MASKS =
+    makeMortonAxisMasks<DIMS>(std::make_index_sequence<DIMS>{});
+
+/// Returns the neighbor with index K in the full stencil, whose base-3 digits select the part of each axis.
+template <std::size_t DIMS, std::size_t K, std::size_t... I>
+[[nodiscard]] constexpr unsigned long long mortonStencilNeighbor(std::index_sequence<I...>,
+                                                                 const unsigned long long parts[][3]) noexcept
+{
+    return (parts[I][K / pow3(DIMS - 1 - I) % 3] | ...);
+}
+
+// the neighbors are unrolled using fold expressions, so that all indices are constant
+template <std::size_t DIMS, std::size_t... K>
+constexpr void mortonStencilNeighbors(std::index_sequence<K...>,
+                                      const unsigned long long parts[][3],
+                                      unsigned long long out[]) noexcept
+{
+    constexpr std::size_t center = pow3(DIMS) / 2;
+    ((out[K] = mortonStencilNeighbor<DIMS, K < center ? K : K + 1>(std::make_index_sequence<DIMS>{}, parts)), ...);
+}
+
+/// Bit k of the mask at index (i * 3 + d) is set if base-3 digit i of k is d, where digit 0 is the most significant.
+template <std::size_t DIMS>
+[[nodiscard]] constexpr Table<unsigned long long, DIMS * 3> makeMortonStencilDigitMasks() noexcept
+{
+    Table<unsigned long long, DIMS * 3> result{};
+    for (std::size_t k = 0; k < pow3(DIMS) && k < 64; ++k) {
+        for (std::size_t i = DIMS, digits = k; i-- != 0; digits /= 3) {
+            result[i * 3 + digits % 3] |= 1ull << k;
+        }
+    }
+    return result;
+}
+
+template <std::size_t DIMS>
+inline constexpr Table<unsigned long long, DIMS * 3> MORTON_STENCIL_DIGIT_MASKS = makeMortonStencilDigitMasks<DIMS>();
+
+}  // namespace detail
+
+/// The number of neighbors in a stencil.
+template <std::size_t DIMS, MortonStencil STENCIL>
+inline constexpr std::size_t MORTON_STENCIL_SIZE = STENCIL == MortonStencil::FACES ? 2 * DIMS : detail::pow3(DIMS) - 1;
+
+/**
+ * @brief Computes the Morton codes of the neighbors of a cell without de-interleaving and interleaving them.
+ * Each coordinate of a neighbor is obtained from the code using the masked carry and borrow of mortonIncAxis() and
+ * mortonDecAxis().
+ *
+ * For FACES, out[2 * i] is the neighbor one step back along axis i and out[2 * i + 1] the one a step further.
+ * For FULL, the neighbors are in lexicographic order of their offsets in {-1, 0, 1}^DIMS, where axis 0 comprises the
+ * most significant digit and the cell itself is left out.
+ * In 3D, out[0] has the offsets (-1, -1, -1), out[12] has (0, 0, -1) and out[25] has (1, 1, 1).
+ *
+ * Neighbors outside of the box [0, max] still have their code written to out, where the coordinate has wrapped around.
+ * @tparam DIMS the number of dimensions
+ * @tparam STENCIL the neighbors to enumerate
+ * @param code the Morton code of the cell, which must lie within the box
+ * @param max the Morton code of the maximum corner of the box (inclusive)
+ * @param out receives MORTON_STENCIL_SIZE<DIMS, STENCIL> neighbor codes
+ * @return a mask where bit i is set if out[i] lies within the box
+ */
+template <std::size_t DIMS, MortonStencil STENCIL = MortonStencil::FULL>
+constexpr unsigned long long mortonNeighbors(unsigned long long code,
+                                             unsigned long long max,
+                                             unsigned long long out[]) noexcept
+{
+    static_assert(MORTON_STENCIL_SIZE<DIMS, STENCIL> <= 64, "The validity of each neighbor must fit into the result");
+
+    // the bits of each axis of the neighbor one step back, of the cell itself and of the neighbor one step further
+    unsigned long long parts[DIMS][3]{};
+    bool valid[DIMS][3]{};
+    for (std::size_t i = 0; i < DIMS; ++i) {
+        const unsigned long long mask = detail::MORTON_AXIS_MASKS<DIMS>[i];
+        const unsigned long long one = isolateLsb(mask);
+        parts[i][0] = ((code & mask) - one) & mask;
+        parts[i][1] = code & mask;
+        parts[i][2] = ((code | ~mask) + one) & mask;
+        valid[i][0] = (code & mask) != 0;
+        valid[i][1] = true;
+        valid[i][2] = (code & mask) != (max & mask);
+    }
+
+    unsigned long long result = 0;
+    if constexpr (STENCIL == MortonStencil::FACES) {
+        for (std::size_t i = 0; i < DIMS; ++i) {
+            const unsigned long long others = code & ~detail::MORTON_AXIS_MASKS<DIMS>[i];
+            out[2 * i + 0] = others | parts[i][0];
+            out[2 * i + 1] = others | parts[i][2];
+            result |= static_cast<unsigned long long>(valid[i][0]) << (2 * i + 0);
+            result |= static_cast<unsigned long long>(valid[i][2]) << (2 * i + 1);
+        }
+    }
+    else {
+        constexpr std::size_t cells = detail::pow3(DIMS);
+        constexpr std::size_t center = cells / 2;
+
+        unsigned long long inside = (1ull << cells) - 1;
+        for (std::size_t i = 0; i < DIMS; ++i) {
+            for (std::size_t d = 0; d < 3; d += 2) {
+                if (not valid[i][d]) {
+                    inside &= ~detail::MORTON_STENCIL_DIGIT_MASKS<DIMS>[i * 3 + d];
+                }
+            }
+        }
+        detail::mortonStencilNeighbors<DIMS>(std::make_index_sequence<cells - 1>{}, parts, out);
+
+        constexpr unsigned long long below = (1ull << center) - 1;
+        result = (inside & below) | ((inside >> 1) & ~below);
+    }
+    return result;
+}
+
+/**
+ * @brief Computes the neighbors of multiple cells.
+ * This is equivalent to masks[i] = mortonNeighbors<DIMS, STENCIL>(codes[i], max, out + i * N) for every i < count,
+ * where N is MORTON_STENCIL_SIZE<DIMS, STENCIL>.
+ * @param codes the Morton codes of the cells
+ * @param max the Morton code of the maximum corner of the box (inclusive)
+ * @param out receives count * N neighbor codes
+ * @param masks receives the validity mask of each cell, see mortonNeighbors()
+ * @param count the number of cells
+ */
+template <std::size_t DIMS, MortonStencil STENCIL = MortonStencil::FULL>
+constexpr void mortonNeighborsBatch(const unsigned long long codes[],
+                                    unsigned long long max,
+                                    unsigned long long out[],
+                                    unsigned long long masks[],
+                                    std::size_t count) noexcept
+{
+    constexpr std::size_t size = MORTON_STENCIL_SIZE<DIMS, STENCIL>;
+    for (std::size_t i = 0; i < count; ++i) {
+        masks[i] = mortonNeighbors<DIMS, STENCIL>(codes[i], max, out + i * size);
+    }
+}
+
+}  // namespace bitmanip
+
+#endif  // BITMANIP_MORTON_HPP
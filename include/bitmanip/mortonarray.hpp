@@ -0,0 +1,197 @@
+#ifndef BITMANIP_MORTONARRAY_HPP
+#define BITMANIP_MORTONARRAY_HPP
+/*
+ * mortonarray.hpp
+ * -----------
+ * Provides a dense 3D array which stores its elements in Z-order (see ileave() in bitileave.hpp).
+ *
+ * Elements which are close to each other in space are mostly close to each other in memory, regardless of the axis
+ * along which they are neighbors.
+ * This makes stencils, which access the neighbors of each element, much more cache-friendly than with a row-major
+ * layout, where neighbors along the outermost axis are a whole slice apart.
+ */
+
+#include "bitileave.hpp"
+#include "morton.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace bitmanip {
+
+/**
+ * @brief A dense cube of SIZE x SIZE x SIZE elements, stored in Z-order.
+ * Just like in ileave(), x comprises the uppermost bits of each index, so the elements are stored in the same order as
+ * in a row-major array[x][y][z] of blocks of 2x2x2 elements.
+ * @tparam T the element type
+ * @tparam LOG2_SIZE the binary logarithm of the size along each axis
+ */
+template <typename T, unsigned LOG2_SIZE>
+class MortonArray3 {
+    static_assert(LOG2_SIZE <= 21, "Morton codes of three coordinates can only have 21 bits per coordinate");
+
+public:
+    using valueType = T;
+
+    /// The number of elements along each axis.
+    static constexpr std::size_t SIZE = std::size_t{1} << LOG2_SIZE;
+    /// The total number of elements.
+    static constexpr std::size_t VOLUME = SIZE * SIZE * SIZE;
+
+    /// Returns the index of the element at (x, y, z), where each coordinate must be less than SIZE.
+    [[nodiscard]] static constexpr std::size_t indexOf(std::uint32_t x, std::uint32_t y, std::uint32_t z) noexcept
+    {
+        return static_cast<std::size_t>(ileave(x, y, z));
+    }
+
+    /// Stores the coordinates of the element at an index in x, y and z.
+    static constexpr void coordinatesOf(std::size_t index,
+                                        std::uint32_t &x,
+                                        std::uint32_t &y,
+                                        std::uint32_t &z) noexcept
+    {
+        dileave(index, x, y, z);
+    }
+
+    /**
+     * @brief Returns the index of the neighbor one step further along an axis.
+     * The coordinate wraps around at SIZE, the other coordinates are not affected.
+     * Example: next<2>(indexOf(x, y, z)) = indexOf(x, y, (z + 1) % SIZE)
+     * @tparam AXIS the axis, where 0 is x, 1 is y and 2 is z
+     * @param index the index of the element
+     */
+    template <std::size_t AXIS>
+    [[nodiscard]] static constexpr std::size_t next(std::size_t index) noexcept
+    {
+        return static_cast<std::size_t>(mortonIncAxis<AXIS, 3>(index)) & (VOLUME - 1);
+    }
+
+    /**
+     * @brief Returns the index of the neighbor one step back along an axis.
+     * The coordinate wraps around at zero, the other coordinates are not affected.
+     * @tparam AXIS the axis, where 0 is x, 1 is y and 2 is z
+     * @param index the index of the element
+     */
+    template <std::size_t AXIS>
+    [[nodiscard]] static constexpr std::size_t prev(std::size_t index) noexcept
+    {
+        return static_cast<std::size_t>(mortonDecAxis<AXIS, 3>(index)) & (VOLUME - 1);
+    }
+
+private:
+    std::vector<T> data_;
+
+public:
+    /// Constructs the array with value-initialized elements.
+    MortonArray3() : data_(VOLUME) {}
+
+    /// Constructs the array with copies of value.
+    explicit MortonArray3(const T &value) : data_(VOLUME, value) {}
+
+    T &operator()(std::uint32_t x, std::uint32_t y, std::uint32_t z) noexcept
+    {
+        return data_[indexOf(x, y, z)];
+    }
+
+    const T &operator()(std::uint32_t x, std::uint32_t y, std::uint32_t z) const noexcept
+    {
+        return data_[indexOf(x, y, z)];
+    }
+
+    /// Returns the element at an index, such as one obtained from indexOf(), next() or prev().
+    T &operator[](std::size_t index) noexcept
+    {
+        return data_[index];
+    }
+
+    const T &operator[](std::size_t index) const noexcept
+    {
+        return data_[index];
+    }
+
+    T *data() noexcept
+    {
+        return data_.data();
+    }
+
+    const T *data() const noexcept
+    {
+        return data_.data();
+    }
+
+    constexpr std::size_t size() const noexcept
+    {
+        return VOLUME;
+    }
+
+    T *begin() noexcept
+    {
+        return data_.data();
+    }
+
+    T *end() noexcept
+    {
+        return data_.data() + VOLUME;
+    }
+
+    const T *begin() const noexcept
+    {
+        return data_.data();
+    }
+
+    const T *end() const noexcept
+    {
+        return data_.data() + VOLUME;
+    }
+
+    /**
+     * @brief Copies all elements from a row-major array.
+     * This is equivalent to (*this)(x, y, z) = src[(x * SIZE + y) * SIZE + z] for every x, y, z < SIZE.
+     * The indices are computed by incrementing the Morton code axis by axis instead of interleaving each coordinate.
+     * @param src the row-major array of VOLUME elements
+     */
+    void fromRowMajor(const T src[])
+    {
+        forEachRowMajor([this, src](std::size_t rowMajor, std::size_t index) {
+            data_[index] = src[rowMajor];
+        });
+    }
+
+    /**
+     * @brief Copies all elements into a row-major array.
+     * This is equivalent to dst[(x * SIZE + y) * SIZE + z] = (*this)(x, y, z) for every x, y, z < SIZE.
+     * @param dst the row-major array of VOLUME elements
+     */
+    void toRowMajor(T dst[]) const
+    {
+        forEachRowMajor([this, dst](std::size_t rowMajor, std::size_t index) {
+            dst[rowMajor] = data_[index];
+        });
+    }
+
+private:
+    /// Invokes f(rowMajorIndex, mortonIndex) for every element in row-major order.
+    template <typename F>
+    static void forEachRowMajor(F f)
+    {
+        std::size_t rowMajor = 0;
+        std::size_t xy = 0;
+        for (std::size_t x = 0; x < SIZE; ++x) {
+            for (std::size_t y = 0; y < SIZE; ++y) {
+                std::size_t index = xy;
+                for (std::size_t z = 0; z < SIZE; ++z) {
+                    f(rowMajor++, index);
+                    index = next<2>(index);
+                }
+                xy = next<1>(xy);
+            }
+            // y has wrapped around to zero
+            xy = next<0>(xy);
+        }
+    }
+};
+
+}  // namespace bitmanip
+
+#endif  // BITMANIP_MORTONARRAY_HPP
@@ -0,0 +1,198 @@
+#ifndef BITMANIP_MORTONSORT_HPP
+#define BITMANIP_MORTONSORT_HPP
+/*
+ * mortonsort.hpp
+ * -----------
+ * Provides sorting of points into Z-order (see ileave() in bitileave.hpp).
+ *
+ * The points are interleaved into Morton codes and sorted using an LSD radix sort with one byte per pass.
+ * Interleaving is fused with the histogram pass, which computes the histograms for all passes at once.
+ * Passes in which all keys have the same byte are skipped, which is very common because the upper bytes of Morton codes
+ * are zero unless the coordinates use their full range.
+ */
+
+#include "bitileave.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace bitmanip {
+
+/// A Morton code and the index of the point it was computed from.
+struct MortonSortEntry {
+    unsigned long long key;
+    std::size_t index;
+};
+
+namespace detail {
+
+inline constexpr unsigned MORTON_SORT_RADIX_BITS = 8;
+inline constexpr std::size_t MORTON_SORT_BUCKETS = std::size_t{1} << MORTON_SORT_RADIX_BITS;
+inline constexpr unsigned MORTON_SORT_PASSES = 64 / MORTON_SORT_RADIX_BITS;
+/// The number of points which are interleaved at once using ileaveBatch().
+inline constexpr std::size_t MORTON_SORT_CHUNK = 256;
+
+/// Histograms of every byte of the keys, for all passes.
+struct MortonSortHistogram {
+    std::size_t counts[MORTON_SORT_PASSES][MORTON_SORT_BUCKETS];
+};
+
+inline void mortonSortCount(unsigned long long key, MortonSortHistogram &histogram) noexcept
+{
+    for (unsigned pass = 0; pass < MORTON_SORT_PASSES; ++pass) {
+        ++histogram.counts[pass][(key >> (pass * MORTON_SORT_RADIX_BITS)) & (MORTON_SORT_BUCKETS - 1)];
+    }
+}
+
+/// Interleaves the points in [begin, end) into out and adds their bytes to the histogram.
+template <std::size_t DIMS, typename Uint>
+void mortonSortEncode(const Uint points[],
+                      MortonSortEntry out[],
+                      std::size_t begin,
+                      std::size_t end,
+                      MortonSortHistogram &histogram) noexcept
+{
+    unsigned long long keys[MORTON_SORT_CHUNK];
+    for (std::size_t i = begin; i < end; i += MORTON_SORT_CHUNK) {
+        const std::size_t chunk = std::min(end - i, MORTON_SORT_CHUNK);
+        ileaveBatch<DIMS>(points + i * DIMS, keys, chunk);
+        for (std::size_t j = 0; j < chunk; ++j) {
+            out[i + j] = {keys[j], i + j};
+            mortonSortCount(keys[j], histogram);
+        }
+    }
+}
+
+/**
+ * @brief Performs the scatter passes of the radix sort.
+ * @return either data or scratch, depending on which one holds the sorted entries
+ */
+inline MortonSortEntry *mortonSortScatter(MortonSortEntry data[],
+                                          MortonSortEntry scratch[],
+                                          std::size_t count,
+                                          const MortonSortHistogram &histogram) noexcept
+{
+    if (count == 0) {
+        return data;
+    }
+    for (unsigned pass = 0; pass < MORTON_SORT_PASSES; ++pass) {
+        const unsigned shift = pass * MORTON_SORT_RADIX_BITS;
+        const std::size_t *const counts = histogram.counts[pass];
+
+        // if every key has the same byte, the pass wouldn't change the order
+        if (counts[(data[0].key >> shift) & (MORTON_SORT_BUCKETS - 1)] == count) {
+            continue;
+        }
+
+        std::size_t offsets[MORTON_SORT_BUCKETS];
+        std::size_t sum = 0;
+        for (std::size_t b = 0; b < MORTON_SORT_BUCKETS; ++b) {
+            offsets[b] = sum;
+            sum += counts[b];
+        }
+        for (std::size_t i = 0; i < count; ++i) {
+            scratch[offsets[(data[i].key >> shift) & (MORTON_SORT_BUCKETS - 1)]++] = data[i];
+        }
+        std::swap(data, scratch);
+    }
+    return data;
+}
+
+}  // namespace detail
+
+/**
+ * @brief Sorts entries by their key using an LSD radix sort.
+ * The sort is stable, so entries with equal keys keep their relative order.
+ * @param entries the entries to sort
+ * @param scratch a buffer of at least count entries, whose contents are overwritten
+ * @param count the number of entries
+ */
+inline void mortonRadixSort(MortonSortEntry entries[], MortonSortEntry scratch[], std::size_t count) noexcept
+{
+    detail::MortonSortHistogram histogram{};
+    for (std::size_t i = 0; i < count; ++i) {
+        detail::mortonSortCount(entries[i].key, histogram);
+    }
+    const MortonSortEntry *const sorted = detail::mortonSortScatter(entries, scratch, count, histogram);
+    if (sorted != entries) {
+        std::copy(sorted, sorted + count, entries);
+    }
+}
+
+/**
+ * @brief Sorts points into Z-order.
+ * This is equivalent to out[i] = {ileave<DIMS>(points + i * DIMS), i} for every i < count, followed by a stable sort of
+ * out by key.
+ *
+ * The points are interleaved using ileaveBatch() while the histograms are computed.
+ * If threadCount is greater than one, this pass is split evenly across multiple threads.
+ * The scatter passes are always performed on the calling thread.
+ *
+ * @tparam DIMS the number of coordinates per point
+ * @param points the points, where the first coordinate of each point comprises the highest bits
+ * @param count the number of points
+ * @param out receives the sorted keys and the indices of their points
+ * @param scratch a buffer of at least count entries, whose contents are overwritten
+ * @param threadCount the number of threads for the histogram pass, where 0 and 1 mean the calling thread only
+ * @throws std::system_error if a thread can't be started
+ */
+template <std::size_t DIMS, typename Uint>
+auto mortonSort(const Uint points[],
+                std::size_t count,
+                MortonSortEntry out[],
+                MortonSortEntry scratch[],
+                unsigned threadCount = 1) -> std::enable_if_t<areUnsigned<Uint>, void>
+{
+    detail::MortonSortHistogram histogram{};
+
+    if (threadCount <= 1 || count < threadCount * detail::MORTON_SORT_CHUNK) {
+        detail::mortonSortEncode<DIMS>(points, out, 0, count, histogram);
+    }
+    else {
+        std::vector<detail::MortonSortHistogram> histograms(threadCount);
+        std::vector<std::thread> threads;
+        threads.reserve(threadCount - 1);
+
+        const auto begin = [count, threadCount](unsigned t) -> std::size_t {
+            return count * t / threadCount;
+        };
+        // the calling thread takes the first range itself
+        try {
+            for (unsigned t = 1; t < threadCount; ++t) {
+                threads.emplace_back([&, t] {
+                    detail::mortonSortEncode<DIMS>(points, out, begin(t), begin(t + 1), histograms[t]);
+                });
+            }
+        }
+        catch (...) {
+            for (std::thread &thread : threads) {
+                thread.join();
+            }
+            throw;
+        }
+        detail::mortonSortEncode<DIMS>(points, out, 0, begin(1), histograms[0]);
+        for (std::thread &thread : threads) {
+            thread.join();
+        }
+
+        for (const detail::MortonSortHistogram &h : histograms) {
+            for (unsigned pass = 0; pass < detail::MORTON_SORT_PASSES; ++pass) {
+                for (std::size_t b = 0; b < detail::MORTON_SORT_BUCKETS; ++b) {
+                    histogram.counts[pass][b] += h.counts[pass][b];
+                }
+            }
+        }
+    }
+
+    const MortonSortEntry *const sorted = detail::mortonSortScatter(out, scratch, count, histogram);
+    if (sorted != out) {
+        std::copy(sorted, sorted + count, out);
+    }
+}
+
+}  // namespace bitmanip
+
+#endif  // BITMANIP_MORTONSORT_HPP
@@ -0,0 +1,283 @@
+#ifndef BITMANIP_MORTONTREE_HPP
+#define BITMANIP_MORTONTREE_HPP
+/*
+ * mortontree.hpp
+ * -----------
+ * Provides linear quadtrees, octrees and their higher-dimensional counterparts over sorted Morton codes (see ileave()
+ * in bitileave.hpp).
+ *
+ * Every node is a cube of space whose Morton codes share a common prefix of DIMS bits per level.
+ * A node is identified by its node key, which is this prefix with an additional 1-bit above it, so that nodes on
+ * different levels have different keys.
+ * The root has the key 1 and the children of a node with key k have the keys (k << DIMS) | i for i < 2^DIMS.
+ *
+ * Because sorted Morton codes are in depth-first order, the points in every node form a contiguous range and a tree
+ * can be built in a single pass over the codes.
+ * Two neighboring codes belong to different children of a node exactly when their common prefix ends on its level,
+ * which is found using countLeadingZeros() on the XOR of the codes.
+ */
+
+#include "bitcount.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace bitmanip {
+
+// NODE KEYS ===========================================================================================================
+
+/// The number of bits used by Morton codes of DIMS coordinates with 64 / DIMS bits each.
+template <std::size_t DIMS>
+inline constexpr unsigned MORTON_CODE_BITS = 64 / DIMS * DIMS;
+
+/// The deepest level of a tree, which is limited by the node keys also having to fit into 64 bits.
+template <std::size_t DIMS>
+inline constexpr unsigned MORTON_TREE_MAX_LEVEL = 63 / DIMS;
+
+/**
+ * @brief Returns the key of the node on the given level which contains a Morton code.
+ * Example: mortonTreeKey<2>(0b1110 << 60, 2) = 0b11110
+ * @tparam DIMS the number of dimensions
+ * @param code the Morton code
+ * @param level the level, where 0 is the root level
+ */
+template <std::size_t DIMS>
+[[nodiscard]] constexpr unsigned long long mortonTreeKey(unsigned long long code, unsigned level) noexcept
+{
+    static_assert(DIMS != 0 && DIMS < 64, "DIMS must be in [1, 63]");
+    if (level == 0) {
+        return 1;
+    }
+    return (1ull << (DIMS * level)) | (code >> (MORTON_CODE_BITS<DIMS> - DIMS * level));
+}
+
+/// Returns the level of a node key, where 0 is the root level.
+template <std::size_t DIMS>
+[[nodiscard]] constexpr unsigned mortonTreeLevel(unsigned long long key) noexcept
+{
+    return (63u - countLeadingZeros(key)) / DIMS;
+}
+
+/// Returns the key of the parent of a node, which must not be the root.
+template <std::size_t DIMS>
+[[nodiscard]] constexpr unsigned long long mortonTreeParent(unsigned long long key) noexcept
+{
+    return key >> DIMS;
+}
+
+/// Returns the key of the child i < 2^DIMS of a node, which must not be on the deepest level.
+template <std::size_t DIMS>
+[[nodiscard]] constexpr unsigned long long mortonTreeChild(unsigned long long key, unsigned i) noexcept
+{
+    return (key << DIMS) | i;
+}
+
+/// Returns the key of the sibling i < 2^DIMS of a node (the child i of its parent), which must not be the root.
+template <std::size_t DIMS>
+[[nodiscard]] constexpr unsigned long long mortonTreeSibling(unsigned long long key, unsigned i) noexcept
+{
+    return (key & ~((1ull << DIMS) - 1)) | i;
+}
+
+/// Returns the smallest Morton code within a node.
+template <std::size_t DIMS>
+[[nodiscard]] constexpr unsigned long long mortonTreeFirstCode(unsigned long long key) noexcept
+{
+    const unsigned level = mortonTreeLevel<DIMS>(key);
+    const unsigned shift = MORTON_CODE_BITS<DIMS> - DIMS * level;
+    const unsigned long long prefix = key ^ (1ull << (DIMS * level));
+    return shift == 64 ? 0 : prefix << shift;
+}
+
+/// Returns the greatest Morton code within a node.
+template <std::size_t DIMS>
+[[nodiscard]] constexpr unsigned long long mortonTreeLastCode(unsigned long long key) noexcept
+{
+    const unsigned shift = MORTON_CODE_BITS<DIMS> - DIMS * mortonTreeLevel<DIMS>(key);
+    return mortonTreeFirstCode<DIMS>(key) | (shift == 64 ? ~0ull : (1ull << shift) - 1);
+}
+
+/**
+ * @brief Returns the deepest level on which two Morton codes are in the same node.
+ * This is at most MORTON_TREE_MAX_LEVEL<DIMS>, even for equal codes.
+ * @tparam DIMS the number of dimensions
+ */
+template <std::size_t DIMS>
+[[nodiscard]] constexpr unsigned mortonCommonLevel(unsigned long long a, unsigned long long b) noexcept
+{
+    const unsigned commonBits = countLeadingZeros(a ^ b) - (64 - MORTON_CODE_BITS<DIMS>);
+    return std::min(commonBits / unsigned{DIMS}, MORTON_TREE_MAX_LEVEL<DIMS>);
+}
+
+// TREE CONSTRUCTION ===================================================================================================
+
+/**
+ * @brief A node of a linear tree.
+ * The nodes of a tree are stored in depth-first pre-order, so the descendants of each node directly follow it.
+ */
+struct MortonTreeNode {
+    /// The key of the node, see mortonTreeKey().
+    unsigned long long key;
+    /// The first index of the Morton codes within the node.
+    std::size_t begin;
+    /// One past the last index of the Morton codes within the node.
+    std::size_t end;
+    /// The index of the next node which is not a descendant of this node; this node is a leaf if it's its index + 1.
+    std::size_t next;
+};
+
+namespace detail {
+
+/**
+ * @brief Appends the node on the given level which contains all codes in [begin, end) and its descendants.
+ * Instead of searching for the children of each node, the codes are scanned once.
+ * At most maxLeafSize + 1 codes are looked ahead to decide whether a node is a leaf.
+ */
+template <std::size_t DIMS>
+void mortonTreeBuildRange(const unsigned long long codes[],
+                          std::size_t begin,
+                          std::size_t end,
+                          unsigned level,
+                          std::size_t maxLeafSize,
+                          std::vector<MortonTreeNode> &nodes)
+{
+    constexpr unsigned maxLevel = MORTON_TREE_MAX_LEVEL<DIMS>;
+    // the indices of the internal nodes on the path to the current node, by level
+    std::size_t open[maxLevel + 1];
+    const unsigned rootLevel = level;
+
+    for (std::size_t pos = begin;;) {
+        const bool canSplit = level < maxLevel;
+        const std::size_t limit = canSplit && end - pos > maxLeafSize ? pos + maxLeafSize + 1 : end;
+        std::size_t nodeEnd = pos + 1;
+        while (nodeEnd < limit && mortonCommonLevel<DIMS>(codes[nodeEnd - 1], codes[nodeEnd]) >= level) {
+            ++nodeEnd;
+        }
+
+        const unsigned long long key = mortonTreeKey<DIMS>(codes[pos], level);
+        if (canSplit && nodeEnd - pos > maxLeafSize) {
+            open[level++] = nodes.size();
+            nodes.push_back({key, pos, 0, 0});
+            continue;
+        }
+
+        nodes.push_back({key, pos, nodeEnd, nodes.size() + 1});
+        pos = nodeEnd;
+        // every open node deeper than the common level of the codes around pos ends at pos
+        const unsigned closedLevel = pos == end ? rootLevel : mortonCommonLevel<DIMS>(codes[pos - 1], codes[pos]) + 1;
+        for (unsigned l = closedLevel; l < level; ++l) {
+            nodes[open[l]].end = pos;
+            nodes[open[l]].next = nodes.size();
+        }
+        if (pos == end) {
+            return;
+        }
+        level = closedLevel;
+    }
+}
+
+}  // namespace detail
+
+/**
+ * @brief Builds a linear tree over sorted Morton codes.
+ * Nodes with more than maxLeafSize codes are split into their non-empty children, unless they are on the deepest level
+ * MORTON_TREE_MAX_LEVEL<DIMS>.
+ * For DIMS = 3, this is an octree, for DIMS = 2 a quadtree.
+ *
+ * If threadCount is greater than one, the subtrees of the children of the root are built in parallel.
+ *
+ * @tparam DIMS the number of dimensions
+ * @param codes the Morton codes, sorted in ascending order
+ * @param count the number of codes
+ * @param maxLeafSize the maximum number of codes per leaf, which must be at least 1
+ * @param nodes receives the nodes in depth-first pre-order, where the root comes first; previous contents are replaced
+ * @param threadCount the number of threads, where 0 and 1 mean the calling thread only
+ * @throws std::bad_alloc if the nodes can't be allocated
+ * @throws std::system_error if a thread can't be started
+ */
+template <std::size_t DIMS>
+void mortonTreeBuild(const unsigned long long codes[],
+                     std::size_t count,
+                     std::size_t maxLeafSize,
+                     std::vector<MortonTreeNode> &nodes,
+                     unsigned threadCount = 1)
+{
+    constexpr std::size_t childCount = std::size_t{1} << DIMS;
+
+    nodes.clear();
+    if (count == 0) {
+        return;
+    }
+    if (threadCount <= 1 || count <= maxLeafSize) {
+        detail::mortonTreeBuildRange<DIMS>(codes, 0, count, 0, maxLeafSize, nodes);
+        return;
+    }
+
+    std::size_t bounds[childCount + 1]{};
+    for (std::size_t i = 0; i < childCount; ++i) {
+        const unsigned long long childKey = mortonTreeChild<DIMS>(1, static_cast<unsigned>(i));
+        bounds[i + 1] = static_cast<std::size_t>(
+            std::upper_bound(codes, codes + count, mortonTreeLastCode<DIMS>(childKey)) - codes);
+    }
+
+    std::vector<std::vector<MortonTreeNode>> subtrees(childCount);
+    std::vector<std::exception_ptr> errors(threadCount);
+    const auto buildSubtrees = [&](unsigned t) {
+        try {
+            for (std::size_t i = t; i < childCount; i += threadCount) {
+                if (bounds[i] != bounds[i + 1]) {
+                    detail::mortonTreeBuildRange<DIMS>(codes, bounds[i], bounds[i + 1], 1, maxLeafSize, subtrees[i]);
+                }
+            }
+        }
+        catch (...) {
+            errors[t] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threadCount = std::min(threadCount, static_cast<unsigned>(childCount));
+    threads.reserve(threadCount - 1);
+    // the calling thread takes the first children itself
+    try {
+        for (unsigned t = 1; t < threadCount; ++t) {
+            threads.emplace_back(buildSubtrees, t);
+        }
+    }
+    catch (...) {
+        for (std::thread &thread : threads) {
+            thread.join();
+        }
+        throw;
+    }
+    buildSubtrees(0);
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    for (const std::exception_ptr &error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    std::size_t total = 1;
+    for (const std::vector<MortonTreeNode> &subtree : subtrees) {
+        total += subtree.size();
+    }
+    nodes.reserve(total);
+    nodes.push_back({1, 0, count, total});
+    for (const std::vector<MortonTreeNode> &subtree : subtrees) {
+        const std::size_t offset = nodes.size();
+        for (MortonTreeNode node : subtree) {
+            node.next += offset;
+            nodes.push_back(node);
+        }
+    }
+}
+
+}  // namespace bitmanip
+
+#endif  // BITMANIP_MORTONTREE_HPP
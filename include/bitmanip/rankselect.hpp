@@ -0,0 +1,285 @@
+#ifndef BITMANIP_RANKSELECT_HPP
+#define BITMANIP_RANKSELECT_HPP
+/*
+ * rankselect.hpp
+ * -----------
+ * Provides a succinct bit vector with constant-time rank and fast select queries (see Zhou, Andersen and Kaminsky,
+ * Space-Efficient, High-Performance Rank & Select Structures on Uncompressed Bit Sequences).
+ *
+ * The bits are divided into basic blocks of 512 bits, which are one cache line each.
+ * Four basic blocks form a lower block, whose index entry is a single 64-bit word, interleaving the number of one-bits
+ * before the lower block with the number of one-bits in each of its first three basic blocks.
+ * Because the former is only 32 bits wide, it is relative to an upper block of 2^32 bits, whose absolute counts are
+ * stored separately.
+ * This costs 64 bits per 2048 bits, or 3.125%.
+ *
+ * For select, the index of the lower block of every 8192-th one-bit is sampled, which costs at most another 0.79%.
+ * A query binary-searches the lower blocks between two samples and then scans at most four basic blocks.
+ */
+
+#include "bitcount.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace bitmanip {
+
+/**
+ * @brief An immutable bit vector with rank and select queries.
+ * Bit i is bit i % 64 of word i / 64.
+ */
+class RankSelectBitVector {
+public:
+    /// The number of bits in a basic block, which is one cache line.
+    static constexpr std::size_t BASIC_BLOCK_BITS = 512;
+    /// The number of bits in a lower block, which has one index entry.
+    static constexpr std::size_t LOWER_BLOCK_BITS = 4 * BASIC_BLOCK_BITS;
+    /// The number of bits in an upper block, within which the counts of the lower blocks are relative.
+    static constexpr std::uint64_t UPPER_BLOCK_BITS = std::uint64_t{1} << 32;
+    /// Every SELECT_SAMPLE_RATE-th one-bit is sampled for select.
+    static constexpr std::size_t SELECT_SAMPLE_RATE = 8192;
+
+private:
+    static constexpr std::size_t WORDS_PER_BASIC_BLOCK = BASIC_BLOCK_BITS / 64;
+    static constexpr std::size_t WORDS_PER_LOWER_BLOCK = LOWER_BLOCK_BITS / 64;
+    static constexpr std::size_t LOWER_BLOCKS_PER_UPPER_BLOCK = UPPER_BLOCK_BITS / LOWER_BLOCK_BITS;
+
+    std::vector<std::uint64_t> words_;
+    /// For each lower block, the relative count in the upper 32 bits and three 10-bit basic block counts below.
+    std::vector<std::uint64_t> lower_;
+    /// For each upper block, the number of one-bits before it.
+    std::vector<std::uint64_t> upper_;
+    /// For every SELECT_SAMPLE_RATE-th one-bit, the index of the lower block which contains it.
+    std::vector<std::size_t> samples_;
+    std::size_t size_ = 0;
+    std::size_t count_ = 0;
+
+public:
+    /**
+     * @brief Constructs an empty bit vector, whose index consists of a single lower block like that of any other.
+     * @throws std::bad_alloc if the index can't be allocated
+     */
+    RankSelectBitVector() : RankSelectBitVector({}, 0) {}
+
+    /**
+     * @brief Constructs the bit vector and builds its index.
+     * If threadCount is greater than one, the basic blocks are counted in parallel.
+     * @param words the words, where bits past bitCount are ignored
+     * @param bitCount the number of bits, which must be at most words.size() * 64
+     * @param threadCount the number of threads, where 0 and 1 mean the calling thread only
+     * @throws std::bad_alloc if the index can't be allocated
+     * @throws std::system_error if a thread can't be started
+     */
+    RankSelectBitVector(std::vector<std::uint64_t> words, std::size_t bitCount, unsigned threadCount = 1)
+        : words_(std::move(words)), size_(bitCount)
+    {
+        // padding the words to whole lower blocks allows scanning basic blocks without bounds checks
+        const std::size_t lowerCount = size_ / LOWER_BLOCK_BITS + 1;
+        words_.resize(lowerCount * WORDS_PER_LOWER_BLOCK);
+        for (std::size_t i = size_ / 64; i < words_.size(); ++i) {
+            words_[i] = i == size_ / 64 ? words_[i] & ((std::uint64_t{1} << (size_ % 64)) - 1) : 0;
+        }
+        lower_.resize(lowerCount);
+        upper_.resize(lowerCount / LOWER_BLOCKS_PER_UPPER_BLOCK + 1);
+
+        countLowerBlocks(threadCount);
+        accumulateLowerBlocks();
+        sampleLowerBlocks();
+    }
+
+    /// Returns the number of bits.
+    std::size_t size() const noexcept
+    {
+        return size_;
+    }
+
+    /// Returns the number of one-bits.
+    std::size_t count() const noexcept
+    {
+        return count_;
+    }
+
+    /// Returns the words, which are padded with zeros to a multiple of LOWER_BLOCK_BITS.
+    const std::uint64_t *data() const noexcept
+    {
+        return words_.data();
+    }
+
+    /// Returns the number of bytes used by the index, excluding the bits themselves.
+    std::size_t indexBytes() const noexcept
+    {
+        return (lower_.size() + upper_.size()) * sizeof(std::uint64_t) + samples_.size() * sizeof(std::size_t);
+    }
+
+    /// Returns bit i, where i < size().
+    bool operator[](std::size_t i) const noexcept
+    {
+        return (words_[i / 64] >> (i % 64)) & 1;
+    }
+
+    /**
+     * @brief Returns the number of one-bits before bit i.
+     * This takes constant time: one index entry is read and at most eight words of a single cache line are counted.
+     * @param i the position, where i <= size()
+     */
+    std::size_t rank1(std::size_t i) const noexcept
+    {
+        const std::size_t lowerBlock = i / LOWER_BLOCK_BITS;
+        const std::uint64_t entry = lower_[lowerBlock];
+        std::size_t result = upper_[lowerBlock / LOWER_BLOCKS_PER_UPPER_BLOCK] + (entry >> 32);
+
+        const std::size_t basicBlock = i / BASIC_BLOCK_BITS;
+        for (std::size_t b = 0; b < basicBlock % 4; ++b) {
+            result += basicBlockCount(entry, b);
+        }
+        for (std::size_t w = basicBlock * WORDS_PER_BASIC_BLOCK; w < i / 64; ++w) {
+            result += popCount(words_[w]);
+        }
+        if (i % 64 != 0) {
+            result += popCount(words_[i / 64] & ((std::uint64_t{1} << (i % 64)) - 1));
+        }
+        return result;
+    }
+
+    /// Returns the number of zero-bits before bit i, where i <= size().
+    std::size_t rank0(std::size_t i) const noexcept
+    {
+        return i - rank1(i);
+    }
+
+    /**
+     * @brief Returns the position of the k-th one-bit, where k = 0 is the first one-bit.
+     * This is the greatest position i for which rank1(i) == k.
+     * @param k the rank of the one-bit
+     * @return the position, or size() if k >= count()
+     */
+    std::size_t select1(std::size_t k) const noexcept
+    {
+        if (k >= count_) {
+            return size_;
+        }
+
+        // the greatest lower block in [lo, hi] which starts with at most k one-bits
+        std::size_t lo = samples_[k / SELECT_SAMPLE_RATE];
+        std::size_t hi = samples_[k / SELECT_SAMPLE_RATE + 1];
+        while (lo < hi) {
+            const std::size_t mid = lo + (hi - lo + 1) / 2;
+            if (lowerBlockRank(mid) <= k) {
+                lo = mid;
+            }
+            else {
+                hi = mid - 1;
+            }
+        }
+
+        std::size_t rank = k - lowerBlockRank(lo);
+        const std::uint64_t entry = lower_[lo];
+        std::size_t basicBlock = lo * 4;
+        for (std::size_t b = 0; b < 3; ++b, ++basicBlock) {
+            const std::size_t blockCount = basicBlockCount(entry, b);
+            if (rank < blockCount) {
+                break;
+            }
+            rank -= blockCount;
+        }
+
+        for (std::size_t w = basicBlock * WORDS_PER_BASIC_BLOCK;; ++w) {
+            const std::size_t wordCount = popCount(words_[w]);
+            if (rank < wordCount) {
+                return w * 64 + selectBit(words_[w], static_cast<unsigned>(rank));
+            }
+            rank -= wordCount;
+        }
+    }
+
+private:
+    static std::size_t basicBlockCount(std::uint64_t entry, std::size_t b) noexcept
+    {
+        return static_cast<std::size_t>((entry >> (b * 10)) & 0x3ff);
+    }
+
+    /// Returns the number of one-bits before a lower block.
+    std::size_t lowerBlockRank(std::size_t lowerBlock) const noexcept
+    {
+        return upper_[lowerBlock / LOWER_BLOCKS_PER_UPPER_BLOCK] + (lower_[lowerBlock] >> 32);
+    }
+
+    /// Stores the total count of each lower block in its upper 32 bits and the counts of its basic blocks below.
+    void countLowerBlocks(unsigned threadCount)
+    {
+        const auto countRange = [this](std::size_t begin, std::size_t end) {
+            for (std::size_t l = begin; l < end; ++l) {
+                const std::uint64_t *const block = words_.data() + l * WORDS_PER_LOWER_BLOCK;
+                std::uint64_t total = 0, entry = 0;
+                for (std::size_t b = 0; b < 4; ++b) {
+                    const std::size_t blockCount = popCount(block + b * WORDS_PER_BASIC_BLOCK, WORDS_PER_BASIC_BLOCK);
+                    entry |= b < 3 ? std::uint64_t{blockCount} << (b * 10) : 0;
+                    total += blockCount;
+                }
+                lower_[l] = (total << 32) | entry;
+            }
+        };
+
+        const std::size_t lowerCount = lower_.size();
+        if (threadCount <= 1 || lowerCount < threadCount) {
+            countRange(0, lowerCount);
+            return;
+        }
+
+        std::vector<std::thread> threads;
+        threads.reserve(threadCount - 1);
+        // the calling thread takes the first range itself
+        try {
+            for (unsigned t = 1; t < threadCount; ++t) {
+                threads.emplace_back(countRange, lowerCount * t / threadCount, lowerCount * (t + 1) / threadCount);
+            }
+        }
+        catch (...) {
+            for (std::thread &thread : threads) {
+                thread.join();
+            }
+            throw;
+        }
+        countRange(0, lowerCount / threadCount);
+        for (std::thread &thread : threads) {
+            thread.join();
+        }
+    }
+
+    /// Replaces the total count of each lower block with the count before it, relative to its upper block.
+    void accumulateLowerBlocks() noexcept
+    {
+        std::size_t total = 0;
+        for (std::size_t l = 0; l < lower_.size(); ++l) {
+            if (l % LOWER_BLOCKS_PER_UPPER_BLOCK == 0) {
+                upper_[l / LOWER_BLOCKS_PER_UPPER_BLOCK] = total;
+            }
+            const std::uint64_t blockTotal = lower_[l] >> 32;
+            const std::uint64_t relative = total - upper_[l / LOWER_BLOCKS_PER_UPPER_BLOCK];
+            lower_[l] = (relative << 32) | (lower_[l] & 0xffff'ffff);
+            total += static_cast<std::size_t>(blockTotal);
+        }
+        count_ = total;
+    }
+
+    /// Samples the lower block of every SELECT_SAMPLE_RATE-th one-bit, followed by the last lower block.
+    void sampleLowerBlocks()
+    {
+        samples_.reserve(count_ / SELECT_SAMPLE_RATE + 2);
+        const std::size_t lowerCount = lower_.size();
+        for (std::size_t l = 0, k = 0; k < count_; k += SELECT_SAMPLE_RATE) {
+            while (l + 1 < lowerCount && lowerBlockRank(l + 1) <= k) {
+                ++l;
+            }
+            samples_.push_back(l);
+        }
+        samples_.push_back(lowerCount - 1);
+    }
+};
+
+}  // namespace bitmanip
+
+#endif  // BITMANIP_RANKSELECT_HPP
@@ -0,0 +1,1024 @@
+#ifndef BITMANIP_ROARING_HPP
+#define BITMANIP_ROARING_HPP
+/*
+ * roaring.hpp
+ * -----------
+ * Provides a compressed bitmap of 32-bit integers (see Lemire et al., Consistently faster and smaller compressed
+ * bitmaps with Roaring).
+ *
+ * The integers are divided into chunks of 2^16 by their upper 16 bits, and each non-empty chunk stores its lower 16
+ * bits in one of three containers:
+ * - an array container of up to 4096 sorted values, which costs 2 bytes per value
+ * - a bitmap container of 2^16 bits, which costs 8 KiB regardless of how many values it holds
+ * - a run container of (start, length - 1) pairs, which costs 4 bytes per run of consecutive values
+ * The 4096 values limit of array containers is where they would become larger than a bitmap container.
+ * Run containers are only chosen by runOptimize(), where they are smaller than either of the others.
+ *
+ * Intersecting and subtracting array containers gallops through the larger array if the sizes are very different.
+ * Otherwise, blocks of eight values of each array are compared all-against-all using SSSE3 and the results are packed
+ * using a shuffle table.
+ * Operations on bitmap containers use the bulk operations of wbits.hpp and popCount().
+ */
+
+#include "bitcount.hpp"
+#include "build.hpp"
+#include "builtin.hpp"
+#include "cpu.hpp"
+#include "intlog.hpp"
+#include "setbits.hpp"
+#include "wbits.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#if defined(BITMANIP_X64) && (defined(BITMANIP_MSVC) || defined(BITMANIP_GNU_OR_CLANG))
+// SSSE3 is detected at runtime
+#define BITMANIP_HAS_SIMD_ROARING
+#endif
+
+namespace bitmanip {
+
+// SORTED ARRAY OPERATIONS =============================================================================================
+
+namespace detail {
+
+/// The maximum number of values of an array container.
+inline constexpr std::size_t ROARING_ARRAY_MAX_COUNT = 4096;
+/// The number of values in a chunk, which is the number of bits of a bitmap container.
+inline constexpr std::size_t ROARING_CHUNK_SIZE = std::size_t{1} << 16;
+/// Galloping is used if one array is at least this many times larger than the other.
+inline constexpr std::size_t ROARING_GALLOP_RATIO = 64;
+/// The number of values past the result which the array operations may overwrite.
+inline constexpr std::size_t ROARING_ARRAY_PADDING = 8;
+
+/**
+ * @brief Returns the first index in [begin, count) whose value is not less than the target, or count if there is none.
+ * The distance to begin is doubled until the target is passed, and then the last step is binary-searched.
+ * This takes O(log d) time, where d is the distance between begin and the result.
+ */
+[[nodiscard]] inline std::size_t gallop(const std::uint16_t values[],
+                                        std::size_t begin,
+                                        std::size_t count,
+                                        std::uint16_t target) noexcept
+{
+    if (begin >= count || values[begin] >= target) {
+        return begin;
+    }
+    // values[lo] < target holds throughout
+    std::size_t lo = begin, step = 1;
+    while (lo + step < count && values[lo + step] < target) {
+        lo += step;
+        step *= 2;
+    }
+    const std::size_t hi = lo + step < count ? lo + step : count;
+    return static_cast<std::size_t>(std::lower_bound(values + lo + 1, values + hi, target) - values);
+}
+
+inline std::size_t intersectArrays_scalar(
+    const std::uint16_t a[], std::size_t na, const std::uint16_t b[], std::size_t nb, std::uint16_t out[]) noexcept
+{
+    std::size_t i = 0, j = 0, n = 0;
+    while (i < na && j < nb) {
+        if (a[i] < b[j]) {
+            ++i;
+        }
+        else if (b[j] < a[i]) {
+            ++j;
+        }
+        else {
+            out[n++] = a[i];
+            ++i;
+            ++j;
+        }
+    }
+    return n;
+}
+
+/// Intersects a small array with a large one by galloping through the large one.
+inline std::size_t intersectArrays_gallop(const std::uint16_t small[],
+                                          std::size_t smallCount,
+                                          const std::uint16_t large[],
+                                          std::size_t largeCount,
+                                          std::uint16_t out[]) noexcept
+{
+    std::size_t j = 0, n = 0;
+    for (std::size_t i = 0; i < smallCount; ++i) {
+        j = gallop(large, j, largeCount, small[i]);
+        if (j == largeCount) {
+            break;
+        }
+        if (large[j] == small[i]) {
+            out[n++] = small[i];
+        }
+    }
+    return n;
+}
+
+inline std::size_t subtractArrays_scalar(
+    const std::uint16_t a[], std::size_t na, const std::uint16_t b[], std::size_t nb, std::uint16_t out[]) noexcept
+{
+    std::size_t j = 0, n = 0;
+    for (std::size_t i = 0; i < na; ++i) {
+        while (j < nb && b[j] < a[i]) {
+            ++j;
+        }
+        if (j == nb || b[j] != a[i]) {
+            out[n++] = a[i];
+        }
+    }
+    return n;
+}
+
+/// Subtracts b from a by galloping through the larger of the two arrays.
+inline std::size_t subtractArrays_gallop(
+    const std::uint16_t a[], std::size_t na, const std::uint16_t b[], std::size_t nb, std::uint16_t out[]) noexcept
+{
+    std::size_t n = 0;
+    if (na < nb) {
+        for (std::size_t i = 0, j = 0; i < na; ++i) {
+            j = gallop(b, j, nb, a[i]);
+            if (j == nb || b[j] != a[i]) {
+                out[n++] = a[i];
+            }
+        }
+        return n;
+    }
+    // the values of a between two values of b are copied as a whole
+    std::size_t i = 0;
+    for (std::size_t j = 0; j < nb && i < na; ++j) {
+        const std::size_t next = gallop(a, i, na, b[j]);
+        n = static_cast<std::size_t>(std::copy(a + i, a + next, out + n) - out);
+        i = next < na && a[next] == b[j] ? next + 1 : next;
+    }
+    return static_cast<std::size_t>(std::copy(a + i, a + na, out + n) - out);
+}
+
+inline std::size_t uniteArrays(
+    const std::uint16_t a[], std::size_t na, const std::uint16_t b[], std::size_t nb, std::uint16_t out[]) noexcept
+{
+    std::size_t i = 0, j = 0, n = 0;
+    while (i < na && j < nb) {
+        const std::uint16_t x = a[i], y = b[j];
+        out[n++] = x < y ? x : y;
+        i += x <= y;
+        j += y <= x;
+    }
+    n = static_cast<std::size_t>(std::copy(a + i, a + na, out + n) - out);
+    return static_cast<std::size_t>(std::copy(b + j, b + nb, out + n) - out);
+}
+
+#ifdef BITMANIP_HAS_SIMD_ROARING
+/// For every 8-bit mask, the byte indices which move the 16-bit lanes in the mask to the front, in 16 bytes each.
+[[nodiscard]] constexpr Table<std::uint64_t, 512> makeLaneCompressTable() noexcept
+{
+    Table<std::uint64_t, 512> result{};
+    for (unsigned mask = 0; mask < 256; ++mask) {
+        unsigned n = 0;
+        for (unsigned lane = 0; lane < 8; ++lane) {
+            if ((mask >> lane) & 1) {
+                const std::uint64_t bytes = (2 * lane) | ((2 * lane + 1) << 8);
+                result[mask * 2 + n / 4] |= bytes << (n % 4 * 16);
+                ++n;
+            }
+        }
+    }
+    return result;
+}
+
+inline constexpr Table<std::uint64_t, 512> LANE_COMPRESS_MASKS = makeLaneCompressTable();
+
+/// Returns the mask of the lanes of a which are equal to any lane of b, by comparing a with every rotation of b.
+BITMANIP_TARGET("ssse3,popcnt")
+inline unsigned matchLanes_ssse3(__m128i a, __m128i b) noexcept
+{
+    __m128i eq = _mm_cmpeq_epi16(a, b);
+    eq = _mm_or_si128(eq, _mm_cmpeq_epi16(a, _mm_alignr_epi8(b, b, 2)));
+    eq = _mm_or_si128(eq, _mm_cmpeq_epi16(a, _mm_alignr_epi8(b, b, 4)));
+    eq = _mm_or_si128(eq, _mm_cmpeq_epi16(a, _mm_alignr_epi8(b, b, 6)));
+    eq = _mm_or_si128(eq, _mm_cmpeq_epi16(a, _mm_alignr_epi8(b, b, 8)));
+    eq = _mm_or_si128(eq, _mm_cmpeq_epi16(a, _mm_alignr_epi8(b, b, 10)));
+    eq = _mm_or_si128(eq, _mm_cmpeq_epi16(a, _mm_alignr_epi8(b, b, 12)));
+    eq = _mm_or_si128(eq, _mm_cmpeq_epi16(a, _mm_alignr_epi8(b, b, 14)));
+    return static_cast<unsigned>(_mm_movemask_epi8(_mm_packs_epi16(eq, _mm_setzero_si128())));
+}
+
+/// Stores the lanes of x in the mask to out, returning their number.
+BITMANIP_TARGET("ssse3,popcnt")
+inline std::size_t storeLanes_ssse3(__m128i x, unsigned mask, std::uint16_t out[]) noexcept
+{
+    const __m128i shuffle = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&LANE_COMPRESS_MASKS[mask * 2]));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_shuffle_epi8(x, shuffle));
+    return static_cast<std::size_t>(_mm_popcnt_u32(mask));
+}
+
+/**
+ * @brief Intersects two arrays block by block, like a merge where each step consumes a block of eight values.
+ * Every block of a is compared with every block of b whose range overlaps it.
+ */
+BITMANIP_TARGET("ssse3,popcnt")
+inline std::size_t intersectArrays_ssse3(
+    const std::uint16_t a[], std::size_t na, const std::uint16_t b[], std::size_t nb, std::uint16_t out[]) noexcept
+{
+    std::size_t i = 0, j = 0, n = 0;
+    if (na >= 8 && nb >= 8) {
+        __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a));
+        __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b));
+        while (true) {
+            n += storeLanes_ssse3(va, matchLanes_ssse3(va, vb), out + n);
+            const std::uint16_t maxA = a[i + 7], maxB = b[j + 7];
+            if (maxA <= maxB) {
+                if ((i += 8) + 8 > na) {
+                    break;
+                }
+                va = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+            }
+            if (maxB <= maxA) {
+                if ((j += 8) + 8 > nb) {
+                    break;
+                }
+                vb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + j));
+            }
+        }
+    }
+    return n + intersectArrays_scalar(a + i, na - i, b + j, nb - j, out + n);
+}
+
+/**
+ * @brief Subtracts two arrays block by block like intersectArrays_ssse3().
+ * The matches of a block of a are accumulated until the block is consumed.
+ */
+BITMANIP_TARGET("ssse3,popcnt")
+inline std::size_t subtractArrays_ssse3(
+    const std::uint16_t a[], std::size_t na, const std::uint16_t b[], std::size_t nb, std::uint16_t out[]) noexcept
+{
+    std::size_t i = 0, j = 0, n = 0;
+    unsigned matched = 0;
+    if (na >= 8 && nb >= 8) {
+        __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a));
+        __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b));
+        while (true) {
+            matched |= matchLanes_ssse3(va, vb);
+            const std::uint16_t maxA = a[i + 7], maxB = b[j + 7];
+            if (maxA <= maxB) {
+                n += storeLanes_ssse3(va, ~matched & 0xff, out + n);
+                matched = 0;
+                if ((i += 8) + 8 > na) {
+                    break;
+                }
+                va = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+            }
+            if (maxB <= maxA) {
+                if ((j += 8) + 8 > nb) {
+                    break;
+                }
+                vb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + j));
+            }
+        }
+    }
+    // if b ran out first, the matches of the current block of a are still in matched
+    for (; i < na; ++i, matched >>= 1) {
+        while (j < nb && b[j] < a[i]) {
+            ++j;
+        }
+        if ((matched & 1) == 0 && (j == nb || b[j] != a[i])) {
+            out[n++] = a[i];
+        }
+    }
+    return n;
+}
+#endif
+
+/**
+ * @brief Stores the values which are in both sorted arrays to out.
+ * The output must have room for the smaller count + ROARING_ARRAY_PADDING values.
+ * @return the number of values
+ */
+inline std::size_t intersectArrays(
+    const std::uint16_t a[], std::size_t na, const std::uint16_t b[], std::size_t nb, std::uint16_t out[]) noexcept
+{
+    if (na * ROARING_GALLOP_RATIO < nb) {
+        return intersectArrays_gallop(a, na, b, nb, out);
+    }
+    if (nb * ROARING_GALLOP_RATIO < na) {
+        return intersectArrays_gallop(b, nb, a, na, out);
+    }
+#ifdef BITMANIP_HAS_SIMD_ROARING
+    if (CPU_FEATURES.ssse3 && CPU_FEATURES.popcnt) {
+        return intersectArrays_ssse3(a, na, b, nb, out);
+    }
+#endif
+    return intersectArrays_scalar(a, na, b, nb, out);
+}
+
+/**
+ * @brief Stores the values of the sorted array a which are not in the sorted array b to out.
+ * The output must have room for na + ROARING_ARRAY_PADDING values.
+ * @return the number of values
+ */
+inline std::size_t subtractArrays(
+    const std::uint16_t a[], std::size_t na, const std::uint16_t b[], std::size_t nb, std::uint16_t out[]) noexcept
+{
+    if (na * ROARING_GALLOP_RATIO < nb || nb * ROARING_GALLOP_RATIO < na) {
+        return subtractArrays_gallop(a, na, b, nb, out);
+    }
+#ifdef BITMANIP_HAS_SIMD_ROARING
+    if (CPU_FEATURES.ssse3 && CPU_FEATURES.popcnt) {
+        return subtractArrays_ssse3(a, na, b, nb, out);
+    }
+#endif
+    return subtractArrays_scalar(a, na, b, nb, out);
+}
+
+// CONTAINERS ==========================================================================================================
+
+enum class RoaringContainerType : unsigned char { ARRAY, BITMAP, RUN };
+
+/**
+ * @brief The lower 16 bits of the values in a chunk.
+ * Unless it's a run container, a container is an array container if and only if it has at most
+ * ROARING_ARRAY_MAX_COUNT values, so that every set has exactly one representation without runs.
+ */
+struct RoaringContainer {
+    RoaringContainerType type = RoaringContainerType::ARRAY;
+    /// The number of values, which is in [1, 2^16] for containers which are stored in a RoaringBitmap.
+    std::uint32_t count = 0;
+    /// The sorted values of an array container, or the (start, length - 1) pairs of a run container.
+    std::vector<std::uint16_t> values;
+    /// The bits of a bitmap container.
+    wide::DynamicBits bits;
+};
+
+/// Sets the bits in [begin, end), where begin < end.
+inline void setBitRange(std::uint64_t words[], std::size_t begin, std::size_t end) noexcept
+{
+    const std::size_t first = begin / 64, last = (end - 1) / 64;
+    const std::uint64_t lowMask = ~std::uint64_t{0} << (begin % 64);
+    const std::uint64_t highMask = ~std::uint64_t{0} >> (63 - (end - 1) % 64);
+    if (first == last) {
+        words[first] |= lowMask & highMask;
+        return;
+    }
+    words[first] |= lowMask;
+    for (std::size_t i = first + 1; i < last; ++i) {
+        words[i] = ~std::uint64_t{0};
+    }
+    words[last] |= highMask;
+}
+
+inline void convertArrayToBitmap(RoaringContainer &c)
+{
+    c.bits = wide::DynamicBits{ROARING_CHUNK_SIZE};
+    for (std::uint16_t v : c.values) {
+        c.bits.set(v);
+    }
+    c.values = {};
+    c.type = RoaringContainerType::BITMAP;
+}
+
+inline void convertBitmapToArray(RoaringContainer &c)
+{
+    c.values.clear();
+    c.values.reserve(c.count);
+    forEachSetBit(c.bits.data(), c.bits.wordCount(), [&c](std::size_t i) {
+        c.values.push_back(static_cast<std::uint16_t>(i));
+    });
+    c.bits = {};
+    c.type = RoaringContainerType::ARRAY;
+}
+
+/// Turns an array or bitmap container into the type which its number of values calls for.
+inline void normalizeContainer(RoaringContainer &c)
+{
+    if (c.type == RoaringContainerType::ARRAY && c.count > ROARING_ARRAY_MAX_COUNT) {
+        convertArrayToBitmap(c);
+    }
+    else if (c.type == RoaringContainerType::BITMAP && c.count <= ROARING_ARRAY_MAX_COUNT) {
+        convertBitmapToArray(c);
+    }
+}
+
+/// Turns a run container into an array or bitmap container.
+inline void expandRuns(RoaringContainer &c)
+{
+    std::vector<std::uint16_t> runs = std::move(c.values);
+    c.values = {};
+    if (c.count <= ROARING_ARRAY_MAX_COUNT) {
+        c.type = RoaringContainerType::ARRAY;
+        c.values.reserve(c.count);
+        for (std::size_t r = 0; r < runs.size(); r += 2) {
+            for (std::size_t v = runs[r]; v <= std::size_t{runs[r]} + runs[r + 1]; ++v) {
+                c.values.push_back(static_cast<std::uint16_t>(v));
+            }
+        }
+    }
+    else {
+        c.type = RoaringContainerType::BITMAP;
+        c.bits = wide::DynamicBits{ROARING_CHUNK_SIZE};
+        for (std::size_t r = 0; r < runs.size(); r += 2) {
+            setBitRange(c.bits.data(), runs[r], std::size_t{runs[r]} + runs[r + 1] + 1);
+        }
+    }
+}
+
+/// Returns the number of runs of consecutive values in an array or bitmap container.
+[[nodiscard]] inline std::size_t countRuns(const RoaringContainer &c) noexcept
+{
+    if (c.type == RoaringContainerType::ARRAY) {
+        std::size_t result = 0;
+        for (std::size_t i = 0; i < c.values.size(); ++i) {
+            result += i == 0 || c.values[i] != c.values[i - 1] + 1;
+        }
+        return result;
+    }
+    // every run starts with a one-bit whose lower neighbor is a zero-bit
+    std::size_t result = 0;
+    std::uint64_t carry = 0;
+    for (std::size_t i = 0; i < c.bits.wordCount(); ++i) {
+        const std::uint64_t word = c.bits.data()[i];
+        result += popCount(word & ~((word << 1) | carry));
+        carry = word >> 63;
+    }
+    return result;
+}
+
+/// Turns an array or bitmap container into a run container.
+inline void convertToRuns(RoaringContainer &c)
+{
+    std::vector<std::uint16_t> runs;
+    runs.reserve(countRuns(c) * 2);
+    if (c.type == RoaringContainerType::ARRAY) {
+        for (std::size_t i = 0; i < c.values.size(); ++i) {
+            if (i != 0 && c.values[i] == c.values[i - 1] + 1) {
+                ++runs.back();
+            }
+            else {
+                runs.push_back(c.values[i]);
+                runs.push_back(0);
+            }
+        }
+    }
+    else {
+        const std::uint64_t *const words = c.bits.data();
+        const std::size_t wordCount = c.bits.wordCount();
+        std::size_t i = 0;
+        for (std::uint64_t word = words[0];;) {
+            while (word == 0 && i + 1 < wordCount) {
+                word = words[++i];
+            }
+            if (word == 0) {
+                break;
+            }
+            const std::size_t start = i * 64 + countTrailingZeros(word);
+            // filling the zeros below the run, it ends at the lowest zero-bit
+            word |= word - 1;
+            while (word == ~std::uint64_t{0} && i + 1 < wordCount) {
+                word = words[++i];
+            }
+            const std::size_t end = word == ~std::uint64_t{0} ? ROARING_CHUNK_SIZE : i * 64 + countTrailingZeros(~word);
+            runs.push_back(static_cast<std::uint16_t>(start));
+            runs.push_back(static_cast<std::uint16_t>(end - 1 - start));
+            if (end == ROARING_CHUNK_SIZE) {
+                break;
+            }
+            // clearing the run
+            word &= word + 1;
+        }
+    }
+    c.values = std::move(runs);
+    c.bits = {};
+    c.type = RoaringContainerType::RUN;
+}
+
+[[nodiscard]] inline bool containerContains(const RoaringContainer &c, std::uint16_t value) noexcept
+{
+    switch (c.type) {
+    case RoaringContainerType::ARRAY: return std::binary_search(c.values.begin(), c.values.end(), value);
+    case RoaringContainerType::BITMAP: return c.bits[value];
+    case RoaringContainerType::RUN: break;
+    }
+    // the last run which starts at or before the value
+    std::size_t lo = 0, hi = c.values.size() / 2;
+    while (lo < hi) {
+        const std::size_t mid = lo + (hi - lo) / 2;
+        if (c.values[mid * 2] <= value) {
+            lo = mid + 1;
+        }
+        else {
+            hi = mid;
+        }
+    }
+    return lo != 0 && value - c.values[lo * 2 - 2] <= c.values[lo * 2 - 1];
+}
+
+template <typename F>
+void containerForEach(const RoaringContainer &c, std::uint32_t high, F &f)
+{
+    switch (c.type) {
+    case RoaringContainerType::ARRAY: {
+        for (std::uint16_t v : c.values) {
+            f(high | v);
+        }
+        break;
+    }
+    case RoaringContainerType::BITMAP: {
+        forEachSetBit(c.bits.data(), c.bits.wordCount(), [high, &f](std::size_t i) {
+            f(high | static_cast<std::uint32_t>(i));
+        });
+        break;
+    }
+    case RoaringContainerType::RUN: {
+        for (std::size_t r = 0; r < c.values.size(); r += 2) {
+            for (std::uint32_t v = c.values[r]; v <= std::uint32_t{c.values[r]} + c.values[r + 1]; ++v) {
+                f(high | v);
+            }
+        }
+        break;
+    }
+    }
+}
+
+/// Returns a container with the values in the bits, which are consumed.
+inline RoaringContainer makeBitmapContainer(wide::DynamicBits bits)
+{
+    RoaringContainer result;
+    result.type = RoaringContainerType::BITMAP;
+    result.count = static_cast<std::uint32_t>(bits.count());
+    result.bits = std::move(bits);
+    normalizeContainer(result);
+    return result;
+}
+
+/// Returns an array container with the values in [0, n) of the buffer, which is consumed.
+inline RoaringContainer makeArrayContainer(std::vector<std::uint16_t> buffer, std::size_t n)
+{
+    RoaringContainer result;
+    buffer.resize(n);
+    result.count = static_cast<std::uint32_t>(n);
+    result.values = std::move(buffer);
+    return result;
+}
+
+inline RoaringContainer intersectContainers(const RoaringContainer &a, const RoaringContainer &b)
+{
+    using Type = RoaringContainerType;
+    if (a.type == Type::RUN || b.type == Type::RUN) {
+        RoaringContainer x = a, y = b;
+        if (x.type == Type::RUN) {
+            expandRuns(x);
+        }
+        if (y.type == Type::RUN) {
+            expandRuns(y);
+        }
+        return intersectContainers(x, y);
+    }
+
+    if (a.type == Type::BITMAP && b.type == Type::BITMAP) {
+        return makeBitmapContainer(a.bits & b.bits);
+    }
+    if (a.type == Type::ARRAY && b.type == Type::ARRAY) {
+        std::vector<std::uint16_t> buffer(std::min(a.values.size(), b.values.size()) + ROARING_ARRAY_PADDING);
+        const std::size_t n = intersectArrays(a.values.data(), a.values.size(), b.values.data(), b.values.size(),
+                                              buffer.data());
+        return makeArrayContainer(std::move(buffer), n);
+    }
+    const RoaringContainer &array = a.type == Type::ARRAY ? a : b;
+    const RoaringContainer &bitmap = a.type == Type::ARRAY ? b : a;
+    RoaringContainer result;
+    for (std::uint16_t v : array.values) {
+        if (bitmap.bits[v]) {
+            result.values.push_back(v);
+        }
+    }
+    result.count = static_cast<std::uint32_t>(result.values.size());
+    return result;
+}
+
+inline RoaringContainer uniteContainers(const RoaringContainer &a, const RoaringContainer &b)
+{
+    using Type = RoaringContainerType;
+    if (a.type == Type::RUN || b.type == Type::RUN) {
+        RoaringContainer x = a, y = b;
+        if (x.type == Type::RUN) {
+            expandRuns(x);
+        }
+        if (y.type == Type::RUN) {
+            expandRuns(y);
+        }
+        return uniteContainers(x, y);
+    }
+
+    if (a.type == Type::BITMAP && b.type == Type::BITMAP) {
+        return makeBitmapContainer(a.bits | b.bits);
+    }
+    if (a.type == Type::ARRAY && b.type == Type::ARRAY) {
+        // a union which might not fit into an array container is built as a bitmap right away
+        if (a.values.size() + b.values.size() > ROARING_ARRAY_MAX_COUNT) {
+            wide::DynamicBits bits{ROARING_CHUNK_SIZE};
+            for (std::uint16_t v : a.values) {
+                bits.set(v);
+            }
+            for (std::uint16_t v : b.values) {
+                bits.set(v);
+            }
+            return makeBitmapContainer(std::move(bits));
+        }
+        std::vector<std::uint16_t> buffer(a.values.size() + b.values.size());
+        const std::size_t n =
+            uniteArrays(a.values.data(), a.values.size(), b.values.data(), b.values.size(), buffer.data());
+        return makeArrayContainer(std::move(buffer), n);
+    }
+    const RoaringContainer &array = a.type == Type::ARRAY ? a : b;
+    RoaringContainer result = a.type == Type::ARRAY ? b : a;
+    for (std::uint16_t v : array.values) {
+        result.count += not result.bits[v];
+        result.bits.set(v);
+    }
+    return result;
+}
+
+inline RoaringContainer subtractContainers(const RoaringContainer &a, const RoaringContainer &b)
+{
+    using Type = RoaringContainerType;
+    if (a.type == Type::RUN || b.type == Type::RUN) {
+        RoaringContainer x = a, y = b;
+        if (x.type == Type::RUN) {
+            expandRuns(x);
+        }
+        if (y.type == Type::RUN) {
+            expandRuns(y);
+        }
+        return subtractContainers(x, y);
+    }
+
+    if (a.type == Type::BITMAP && b.type == Type::BITMAP) {
+        return makeBitmapContainer(a.bits - b.bits);
+    }
+    if (a.type == Type::ARRAY && b.type == Type::ARRAY) {
+        std::vector<std::uint16_t> buffer(a.values.size() + ROARING_ARRAY_PADDING);
+        const std::size_t n =
+            subtractArrays(a.values.data(), a.values.size(), b.values.data(), b.values.size(), buffer.data());
+        return makeArrayContainer(std::move(buffer), n);
+    }
+    if (a.type == Type::ARRAY) {
+        RoaringContainer result;
+        for (std::uint16_t v : a.values) {
+            if (not b.bits[v]) {
+                result.values.push_back(v);
+            }
+        }
+        result.count = static_cast<std::uint32_t>(result.values.size());
+        return result;
+    }
+    RoaringContainer result = a;
+    for (std::uint16_t v : b.values) {
+        result.count -= result.bits[v];
+        result.bits.reset(v);
+    }
+    normalizeContainer(result);
+    return result;
+}
+
+/// Returns true if two containers hold the same values, regardless of their types.
+[[nodiscard]] inline bool containersEqual(const RoaringContainer &a, const RoaringContainer &b)
+{
+    if (a.count != b.count) {
+        return false;
+    }
+    if (a.type == b.type) {
+        return a.type == RoaringContainerType::BITMAP ? a.bits == b.bits : a.values == b.values;
+    }
+    RoaringContainer x = a, y = b;
+    if (x.type == RoaringContainerType::RUN) {
+        expandRuns(x);
+    }
+    if (y.type == RoaringContainerType::RUN) {
+        expandRuns(y);
+    }
+    return containersEqual(x, y);
+}
+
+}  // namespace detail
+
+// ROARING BITMAP ======================================================================================================
+
+/**
+ * @brief A compressed set of 32-bit integers.
+ * Sparse chunks of 2^16 values are stored as sorted arrays, dense chunks as bitmaps, and after runOptimize(), chunks
+ * with long runs of consecutive values as runs.
+ */
+class RoaringBitmap {
+public:
+    using valueType = std::uint32_t;
+
+private:
+    using Container = detail::RoaringContainer;
+    using ContainerType = detail::RoaringContainerType;
+
+    /// The upper 16 bits of the values of each container, in ascending order.
+    std::vector<std::uint16_t> keys_;
+    std::vector<Container> containers_;
+
+public:
+    /// Constructs an empty bitmap.
+    RoaringBitmap() = default;
+
+    /**
+     * @brief Constructs a bitmap from values in ascending order, which may contain duplicates.
+     * @throws std::bad_alloc if the containers can't be allocated
+     */
+    RoaringBitmap(const std::uint32_t values[], std::size_t count)
+    {
+        for (std::size_t begin = 0, end = 0; begin < count; begin = end) {
+            const std::uint32_t high = values[begin] >> 16;
+            while (end < count && values[end] >> 16 == high) {
+                ++end;
+            }
+
+            Container c;
+            if (end - begin > detail::ROARING_ARRAY_MAX_COUNT) {
+                c.type = ContainerType::BITMAP;
+                c.bits = wide::DynamicBits{detail::ROARING_CHUNK_SIZE};
+                for (std::size_t i = begin; i < end; ++i) {
+                    c.bits.set(values[i] & 0xffff);
+                }
+                c.count = static_cast<std::uint32_t>(c.bits.count());
+                detail::normalizeContainer(c);
+            }
+            else {
+                c.values.reserve(end - begin);
+                for (std::size_t i = begin; i < end; ++i) {
+                    if (i == begin || values[i] != values[i - 1]) {
+                        c.values.push_back(static_cast<std::uint16_t>(values[i]));
+                    }
+                }
+                c.count = static_cast<std::uint32_t>(c.values.size());
+            }
+            keys_.push_back(static_cast<std::uint16_t>(high));
+            containers_.push_back(std::move(c));
+        }
+    }
+
+    bool empty() const noexcept
+    {
+        return keys_.empty();
+    }
+
+    /// Returns the number of values.
+    std::uint64_t count() const noexcept
+    {
+        std::uint64_t result = 0;
+        for (const Container &c : containers_) {
+            result += c.count;
+        }
+        return result;
+    }
+
+    /// Returns the number of bytes which are allocated by the bitmap, including the bitmap object itself.
+    std::size_t memoryBytes() const noexcept
+    {
+        std::size_t result = sizeof(RoaringBitmap) + keys_.capacity() * sizeof(std::uint16_t) +
+                             containers_.capacity() * sizeof(Container);
+        for (const Container &c : containers_) {
+            result += c.values.capacity() * sizeof(std::uint16_t) + c.bits.wordCount() * sizeof(std::uint64_t);
+        }
+        return result;
+    }
+
+    bool contains(std::uint32_t value) const noexcept
+    {
+        const std::size_t i = findKey(value >> 16);
+        return i != keys_.size() && keys_[i] == value >> 16 &&
+               detail::containerContains(containers_[i], static_cast<std::uint16_t>(value));
+    }
+
+    /**
+     * @brief Adds a value, turning a run container into an array or bitmap container first.
+     * @return true if the value was not in the bitmap
+     * @throws std::bad_alloc if the container can't be allocated
+     */
+    bool add(std::uint32_t value)
+    {
+        const auto high = static_cast<std::uint16_t>(value >> 16);
+        const auto low = static_cast<std::uint16_t>(value);
+        const std::size_t i = findKey(high);
+        if (i == keys_.size() || keys_[i] != high) {
+            Container c;
+            c.values.push_back(low);
+            c.count = 1;
+            keys_.insert(keys_.begin() + static_cast<std::ptrdiff_t>(i), high);
+            containers_.insert(containers_.begin() + static_cast<std::ptrdiff_t>(i), std::move(c));
+            return true;
+        }
+
+        Container &c = containers_[i];
+        if (detail::containerContains(c, low)) {
+            return false;
+        }
+        if (c.type == ContainerType::RUN) {
+            detail::expandRuns(c);
+        }
+        if (c.type == ContainerType::ARRAY) {
+            c.values.insert(std::lower_bound(c.values.begin(), c.values.end(), low), low);
+        }
+        else {
+            c.bits.set(low);
+        }
+        ++c.count;
+        detail::normalizeContainer(c);
+        return true;
+    }
+
+    /**
+     * @brief Removes a value, turning a run container into an array or bitmap container first.
+     * @return true if the value was in the bitmap
+     * @throws std::bad_alloc if the container can't be allocated
+     */
+    bool remove(std::uint32_t value)
+    {
+        const auto high = static_cast<std::uint16_t>(value >> 16);
+        const auto low = static_cast<std::uint16_t>(value);
+        const std::size_t i = findKey(high);
+        if (i == keys_.size() || keys_[i] != high || not detail::containerContains(containers_[i], low)) {
+            return false;
+        }
+
+        Container &c = containers_[i];
+        if (c.count == 1) {
+            keys_.erase(keys_.begin() + static_cast<std::ptrdiff_t>(i));
+            containers_.erase(containers_.begin() + static_cast<std::ptrdiff_t>(i));
+            return true;
+        }
+        if (c.type == ContainerType::RUN) {
+            detail::expandRuns(c);
+        }
+        if (c.type == ContainerType::ARRAY) {
+            c.values.erase(std::lower_bound(c.values.begin(), c.values.end(), low));
+        }
+        else {
+            c.bits.reset(low);
+        }
+        --c.count;
+        detail::normalizeContainer(c);
+        return true;
+    }
+
+    /**
+     * @brief Turns every container into a run container where that is smaller, and releases unused capacity.
+     * Adding to or removing from a run container, or combining two matching containers in a set operation, expands
+     * the runs again; calling this again afterwards is harmless.
+     * @throws std::bad_alloc if the containers can't be allocated
+     */
+    void runOptimize()
+    {
+        for (Container &c : containers_) {
+            if (c.type != ContainerType::RUN) {
+                const std::size_t runBytes = detail::countRuns(c) * 2 * sizeof(std::uint16_t);
+                const std::size_t currentBytes = c.type == ContainerType::ARRAY
+                                                     ? c.values.size() * sizeof(std::uint16_t)
+                                                     : c.bits.wordCount() * sizeof(std::uint64_t);
+                if (runBytes < currentBytes) {
+                    detail::convertToRuns(c);
+                }
+            }
+            c.values.shrink_to_fit();
+        }
+        keys_.shrink_to_fit();
+        containers_.shrink_to_fit();
+    }
+
+    /// Invokes f(value) with every value in ascending order, where value is a std::uint32_t.
+    template <typename F>
+    void forEach(F f) const
+    {
+        for (std::size_t i = 0; i < keys_.size(); ++i) {
+            detail::containerForEach(containers_[i], std::uint32_t{keys_[i]} << 16, f);
+        }
+    }
+
+    // SET OPERATIONS ==================================================================================================
+
+    /// Returns the intersection.
+    RoaringBitmap operator&(const RoaringBitmap &other) const
+    {
+        RoaringBitmap result;
+        for (std::size_t i = 0, j = 0; i < keys_.size() && j < other.keys_.size();) {
+            if (keys_[i] < other.keys_[j]) {
+                ++i;
+            }
+            else if (other.keys_[j] < keys_[i]) {
+                ++j;
+            }
+            else {
+                result.append(keys_[i], detail::intersectContainers(containers_[i], other.containers_[j]));
+                ++i;
+                ++j;
+            }
+        }
+        return result;
+    }
+
+    /// Returns the union.
+    RoaringBitmap operator|(const RoaringBitmap &other) const
+    {
+        RoaringBitmap result;
+        std::size_t i = 0, j = 0;
+        while (i < keys_.size() && j < other.keys_.size()) {
+            if (keys_[i] < other.keys_[j]) {
+                result.append(keys_[i], containers_[i]);
+                ++i;
+            }
+            else if (other.keys_[j] < keys_[i]) {
+                result.append(other.keys_[j], other.containers_[j]);
+                ++j;
+            }
+            else {
+                result.append(keys_[i], detail::uniteContainers(containers_[i], other.containers_[j]));
+                ++i;
+                ++j;
+            }
+        }
+        for (; i < keys_.size(); ++i) {
+            result.append(keys_[i], containers_[i]);
+        }
+        for (; j < other.keys_.size(); ++j) {
+            result.append(other.keys_[j], other.containers_[j]);
+        }
+        return result;
+    }
+
+    /// Returns the difference, which are the values that are not in other.
+    RoaringBitmap operator-(const RoaringBitmap &other) const
+    {
+        RoaringBitmap result;
+        std::size_t j = 0;
+        for (std::size_t i = 0; i < keys_.size(); ++i) {
+            while (j < other.keys_.size() && other.keys_[j] < keys_[i]) {
+                ++j;
+            }
+            if (j < other.keys_.size() && other.keys_[j] == keys_[i]) {
+                result.append(keys_[i], detail::subtractContainers(containers_[i], other.containers_[j]));
+            }
+            else {
+                result.append(keys_[i], containers_[i]);
+            }
+        }
+        return result;
+    }
+
+    RoaringBitmap &operator&=(const RoaringBitmap &other)
+    {
+        return *this = *this & other;
+    }
+
+    RoaringBitmap &operator|=(const RoaringBitmap &other)
+    {
+        return *this = *this | other;
+    }
+
+    RoaringBitmap &operator-=(const RoaringBitmap &other)
+    {
+        return *this = *this - other;
+    }
+
+    /// Returns true if both bitmaps contain the same values, regardless of their containers.
+    bool operator==(const RoaringBitmap &other) const
+    {
+        if (keys_ != other.keys_) {
+            return false;
+        }
+        for (std::size_t i = 0; i < containers_.size(); ++i) {
+            if (not detail::containersEqual(containers_[i], other.containers_[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool operator!=(const RoaringBitmap &other) const
+    {
+        return not(*this == other);
+    }
+
+private:
+    /// Returns the index of the first key which is not less than the given one.
+    std::size_t findKey(std::uint32_t high) const noexcept
+    {
+        return static_cast<std::size_t>(std::lower_bound(keys_.begin(), keys_.end(), high) - keys_.begin());
+    }
+
+    /// Appends a container with a key greater than all others, unless it's empty.
+    void append(std::uint16_t key, Container c)
+    {
+        if (c.count != 0) {
+            keys_.push_back(key);
+            containers_.push_back(std::move(c));
+        }
+    }
+};
+
+}  // namespace bitmanip
+
+#endif  // BITMANIP_ROARING_HPP
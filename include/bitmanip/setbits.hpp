@@ -0,0 +1,298 @@
+#ifndef BITMANIP_SETBITS_HPP
+#define BITMANIP_SETBITS_HPP
+/*
+ * setbits.hpp
+ * -----------
+ * Provides iteration over the positions of the one-bits in arrays of words, where bit i is bit i % 64 of word i / 64.
+ *
+ * Instead of visiting one bit at a time using countTrailingZeros() and clearing the lowest one-bit, the positions are
+ * decoded in bulk into a buffer.
+ * With AVX-512, vpcompressd packs the positions of up to 16 one-bits at once.
+ * With AVX2, the positions of the one-bits of each byte are looked up in a table and widened, eight at a time.
+ * Either way, more positions than there are one-bits are stored, but the output only advances by the number of
+ * one-bits, so the output needs some padding.
+ */
+
+#include "bitcount.hpp"
+#include "build.hpp"
+#include "builtin.hpp"
+#include "cpu.hpp"
+#include "intlog.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+#if defined(BITMANIP_X64) && (defined(BITMANIP_MSVC) || defined(BITMANIP_GNU_OR_CLANG))
+// AVX2 and AVX-512 are detected at runtime
+#define BITMANIP_HAS_SIMD_SET_BITS
+#endif
+
+namespace bitmanip {
+
+// BULK DECODING =======================================================================================================
+
+/// The number of positions past the decoded ones which decodeSetBits() may overwrite.
+inline constexpr std::size_t DECODE_SET_BITS_PADDING = 16;
+
+namespace detail {
+
+inline std::size_t decodeSetBits_ctz(const std::uint64_t words[], std::size_t count, std::uint32_t out[]) noexcept
+{
+    std::size_t n = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        for (std::uint64_t word = words[i]; word != 0; word &= word - 1) {
+            out[n++] = static_cast<std::uint32_t>(i * 64 + countTrailingZeros(word));
+        }
+    }
+    return n;
+}
+
+#ifdef BITMANIP_HAS_SIMD_SET_BITS
+/// For every byte, the positions of its one-bits in ascending order, stored in the bytes of a word.
+[[nodiscard]] constexpr Table<std::uint64_t, 256> makeSetBitPositionTable() noexcept
+{
+    Table<std::uint64_t, 256> result{};
+    for (unsigned byte = 0; byte < 256; ++byte) {
+        unsigned n = 0;
+        for (unsigned bit = 0; bit < 8; ++bit) {
+            if ((byte >> bit) & 1) {
+                result[byte] |= std::uint64_t{bit} << (n++ * 8);
+            }
+        }
+    }
+    return result;
+}
+
+inline constexpr Table<std::uint64_t, 256> SET_BIT_POSITIONS = makeSetBitPositionTable();
+
+BITMANIP_TARGET("avx2,popcnt")
+inline std::size_t decodeSetBits_avx2(const std::uint64_t words[], std::size_t count, std::uint32_t out[]) noexcept
+{
+    std::size_t n = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        const std::uint64_t word = words[i];
+        if (word == 0) {
+            continue;
+        }
+        for (unsigned b = 0; b < 8; ++b) {
+            const unsigned byte = (word >> (b * 8)) & 0xff;
+            const __m128i positions = _mm_cvtsi64_si128(static_cast<long long>(SET_BIT_POSITIONS[byte]));
+            const __m256i base = _mm256_set1_epi32(static_cast<int>(i * 64 + b * 8));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + n),
+                                _mm256_add_epi32(_mm256_cvtepu8_epi32(positions), base));
+            n += static_cast<std::size_t>(_mm_popcnt_u32(byte));
+        }
+    }
+    return n;
+}
+
+BITMANIP_TARGET("avx512f,popcnt")
+inline std::size_t decodeSetBits_avx512(const std::uint64_t words[], std::size_t count, std::uint32_t out[]) noexcept
+{
+    const __m512i iota = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    std::size_t n = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        const std::uint64_t word = words[i];
+        if (word == 0) {
+            continue;
+        }
+        for (unsigned q = 0; q < 4; ++q) {
+            const auto mask = static_cast<__mmask16>(word >> (q * 16));
+            const __m512i positions = _mm512_add_epi32(iota, _mm512_set1_epi32(static_cast<int>(i * 64 + q * 16)));
+            // storing the whole vector is much faster than vpcompressd with a memory operand
+            _mm512_storeu_si512(out + n, _mm512_maskz_compress_epi32(mask, positions));
+            n += static_cast<std::size_t>(_mm_popcnt_u32(mask));
+        }
+    }
+    return n;
+}
+#endif
+
+}  // namespace detail
+
+/**
+ * @brief Stores the positions of the one-bits in an array of words in ascending order.
+ * The output must have room for popCount(words, count) + DECODE_SET_BITS_PADDING positions.
+ * The positions must fit into 32 bits, so count must be at most 2^26.
+ * @param words the words
+ * @param count the number of words
+ * @param out the positions
+ * @return the number of positions, which is the number of one-bits
+ */
+inline std::size_t decodeSetBits(const std::uint64_t words[], std::size_t count, std::uint32_t out[]) noexcept
+{
+#ifdef BITMANIP_HAS_SIMD_SET_BITS
+    if (CPU_FEATURES.avx512f && CPU_FEATURES.popcnt) {
+        return detail::decodeSetBits_avx512(words, count, out);
+    }
+    if (CPU_FEATURES.avx2 && CPU_FEATURES.popcnt) {
+        return detail::decodeSetBits_avx2(words, count, out);
+    }
+#endif
+    return detail::decodeSetBits_ctz(words, count, out);
+}
+
+// ITERATION ===========================================================================================================
+
+/// The number of words which forEachSetBit() and SetBitRange decode at once.
+inline constexpr std::size_t SET_BITS_CHUNK_WORDS = 16;
+
+/**
+ * @brief Invokes f(position) with the position of every one-bit in an array of words in ascending order.
+ * The positions are decoded in chunks of SET_BITS_CHUNK_WORDS words using decodeSetBits().
+ * This is equivalent to, but usually much faster than calling f(i * 64 + countTrailingZeros(word)) and clearing the
+ * lowest one-bit for every word of the array.
+ * @param words the words
+ * @param count the number of words
+ * @param f the function, which is invoked with a std::size_t
+ */
+template <typename F>
+void forEachSetBit(const std::uint64_t words[], std::size_t count, F f)
+{
+    std::uint32_t buffer[SET_BITS_CHUNK_WORDS * 64 + DECODE_SET_BITS_PADDING];
+    for (std::size_t i = 0; i < count; i += SET_BITS_CHUNK_WORDS) {
+        const std::size_t chunk = count - i < SET_BITS_CHUNK_WORDS ? count - i : SET_BITS_CHUNK_WORDS;
+        const std::size_t n = decodeSetBits(words + i, chunk, buffer);
+        for (std::size_t j = 0; j < n; ++j) {
+            f(i * 64 + buffer[j]);
+        }
+    }
+}
+
+class SetBitRange;
+
+/**
+ * @brief An input iterator over the positions of the one-bits of a SetBitRange.
+ * The iterator only refers to the range, which stores the decoded positions and the current one.
+ * Advancing one iterator of a range therefore advances all of them.
+ */
+class SetBitIterator {
+public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const std::size_t *;
+    using reference = std::size_t;
+
+private:
+    SetBitRange *range_ = nullptr;
+
+public:
+    /// Constructs the end iterator.
+    SetBitIterator() = default;
+
+    explicit SetBitIterator(SetBitRange &range) noexcept;
+
+    std::size_t operator*() const noexcept;
+
+    SetBitIterator &operator++() noexcept;
+
+    /// Holds the position before a post-increment, since this iterator can't refer to it anymore.
+    struct PostIncrement {
+        std::size_t position;
+
+        std::size_t operator*() const noexcept
+        {
+            return position;
+        }
+    };
+
+    PostIncrement operator++(int) noexcept
+    {
+        const PostIncrement result{**this};
+        ++*this;
+        return result;
+    }
+
+    bool operator==(const SetBitIterator &other) const noexcept
+    {
+        return range_ == other.range_;
+    }
+
+    bool operator!=(const SetBitIterator &other) const noexcept
+    {
+        return not(*this == other);
+    }
+};
+
+/**
+ * @brief A single-pass range over the positions of the one-bits in an array of words in ascending order.
+ * The positions are decoded in chunks of SET_BITS_CHUNK_WORDS words using decodeSetBits().
+ * Example: for (std::size_t i : SetBitRange{words, count}) { ... }
+ */
+class SetBitRange {
+    friend class SetBitIterator;
+
+private:
+    const std::uint64_t *words_;
+    std::size_t count_;
+    /// The index of the first word of the decoded chunk.
+    std::size_t chunkBegin_ = 0;
+    /// The index of the first word of the next chunk.
+    std::size_t chunkEnd_ = 0;
+    /// The number of decoded positions.
+    std::size_t size_ = 0;
+    /// The index of the current position.
+    std::size_t index_ = 0;
+    std::uint32_t buffer_[SET_BITS_CHUNK_WORDS * 64 + DECODE_SET_BITS_PADDING];
+
+public:
+    /**
+     * @param words the words, which must outlive the range
+     * @param count the number of words
+     */
+    SetBitRange(const std::uint64_t words[], std::size_t count) noexcept : words_{words}, count_{count} {}
+
+    SetBitRange(const SetBitRange &) = delete;
+    SetBitRange &operator=(const SetBitRange &) = delete;
+
+    /// Returns an iterator to the current position, which is the first one unless the range has been iterated over.
+    SetBitIterator begin() noexcept
+    {
+        return SetBitIterator{*this};
+    }
+
+    SetBitIterator end() noexcept
+    {
+        return SetBitIterator{};
+    }
+
+private:
+    /// Decodes chunks until one contains a one-bit, returning false if all words have been decoded.
+    bool decodeNextChunk() noexcept
+    {
+        size_ = 0;
+        index_ = 0;
+        while (size_ == 0 && chunkEnd_ < count_) {
+            chunkBegin_ = chunkEnd_;
+            chunkEnd_ += count_ - chunkEnd_ < SET_BITS_CHUNK_WORDS ? count_ - chunkEnd_ : SET_BITS_CHUNK_WORDS;
+            size_ = decodeSetBits(words_ + chunkBegin_, chunkEnd_ - chunkBegin_, buffer_);
+        }
+        return size_ != 0;
+    }
+};
+
+inline SetBitIterator::SetBitIterator(SetBitRange &range) noexcept
+{
+    if (range.index_ < range.size_ || range.decodeNextChunk()) {
+        range_ = &range;
+    }
+}
+
+inline std::size_t SetBitIterator::operator*() const noexcept
+{
+    return range_->chunkBegin_ * 64 + range_->buffer_[range_->index_];
+}
+
+inline SetBitIterator &SetBitIterator::operator++() noexcept
+{
+    if (++range_->index_ == range_->size_ && not range_->decodeNextChunk()) {
+        range_ = nullptr;
+    }
+    return *this;
+}
+
+}  // namespace bitmanip
+
+#endif  // BITMANIP_SETBITS_HPP
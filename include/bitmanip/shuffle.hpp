@@ -0,0 +1,535 @@
+#ifndef BITMANIP_SHUFFLE_HPP
+#define BITMANIP_SHUFFLE_HPP
+/*
+ * shuffle.hpp
+ * -----------
+ * Provides shuffle filters for buffers of fixed-size elements, which are commonly applied before compression.
+ *
+ * The byte shuffle stores byte k of every element contiguously, which is the byte-granular counterpart of ileaveBytes()
+ * and dileaveBytes_const() in bitileave.hpp, applied to whole buffers instead of a single 64-bit integer.
+ * Slowly varying numbers then produce long runs of similar bytes, which compress much better.
+ *
+ * The bit shuffle goes one step further and stores bit k of every element contiguously (bit planes).
+ */
+
+#include "bittrans.hpp"
+#include "build.hpp"
+#include "builtin.hpp"
+#include "cpu.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+#ifdef BITMANIP_HAS_SIMD_TRANSPOSE
+// the bit shuffle kernels build on the 8x8 transposition kernels
+#define BITMANIP_HAS_SIMD_SHUFFLE
+#endif
+
+namespace bitmanip {
+
+// BYTE SHUFFLING ======================================================================================================
+
+namespace detail {
+
+using byte_type = unsigned char;
+
+constexpr void shuffleBytes_naive(
+    const byte_type src[], byte_type dst[], std::size_t elemSize, std::size_t count, std::size_t i = 0) noexcept
+{
+    for (; i < count; ++i) {
+        for (std::size_t b = 0; b < elemSize; ++b) {
+            dst[b * count + i] = src[i * elemSize + b];
+        }
+    }
+}
+
+constexpr void unshuffleBytes_naive(
+    const byte_type src[], byte_type dst[], std::size_t elemSize, std::size_t count, std::size_t i = 0) noexcept
+{
+    for (; i < count; ++i) {
+        for (std::size_t b = 0; b < elemSize; ++b) {
+            dst[i * elemSize + b] = src[b * count + i];
+        }
+    }
+}
+
+#ifdef BITMANIP_HAS_SIMD_SHUFFLE
+/*
+ * The SIMD kernels transpose a matrix of 16 elements with ELEM_SIZE bytes each, stored in ELEM_SIZE vectors.
+ * The index of each byte consists of log2(ELEM_SIZE) bits for the vector and 4 bits for the position within the vector.
+ * Unpacking the bytes of vector j and vector j + ELEM_SIZE / 2 into vectors 2j and 2j + 1 rotates this index left by
+ * one bit.
+ * The element index comprises the upper 4 bits when loading, so shuffling takes 4 rounds of unpacking and unshuffling
+ * takes log2(ELEM_SIZE) rounds.
+ *
+ * The AVX2 kernels perform the same unpacking on two such matrices at once, one in each 128-bit lane.
+ */
+
+template <std::size_t ELEM_SIZE>
+inline constexpr unsigned SHUFFLE_ELEM_SIZE_LOG2 = ELEM_SIZE == 2 ? 1 : ELEM_SIZE == 4 ? 2 : ELEM_SIZE == 8 ? 3 : 4;
+
+// the rounds are unrolled using fold expressions, so that the vectors can be kept in registers
+template <std::size_t ELEM_SIZE, std::size_t... J>
+inline void unpackRound_sse2(std::index_sequence<J...>, __m128i v[ELEM_SIZE]) noexcept
+{
+    constexpr std::size_t half = ELEM_SIZE / 2;
+    const __m128i t[ELEM_SIZE]{(J % 2 == 0 ? _mm_unpacklo_epi8(v[J / 2], v[J / 2 + half])
+                                           : _mm_unpackhi_epi8(v[J / 2], v[J / 2 + half]))...};
+    ((v[J] = t[J]), ...);
+}
+
+template <std::size_t ELEM_SIZE, std::size_t... R>
+inline void unpackRounds_sse2(std::index_sequence<R...>, __m128i v[ELEM_SIZE]) noexcept
+{
+    ((static_cast<void>(R), unpackRound_sse2<ELEM_SIZE>(std::make_index_sequence<ELEM_SIZE>{}, v)), ...);
+}
+
+template <std::size_t ELEM_SIZE, std::size_t... J>
+BITMANIP_TARGET("avx2")
+inline void unpackRound_avx2(std::index_sequence<J...>, __m256i v[ELEM_SIZE]) noexcept
+{
+    constexpr std::size_t half = ELEM_SIZE / 2;
+    const __m256i t[ELEM_SIZE]{(J % 2 == 0 ? _mm256_unpacklo_epi8(v[J / 2], v[J / 2 + half])
+                                           : _mm256_unpackhi_epi8(v[J / 2], v[J / 2 + half]))...};
+    ((v[J] = t[J]), ...);
+}
+
+template <std::size_t ELEM_SIZE, std::size_t... R>
+BITMANIP_TARGET("avx2")
+inline void unpackRounds_avx2(std::index_sequence<R...>, __m256i v[ELEM_SIZE]) noexcept
+{
+    ((static_cast<void>(R), unpackRound_avx2<ELEM_SIZE>(std::make_index_sequence<ELEM_SIZE>{}, v)), ...);
+}
+
+/// Loads 16 elements and transposes them, so that v[k] contains byte k of every element.
+template <std::size_t ELEM_SIZE>
+inline void loadTransposed_sse2(const byte_type elements[], __m128i v[ELEM_SIZE]) noexcept
+{
+    for (std::size_t j = 0; j < ELEM_SIZE; ++j) {
+        v[j] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(elements + j * 16));
+    }
+    if constexpr (ELEM_SIZE != 1) {
+        unpackRounds_sse2<ELEM_SIZE>(std::make_index_sequence<4>{}, v);
+    }
+}
+
+/// Loads 32 elements and transposes them, so that v[k] contains byte k of every element.
+template <std::size_t ELEM_SIZE>
+BITMANIP_TARGET("avx2")
+inline void loadTransposed_avx2(const byte_type elements[], __m256i v[ELEM_SIZE]) noexcept
+{
+    const byte_type *const hi = elements + 16 * ELEM_SIZE;
+    for (std::size_t j = 0; j < ELEM_SIZE; ++j) {
+        v[j] = _mm256_inserti128_si256(
+            _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(elements + j * 16))),
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(hi + j * 16)),
+            1);
+    }
+    if constexpr (ELEM_SIZE != 1) {
+        unpackRounds_avx2<ELEM_SIZE>(std::make_index_sequence<4>{}, v);
+    }
+}
+
+/// Reverses loadTransposed_sse2() and stores the 16 elements.
+template <std::size_t ELEM_SIZE>
+inline void storeUntransposed_sse2(byte_type elements[], __m128i v[ELEM_SIZE]) noexcept
+{
+    if constexpr (ELEM_SIZE != 1) {
+        unpackRounds_sse2<ELEM_SIZE>(std::make_index_sequence<SHUFFLE_ELEM_SIZE_LOG2<ELEM_SIZE>>{}, v);
+    }
+    for (std::size_t j = 0; j < ELEM_SIZE; ++j) {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(elements + j * 16), v[j]);
+    }
+}
+
+/// Reverses loadTransposed_avx2() and stores the 32 elements.
+template <std::size_t ELEM_SIZE>
+BITMANIP_TARGET("avx2")
+inline void storeUntransposed_avx2(byte_type elements[], __m256i v[ELEM_SIZE]) noexcept
+{
+    if constexpr (ELEM_SIZE != 1) {
+        unpackRounds_avx2<ELEM_SIZE>(std::make_index_sequence<SHUFFLE_ELEM_SIZE_LOG2<ELEM_SIZE>>{}, v);
+    }
+    byte_type *const hi = elements + 16 * ELEM_SIZE;
+    for (std::size_t j = 0; j < ELEM_SIZE; ++j) {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(elements + j * 16), _mm256_castsi256_si128(v[j]));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(hi + j * 16), _mm256_extracti128_si256(v[j], 1));
+    }
+}
+
+/// Returns the number of elements which were shuffled, which is a multiple of 16.
+template <std::size_t ELEM_SIZE>
+inline std::size_t shuffleBytes_sse2(const byte_type src[],
+                                    byte_type dst[],
+                                    std::size_t i,
+                                    std::size_t count) noexcept
+{
+    for (; i + 16 <= count; i += 16) {
+        __m128i v[ELEM_SIZE];
+        loadTransposed_sse2<ELEM_SIZE>(src + i * ELEM_SIZE, v);
+        for (std::size_t b = 0; b < ELEM_SIZE; ++b) {
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + b * count + i), v[b]);
+        }
+    }
+    return i;
+}
+
+template <std::size_t ELEM_SIZE>
+inline std::size_t unshuffleBytes_sse2(const byte_type src[],
+                                      byte_type dst[],
+                                      std::size_t i,
+                                      std::size_t count) noexcept
+{
+    for (; i + 16 <= count; i += 16) {
+        __m128i v[ELEM_SIZE];
+        for (std::size_t b = 0; b < ELEM_SIZE; ++b) {
+            v[b] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + b * count + i));
+        }
+        storeUntransposed_sse2<ELEM_SIZE>(dst + i * ELEM_SIZE, v);
+    }
+    return i;
+}
+
+/// Returns the number of elements which were shuffled, which is a multiple of 32.
+template <std::size_t ELEM_SIZE>
+BITMANIP_TARGET("avx2")
+inline std::size_t shuffleBytes_avx2(const byte_type src[], byte_type dst[], std::size_t count) noexcept
+{
+    std::size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        __m256i v[ELEM_SIZE];
+        loadTransposed_avx2<ELEM_SIZE>(src + i * ELEM_SIZE, v);
+        for (std::size_t b = 0; b < ELEM_SIZE; ++b) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + b * count + i), v[b]);
+        }
+    }
+    return i;
+}
+
+template <std::size_t ELEM_SIZE>
+BITMANIP_TARGET("avx2")
+inline std::size_t unshuffleBytes_avx2(const byte_type src[], byte_type dst[], std::size_t count) noexcept
+{
+    std::size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        __m256i v[ELEM_SIZE];
+        for (std::size_t b = 0; b < ELEM_SIZE; ++b) {
+            v[b] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + b * count + i));
+        }
+        storeUntransposed_avx2<ELEM_SIZE>(dst + i * ELEM_SIZE, v);
+    }
+    return i;
+}
+
+template <std::size_t ELEM_SIZE>
+inline std::size_t shuffleBytes_simd(const byte_type src[], byte_type dst[], std::size_t count) noexcept
+{
+    std::size_t i = 0;
+    if (CPU_FEATURES.avx2) {
+        i = shuffleBytes_avx2<ELEM_SIZE>(src, dst, count);
+    }
+    return shuffleBytes_sse2<ELEM_SIZE>(src, dst, i, count);
+}
+
+template <std::size_t ELEM_SIZE>
+inline std::size_t unshuffleBytes_simd(const byte_type src[], byte_type dst[], std::size_t count) noexcept
+{
+    std::size_t i = 0;
+    if (CPU_FEATURES.avx2) {
+        i = unshuffleBytes_avx2<ELEM_SIZE>(src, dst, count);
+    }
+    return unshuffleBytes_sse2<ELEM_SIZE>(src, dst, i, count);
+}
+#endif
+
+}  // namespace detail
+
+/**
+ * @brief Stores byte k of every element contiguously.
+ * This is equivalent to dst[k * count + i] = src[i * elemSize + k] for every i < count and k < elemSize.
+ *
+ * Element sizes of 2, 4, 8 and 16 bytes are shuffled using SSE2 or AVX2, if available.
+ * @param src the elements
+ * @param dst the shuffled bytes, which must not overlap src
+ * @param elemSize the size of each element in bytes
+ * @param count the number of elements
+ */
+inline void shuffleBytes(const void *src, void *dst, std::size_t elemSize, std::size_t count) noexcept
+{
+    const auto *const s = static_cast<const detail::byte_type *>(src);
+    auto *const d = static_cast<detail::byte_type *>(dst);
+
+    std::size_t i = 0;
+#ifdef BITMANIP_HAS_SIMD_SHUFFLE
+    switch (elemSize) {
+    case 2: i = detail::shuffleBytes_simd<2>(s, d, count); break;
+    case 4: i = detail::shuffleBytes_simd<4>(s, d, count); break;
+    case 8: i = detail::shuffleBytes_simd<8>(s, d, count); break;
+    case 16: i = detail::shuffleBytes_simd<16>(s, d, count); break;
+    }
+#endif
+    detail::shuffleBytes_naive(s, d, elemSize, count, i);
+}
+
+/**
+ * @brief Reverses shuffleBytes().
+ * This is equivalent to dst[i * elemSize + k] = src[k * count + i] for every i < count and k < elemSize.
+ *
+ * Element sizes of 2, 4, 8 and 16 bytes are unshuffled using SSE2 or AVX2, if available.
+ * @param src the shuffled bytes
+ * @param dst the elements, which must not overlap src
+ * @param elemSize the size of each element in bytes
+ * @param count the number of elements
+ */
+inline void unshuffleBytes(const void *src, void *dst, std::size_t elemSize, std::size_t count) noexcept
+{
+    const auto *const s = static_cast<const detail::byte_type *>(src);
+    auto *const d = static_cast<detail::byte_type *>(dst);
+
+    std::size_t i = 0;
+#ifdef BITMANIP_HAS_SIMD_SHUFFLE
+    switch (elemSize) {
+    case 2: i = detail::unshuffleBytes_simd<2>(s, d, count); break;
+    case 4: i = detail::unshuffleBytes_simd<4>(s, d, count); break;
+    case 8: i = detail::unshuffleBytes_simd<8>(s, d, count); break;
+    case 16: i = detail::unshuffleBytes_simd<16>(s, d, count); break;
+    }
+#endif
+    detail::unshuffleBytes_naive(s, d, elemSize, count, i);
+}
+
+// BIT SHUFFLING =======================================================================================================
+
+namespace detail {
+
+// count must be a multiple of 8 for all of the following functions
+
+constexpr void shuffleBits_naive(
+    const byte_type src[], byte_type dst[], std::size_t elemSize, std::size_t count, std::size_t i = 0) noexcept
+{
+    const std::size_t planeSize = count / 8;
+    for (; i < count; i += 8) {
+        for (std::size_t b = 0; b < elemSize; ++b) {
+            std::uint64_t rows = 0;
+            for (std::size_t r = 0; r < 8; ++r) {
+                rows |= std::uint64_t{src[(i + r) * elemSize + b]} << (r * 8);
+            }
+            const std::uint64_t columns = transpose8x8_shift(rows);
+            for (std::size_t j = 0; j < 8; ++j) {
+                dst[(b * 8 + j) * planeSize + i / 8] = static_cast<byte_type>(columns >> (j * 8));
+            }
+        }
+    }
+}
+
+constexpr void unshuffleBits_naive(
+    const byte_type src[], byte_type dst[], std::size_t elemSize, std::size_t count, std::size_t i = 0) noexcept
+{
+    const std::size_t planeSize = count / 8;
+    for (; i < count; i += 8) {
+        for (std::size_t b = 0; b < elemSize; ++b) {
+            std::uint64_t columns = 0;
+            for (std::size_t j = 0; j < 8; ++j) {
+                columns |= std::uint64_t{src[(b * 8 + j) * planeSize + i / 8]} << (j * 8);
+            }
+            const std::uint64_t rows = transpose8x8_shift(columns);
+            for (std::size_t r = 0; r < 8; ++r) {
+                dst[(i + r) * elemSize + b] = static_cast<byte_type>(rows >> (r * 8));
+            }
+        }
+    }
+}
+
+#ifdef BITMANIP_HAS_SIMD_SHUFFLE
+/*
+ * After transposing the bytes, movemask extracts the uppermost bit of every byte, which is one bit plane.
+ * Adding each vector to itself then shifts the next lower bit into place.
+ */
+
+template <std::size_t ELEM_SIZE>
+inline std::size_t shuffleBits_sse2(const byte_type src[], byte_type dst[], std::size_t i, std::size_t count) noexcept
+{
+    const std::size_t planeSize = count / 8;
+    for (; i + 16 <= count; i += 16) {
+        __m128i v[ELEM_SIZE];
+        loadTransposed_sse2<ELEM_SIZE>(src + i * ELEM_SIZE, v);
+        for (std::size_t b = 0; b < ELEM_SIZE; ++b) {
+            __m128i x = v[b];
+            for (std::size_t j = 8; j-- != 0;) {
+                const auto plane = static_cast<std::uint16_t>(_mm_movemask_epi8(x));
+                std::memcpy(dst + (b * 8 + j) * planeSize + i / 8, &plane, sizeof(plane));
+                x = _mm_add_epi8(x, x);
+            }
+        }
+    }
+    return i;
+}
+
+template <std::size_t ELEM_SIZE>
+BITMANIP_TARGET("avx2")
+inline std::size_t shuffleBits_avx2(const byte_type src[], byte_type dst[], std::size_t count) noexcept
+{
+    const std::size_t planeSize = count / 8;
+    std::size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        __m256i v[ELEM_SIZE];
+        loadTransposed_avx2<ELEM_SIZE>(src + i * ELEM_SIZE, v);
+        for (std::size_t b = 0; b < ELEM_SIZE; ++b) {
+            __m256i x = v[b];
+            for (std::size_t j = 8; j-- != 0;) {
+                const auto plane = static_cast<std::uint32_t>(_mm256_movemask_epi8(x));
+                std::memcpy(dst + (b * 8 + j) * planeSize + i / 8, &plane, sizeof(plane));
+                x = _mm256_add_epi8(x, x);
+            }
+        }
+    }
+    return i;
+}
+
+/*
+ * Unshuffling gathers the bytes of the 8 bit planes of each byte k, so that every 64-bit lane holds one 8x8 bit matrix
+ * with one plane per byte.
+ * Transposing these matrices yields byte k of every element, which is then transposed back into whole elements.
+ */
+
+template <std::size_t ELEM_SIZE>
+inline std::size_t unshuffleBits_sse2(const byte_type src[],
+                                      byte_type dst[],
+                                      std::size_t i,
+                                      std::size_t count) noexcept
+{
+    const std::size_t planeSize = count / 8;
+    for (; i + 16 <= count; i += 16) {
+        __m128i v[ELEM_SIZE];
+        for (std::size_t b = 0; b < ELEM_SIZE; ++b) {
+            const byte_type *const planes = src + b * 8 * planeSize + i / 8;
+            std::int16_t p[8];
+            for (std::size_t j = 0; j < 8; ++j) {
+                std::memcpy(p + j, planes + j * planeSize, sizeof(p[j]));
+            }
+            const __m128i x = _mm_setr_epi16(p[0], p[1], p[2], p[3], p[4], p[5], p[6], p[7]);
+            // gather the first byte of every plane in the lower half, the second byte in the upper half
+            const __m128i lo = _mm_and_si128(x, _mm_set1_epi16(0xff));
+            v[b] = transpose8x8_sse2(_mm_packus_epi16(lo, _mm_srli_epi16(x, 8)));
+        }
+        storeUntransposed_sse2<ELEM_SIZE>(dst + i * ELEM_SIZE, v);
+    }
+    return i;
+}
+
+template <std::size_t ELEM_SIZE>
+BITMANIP_TARGET("avx2")
+inline std::size_t unshuffleBits_avx2(const byte_type src[], byte_type dst[], std::size_t count) noexcept
+{
+    const std::size_t planeSize = count / 8;
+    // transposes the 4x4 bytes of each 128-bit lane, then interleaves the dwords of both lanes
+    const __m256i byteOrder = _mm256_setr_epi8(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15,
+                                               0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+    const __m256i dwordOrder = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+    std::size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        __m256i v[ELEM_SIZE];
+        for (std::size_t b = 0; b < ELEM_SIZE; ++b) {
+            const byte_type *const planes = src + b * 8 * planeSize + i / 8;
+            std::int32_t p[8];
+            for (std::size_t j = 0; j < 8; ++j) {
+                std::memcpy(p + j, planes + j * planeSize, sizeof(p[j]));
+            }
+            __m256i x = _mm256_setr_epi32(p[0], p[1], p[2], p[3], p[4], p[5], p[6], p[7]);
+            x = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(x, byteOrder), dwordOrder);
+            v[b] = transpose8x8_avx2(x);
+        }
+        storeUntransposed_avx2<ELEM_SIZE>(dst + i * ELEM_SIZE, v);
+    }
+    return i;
+}
+
+template <std::size_t ELEM_SIZE>
+inline std::size_t shuffleBits_simd(const byte_type src[], byte_type dst[], std::size_t count) noexcept
+{
+    std::size_t i = 0;
+    if (CPU_FEATURES.avx2) {
+        i = shuffleBits_avx2<ELEM_SIZE>(src, dst, count);
+    }
+    return shuffleBits_sse2<ELEM_SIZE>(src, dst, i, count);
+}
+
+template <std::size_t ELEM_SIZE>
+inline std::size_t unshuffleBits_simd(const byte_type src[], byte_type dst[], std::size_t count) noexcept
+{
+    std::size_t i = 0;
+    if (CPU_FEATURES.avx2) {
+        i = unshuffleBits_avx2<ELEM_SIZE>(src, dst, count);
+    }
+    return unshuffleBits_sse2<ELEM_SIZE>(src, dst, i, count);
+}
+#endif
+
+}  // namespace detail
+
+/**
+ * @brief Stores bit k of every element contiguously.
+ * Bit k of element i is stored in bit (k * n + i) of dst, where n is count rounded down to a multiple of 8.
+ * The remaining count % 8 elements are copied to the end of dst unchanged.
+ *
+ * Element sizes of 1, 2, 4, 8 and 16 bytes are shuffled using SSE2 or AVX2, if available.
+ * Otherwise, every group of 8 bytes is transposed as an 8x8 bit matrix.
+ * @param src the elements
+ * @param dst the shuffled bits, which must not overlap src
+ * @param elemSize the size of each element in bytes
+ * @param count the number of elements
+ */
+inline void shuffleBits(const void *src, void *dst, std::size_t elemSize, std::size_t count) noexcept
+{
+    const auto *const s = static_cast<const detail::byte_type *>(src);
+    auto *const d = static_cast<detail::byte_type *>(dst);
+    const std::size_t n = count / 8 * 8;
+
+    std::size_t i = 0;
+#ifdef BITMANIP_HAS_SIMD_SHUFFLE
+    switch (elemSize) {
+    case 1: i = detail::shuffleBits_simd<1>(s, d, n); break;
+    case 2: i = detail::shuffleBits_simd<2>(s, d, n); break;
+    case 4: i = detail::shuffleBits_simd<4>(s, d, n); break;
+    case 8: i = detail::shuffleBits_simd<8>(s, d, n); break;
+    case 16: i = detail::shuffleBits_simd<16>(s, d, n); break;
+    }
+#endif
+    detail::shuffleBits_naive(s, d, elemSize, n, i);
+    std::memcpy(d + n * elemSize, s + n * elemSize, (count - n) * elemSize);
+}
+
+/**
+ * @brief Reverses shuffleBits().
+ * Element sizes of 1, 2, 4, 8 and 16 bytes are unshuffled using SSE2 or AVX2, if available.
+ * @param src the shuffled bits
+ * @param dst the elements, which must not overlap src
+ * @param elemSize the size of each element in bytes
+ * @param count the number of elements
+ */
+inline void unshuffleBits(const void *src, void *dst, std::size_t elemSize, std::size_t count) noexcept
+{
+    const auto *const s = static_cast<const detail::byte_type *>(src);
+    auto *const d = static_cast<detail::byte_type *>(dst);
+    const std::size_t n = count / 8 * 8;
+
+    std::size_t i = 0;
+#ifdef BITMANIP_HAS_SIMD_SHUFFLE
+    switch (elemSize) {
+    case 1: i = detail::unshuffleBits_simd<1>(s, d, n); break;
+    case 2: i = detail::unshuffleBits_simd<2>(s, d, n); break;
+    case 4: i = detail::unshuffleBits_simd<4>(s, d, n); break;
+    case 8: i = detail::unshuffleBits_simd<8>(s, d, n); break;
+    case 16: i = detail::unshuffleBits_simd<16>(s, d, n); break;
+    }
+#endif
+    detail::unshuffleBits_naive(s, d, elemSize, n, i);
+    std::memcpy(d + n * elemSize, s + n * elemSize, (count - n) * elemSize);
+}
+
+}  // namespace bitmanip
+
+#endif  // BITMANIP_SHUFFLE_HPP
@@ -1,269 +1,808 @@
-#ifndef WBITS_HPP
-#define WBITS_HPP
-
-#include "bits.hpp"
-
-namespace voxelio::wide {
+#ifndef BITMANIP_WBITS_HPP
+#define BITMANIP_WBITS_HPP
+/*
+ * wbits.hpp
+ * -----------
+ * Provides bitwise operations on wide integers, which are stored as arrays of unsigned integers where the element 0
+ * holds the least significant bits.
+ * On top of these, wide::Bits is a bitset with a size that is known at compile time and wide::DynamicBits is a bitset
+ * with a size that is chosen at runtime.
+ *
+ * Operations on arrays of std::uint64_t use AVX2 if available, which is chosen at runtime.
+ */
+
+#include "bit.hpp"
+#include "bitcount.hpp"
+#include "build.hpp"
+#include "builtin.hpp"
+#include "cpu.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#if defined(BITMANIP_X64) && (defined(BITMANIP_MSVC) || defined(BITMANIP_GNU_OR_CLANG))
+// AVX2 is detected at runtime
+#define BITMANIP_HAS_SIMD_WIDE_BITS
+#endif
+
+namespace bitmanip::wide {
+
+// WIDE BITWISE OPERATIONS =============================================================================================
+
+namespace detail {
+
+using bitmanip::detail::BitwiseOp;
+
+#ifdef BITMANIP_HAS_SIMD_WIDE_BITS
+template <BitwiseOp OP>
+BITMANIP_TARGET("avx2")
+inline void bitwiseAssign_avx2(std::uint64_t dest[], const std::uint64_t src[], std::size_t count) noexcept
+{
+    auto *const d = reinterpret_cast<__m256i *>(dest);
+    const auto *const s = reinterpret_cast<const __m256i *>(src);
+    const std::size_t vectorCount = count / 4;
+    for (std::size_t v = 0; v < vectorCount; ++v) {
+        _mm256_storeu_si256(d + v, bitmanip::detail::loadBitwiseOp_avx2<OP>(d, s, v));
+    }
+    for (std::size_t i = vectorCount * 4; i < count; ++i) {
+        dest[i] = bitmanip::detail::applyBitwiseOp<OP>(dest[i], src[i]);
+    }
+}
 
-template <typename Int, std::enable_if_t<std::is_integral_v<Int>, int> = 0>
-constexpr usize popCount(const Int input[], usize count)
+BITMANIP_TARGET("avx2")
+inline void bitNot_avx2(std::uint64_t dest[], std::size_t count) noexcept
 {
-    usize result = 0;
-    for (usize i = 0; i < count; ++i) {
-        result += voxelio::popCount(input[i]);
+    auto *const d = reinterpret_cast<__m256i *>(dest);
+    const __m256i ones = _mm256_set1_epi64x(-1);
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        _mm256_storeu_si256(d + i / 4, _mm256_xor_si256(_mm256_loadu_si256(d + i / 4), ones));
+    }
+    for (; i < count; ++i) {
+        dest[i] = ~dest[i];
     }
-    return result;
 }
 
-template <typename Int, std::enable_if_t<std::is_integral_v<Int>, int> = 0>
-constexpr void bitClear(Int dest[], usize count)
+/// Returns the index of the first nonzero element in [begin, count), or count if there is none.
+BITMANIP_TARGET("avx2")
+inline std::size_t findNonZero_avx2(const std::uint64_t input[], std::size_t begin, std::size_t count) noexcept
 {
-    for (usize i = 0; i < count; ++i) {
-        dest[i] = 0;
+    std::size_t i = begin;
+    for (; i + 8 <= count; i += 8) {
+        const __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(input + i));
+        const __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(input + i + 4));
+        const __m256i any = _mm256_or_si256(lo, hi);
+        if (not _mm256_testz_si256(any, any)) {
+            break;
+        }
+    }
+    for (; i < count; ++i) {
+        if (input[i] != 0) {
+            return i;
+        }
     }
+    return count;
 }
 
-template <typename Int, std::enable_if_t<std::is_integral_v<Int>, int> = 0>
-constexpr void bitNot(Int out[], usize count)
+/**
+ * @brief Performs dest[i] = (dest[i - words] << bits) | (dest[i - words - 1] >> (64 - bits)) from the top down.
+ * This is done for as many vectors as possible, where bits must be in [1, 63].
+ * @return the exclusive upper bound of the elements which still have to be shifted
+ */
+BITMANIP_TARGET("avx2")
+inline std::size_t leftShift_avx2(std::uint64_t dest[], std::size_t words, unsigned bits, std::size_t count) noexcept
 {
-    for (usize i = 0; i < count; ++i) {
-        out[i] = ~out[i];
+    const __m128i l = _mm_cvtsi32_si128(static_cast<int>(bits));
+    const __m128i r = _mm_cvtsi32_si128(static_cast<int>(64 - bits));
+    std::size_t i = count;
+    // every element which is loaded lies below the ones which have been stored so far
+    for (; i >= words + 5; i -= 4) {
+        const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dest + i - 4 - words));
+        const __m256i below = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dest + i - 5 - words));
+        const __m256i result = _mm256_or_si256(_mm256_sll_epi64(x, l), _mm256_srl_epi64(below, r));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dest + i - 4), result);
     }
+    return i;
 }
 
-template <typename Int, std::enable_if_t<std::is_integral_v<Int>, int> = 0>
-constexpr void bitAnd(Int dest[], const Int r[], usize count)
+/**
+ * @brief Performs dest[i] = (dest[i + words] >> bits) | (dest[i + words + 1] << (64 - bits)) from the bottom up.
+ * This is done for as many vectors as possible, where bits must be in [1, 63].
+ * @return the first element which still has to be shifted
+ */
+BITMANIP_TARGET("avx2")
+inline std::size_t rightShift_avx2(std::uint64_t dest[], std::size_t words, unsigned bits, std::size_t count) noexcept
 {
-    for (usize i = 0; i < count; ++i) {
-        dest[i] &= r[i];
+    const __m128i r = _mm_cvtsi32_si128(static_cast<int>(bits));
+    const __m128i l = _mm_cvtsi32_si128(static_cast<int>(64 - bits));
+    std::size_t i = 0;
+    // every element which is loaded lies above the ones which have been stored so far
+    for (; i + words + 5 <= count; i += 4) {
+        const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dest + i + words));
+        const __m256i above = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dest + i + words + 1));
+        const __m256i result = _mm256_or_si256(_mm256_srl_epi64(x, r), _mm256_sll_epi64(above, l));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dest + i), result);
     }
+    return i;
 }
+#endif
 
-template <typename Int, std::enable_if_t<std::is_integral_v<Int>, int> = 0>
-constexpr void bitOr(Int dest[], const Int r[], usize count)
+template <BitwiseOp OP, typename Uint>
+constexpr void bitwiseAssign(Uint dest[], const Uint src[], std::size_t count) noexcept
 {
-    for (usize i = 0; i < count; ++i) {
-        dest[i] |= r[i];
+#ifdef BITMANIP_HAS_SIMD_WIDE_BITS
+    if constexpr (std::is_same_v<Uint, std::uint64_t>) {
+        if (not builtin::isconsteval() && CPU_FEATURES.avx2) {
+            bitwiseAssign_avx2<OP>(dest, src, count);
+            return;
+        }
+    }
+#endif
+    for (std::size_t i = 0; i < count; ++i) {
+        dest[i] = static_cast<Uint>(bitmanip::detail::applyBitwiseOp<OP>(dest[i], src[i]));
     }
 }
 
-template <typename Int, std::enable_if_t<std::is_integral_v<Int>, int> = 0>
-constexpr void bitXor(Int dest[], const Int r[], usize count)
+}  // namespace detail
+
+/// Returns the number of one-bits in a wide integer.
+template <BITMANIP_UNSIGNED_TYPENAME(Uint)>
+[[nodiscard]] constexpr std::size_t popCount(const Uint input[], std::size_t count) noexcept
 {
-    for (usize i = 0; i < count; ++i) {
-        dest[i] ^= r[i];
+    if constexpr (std::is_same_v<Uint, std::uint64_t>) {
+        return bitmanip::popCount(input, count);
+    }
+    else {
+        std::size_t result = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            result += bitmanip::popCount(input[i]);
+        }
+        return result;
     }
 }
 
-template <typename Int, std::enable_if_t<std::is_unsigned_v<Int>, int> = 0>
-constexpr void leftShift(Int dest[], Int shift, usize count)
+/// Returns the index of the first nonzero element in [begin, count), or count if there is none.
+template <BITMANIP_UNSIGNED_TYPENAME(Uint)>
+[[nodiscard]] constexpr std::size_t findNonZero(const Uint input[], std::size_t begin, std::size_t count) noexcept
 {
-    constexpr usize typeBits = sizeof(Int) * 8;
+#ifdef BITMANIP_HAS_SIMD_WIDE_BITS
+    if constexpr (std::is_same_v<Uint, std::uint64_t>) {
+        if (not builtin::isconsteval() && CPU_FEATURES.avx2) {
+            return detail::findNonZero_avx2(input, begin, count);
+        }
+    }
+#endif
+    for (std::size_t i = begin; i < count; ++i) {
+        if (input[i] != 0) {
+            return i;
+        }
+    }
+    return count;
+}
 
-    VXIO_DEBUG_ASSERT_NE(count, 0u);
+template <BITMANIP_UNSIGNED_TYPENAME(Uint)>
+constexpr void bitClear(Uint dest[], std::size_t count) noexcept
+{
+    for (std::size_t i = 0; i < count; ++i) {
+        dest[i] = 0;
+    }
+}
 
-    for (; shift >= typeBits; shift -= typeBits) {
-        for (usize i = count; i-- > 1;) {
-            dest[i] = dest[i - 1];
+template <BITMANIP_UNSIGNED_TYPENAME(Uint)>
+constexpr void bitNot(Uint dest[], std::size_t count) noexcept
+{
+#ifdef BITMANIP_HAS_SIMD_WIDE_BITS
+    if constexpr (std::is_same_v<Uint, std::uint64_t>) {
+        if (not builtin::isconsteval() && CPU_FEATURES.avx2) {
+            detail::bitNot_avx2(dest, count);
+            return;
         }
-        dest[0] = 0;
     }
-
-    if (shift == 0) {
-        return;
+#endif
+    for (std::size_t i = 0; i < count; ++i) {
+        dest[i] = static_cast<Uint>(~dest[i]);
     }
+}
 
-    Int carryMask = ~(~Int{0} << shift);
+/// Performs dest &= src, where dest and src must be equal or not overlap.
+template <BITMANIP_UNSIGNED_TYPENAME(Uint)>
+constexpr void bitAnd(Uint dest[], const Uint src[], std::size_t count) noexcept
+{
+    detail::bitwiseAssign<detail::BitwiseOp::AND>(dest, src, count);
+}
 
-    dest[count - 1] <<= shift;
+/// Performs dest |= src, where dest and src must be equal or not overlap.
+template <BITMANIP_UNSIGNED_TYPENAME(Uint)>
+constexpr void bitOr(Uint dest[], const Uint src[], std::size_t count) noexcept
+{
+    detail::bitwiseAssign<detail::BitwiseOp::OR>(dest, src, count);
+}
 
-    for (usize i = count - 1; i-- > 0;) {
-        Int shifted = voxelio::leftRot(dest[i], static_cast<unsigned char>(shift));
-        dest[i + 0] = shifted & ~carryMask;
-        dest[i + 1] = shifted & carryMask;
-    }
+/// Performs dest ^= src, where dest and src must be equal or not overlap.
+template <BITMANIP_UNSIGNED_TYPENAME(Uint)>
+constexpr void bitXor(Uint dest[], const Uint src[], std::size_t count) noexcept
+{
+    detail::bitwiseAssign<detail::BitwiseOp::XOR>(dest, src, count);
 }
 
-template <typename Int, std::enable_if_t<std::is_unsigned_v<Int>, int> = 0>
-constexpr void rightShift(Int dest[], Int shift, usize count)
+/// Performs dest &= ~src, where dest and src must be equal or not overlap.
+template <BITMANIP_UNSIGNED_TYPENAME(Uint)>
+constexpr void bitAndNot(Uint dest[], const Uint src[], std::size_t count) noexcept
 {
-    constexpr usize typeBits = sizeof(Int) * 8;
+    detail::bitwiseAssign<detail::BitwiseOp::AND_NOT>(dest, src, count);
+}
 
-    VXIO_DEBUG_ASSERT_NE(count, 0u);
+/**
+ * @brief Shifts a wide integer to the left, towards its most significant bits.
+ * Bits which are shifted past the last element are discarded.
+ * @param dest the wide integer
+ * @param shift the number of bits, which may be greater than the number of bits of the wide integer
+ * @param count the number of elements
+ */
+template <BITMANIP_UNSIGNED_TYPENAME(Uint)>
+constexpr void leftShift(Uint dest[], std::size_t shift, std::size_t count) noexcept
+{
+    constexpr std::size_t typeBits = bits_v<Uint>;
+    const std::size_t words = shift / typeBits;
+    const auto bits = static_cast<unsigned>(shift % typeBits);
+    if (words >= count) {
+        bitClear(dest, count);
+        return;
+    }
 
-    for (; shift >= typeBits; shift -= typeBits) {
-        for (usize i = 0; i < count - 1; ++i) {
-            dest[i] = dest[i + 1];
+    if (bits == 0) {
+        for (std::size_t i = count; i-- > words;) {
+            dest[i] = dest[i - words];
         }
-        dest[count - 1] = 0;
     }
+    else {
+        std::size_t i = count;
+#ifdef BITMANIP_HAS_SIMD_WIDE_BITS
+        if constexpr (std::is_same_v<Uint, std::uint64_t>) {
+            if (not builtin::isconsteval() && CPU_FEATURES.avx2) {
+                i = detail::leftShift_avx2(dest, words, bits, count);
+            }
+        }
+#endif
+        for (; i-- > words + 1;) {
+            const auto below = static_cast<Uint>(dest[i - words - 1] >> (typeBits - bits));
+            dest[i] = static_cast<Uint>(dest[i - words] << bits) | below;
+        }
+        dest[words] = static_cast<Uint>(dest[0] << bits);
+    }
+    bitClear(dest, words);
+}
 
-    if (shift == 0) {
+/**
+ * @brief Shifts a wide integer to the right, towards its least significant bits.
+ * Bits which are shifted past the first element are discarded.
+ * @param dest the wide integer
+ * @param shift the number of bits, which may be greater than the number of bits of the wide integer
+ * @param count the number of elements
+ */
+template <BITMANIP_UNSIGNED_TYPENAME(Uint)>
+constexpr void rightShift(Uint dest[], std::size_t shift, std::size_t count) noexcept
+{
+    constexpr std::size_t typeBits = bits_v<Uint>;
+    const std::size_t words = shift / typeBits;
+    const auto bits = static_cast<unsigned>(shift % typeBits);
+    if (words >= count) {
+        bitClear(dest, count);
         return;
     }
 
-    Int carryMask = ~(~Int{0} >> shift);
-
-    dest[0] >>= shift;
-
-    for (usize i = 1; i < count; ++i) {
-        Int shifted = voxelio::rightRot(dest[i], static_cast<unsigned char>(shift));
-        dest[i - 0] = shifted & ~carryMask;
-        dest[i - 1] = shifted & carryMask;
+    if (bits == 0) {
+        for (std::size_t i = 0; i + words < count; ++i) {
+            dest[i] = dest[i + words];
+        }
+    }
+    else {
+        std::size_t i = 0;
+#ifdef BITMANIP_HAS_SIMD_WIDE_BITS
+        if constexpr (std::is_same_v<Uint, std::uint64_t>) {
+            if (not builtin::isconsteval() && CPU_FEATURES.avx2) {
+                i = detail::rightShift_avx2(dest, words, bits, count);
+            }
+        }
+#endif
+        for (; i + words + 1 < count; ++i) {
+            const auto above = static_cast<Uint>(dest[i + words + 1] << (typeBits - bits));
+            dest[i] = static_cast<Uint>(dest[i + words] >> bits) | above;
+        }
+        dest[count - 1 - words] = static_cast<Uint>(dest[count - 1] >> bits);
     }
+    bitClear(dest + count - words, words);
 }
 
-template <usize BITS, std::enable_if_t<BITS != 0, int> = 0>
+// FIXED-SIZE BITSET ===================================================================================================
+
+/**
+ * @brief A bitset of BITS bits, where bit i is bit i % 64 of element i / 64.
+ * The bits past BITS in the last element are always zero.
+ */
+template <std::size_t BITS>
 class Bits {
+    static_assert(BITS != 0, "Bits must have at least one bit");
+
 public:
-    using valueType = uintmax_t;
+    using valueType = std::uint64_t;
 
 private:
-    /** the size in value types of this BitVec */
-    static constexpr usize size_ = divCeil(BITS, sizeof(valueType) * 8);
-    /** the number of bits that spill into the topmost element (0 if none) */
-    static constexpr usize bitSpill = BITS % (sizeof(valueType) * size_);
-    /** the bit mask of the spillage into the topmost element or 0b111...111 if there is no spillage */
-    static constexpr usize spillMask = ~valueType{0} << bitSpill;
+    /// The size in elements.
+    static constexpr std::size_t size_ = (BITS + 63) / 64;
+    /// The number of bits in the last element, or 0 if it's full.
+    static constexpr std::size_t bitSpill = BITS % 64;
+    /// The mask of the bits of the last element which belong to the bitset.
+    static constexpr valueType spillMask = bitSpill == 0 ? ~valueType{0} : ~(~valueType{0} << bitSpill);
 
-    constexpr void fixBack()
+    valueType data_[size_]{};
+
+    constexpr void fixBack() noexcept
     {
-        data_[size() - 1] &= spillMask;
+        data_[size_ - 1] &= spillMask;
     }
 
-    valueType data_[size_];
-
 public:
-    constexpr Bits() = default;
-    constexpr Bits(const Bits &) = default;
-    constexpr Bits(Bits &&) = default;
+    constexpr Bits() noexcept = default;
 
-    constexpr Bits(valueType value) : data_{}
+    constexpr Bits(valueType value) noexcept : data_{}
     {
         data_[0] = value;
         fixBack();
     }
 
-    constexpr valueType *data()
+    constexpr valueType *data() noexcept
     {
         return data_;
     }
 
-    constexpr const valueType *data() const
+    constexpr const valueType *data() const noexcept
     {
         return data_;
     }
 
-    constexpr usize size() const
+    /// Returns the number of elements.
+    constexpr std::size_t size() const noexcept
     {
         return size_;
     }
 
-    void clear()
+    constexpr void clear() noexcept
     {
-        for (usize i = 0; i < size(); ++i) {
-            data_[i] = 0;
-        }
+        wide::bitClear(data_, size_);
+    }
+
+    constexpr std::size_t count() const noexcept
+    {
+        return wide::popCount(data_, size_);
     }
 
     // UNARY OPERATORS =================================================================================================
 
-    constexpr operator bool()
+    constexpr explicit operator bool() const noexcept
     {
-        for (usize i = 0; i < size(); ++i) {
-            if (data_[i]) return true;
-        }
-        return false;
+        return wide::findNonZero(data_, 0, size_) != size_;
     }
 
-    constexpr Bits &operator~()
+    constexpr Bits operator~() const noexcept
     {
-        wide::bitNot(data(), size());
-        fixBack();
-        return *this;
+        Bits copy = *this;
+        wide::bitNot(copy.data_, size_);
+        copy.fixBack();
+        return copy;
     }
 
     // ASSIGNMENT OPERATORS ============================================================================================
 
-    constexpr Bits &operator=(const Bits &) = default;
-    constexpr Bits &operator=(Bits &&) = default;
-
-    constexpr Bits &operator=(valueType value)
+    constexpr Bits &operator=(valueType value) noexcept
     {
         clear();
         data_[0] = value;
+        fixBack();
         return *this;
     }
 
-    constexpr Bits &operator&=(Bits other)
+    constexpr Bits &operator&=(const Bits &other) noexcept
     {
-        wide::bitAnd(data(), other.data(), size());
+        wide::bitAnd(data_, other.data_, size_);
         return *this;
     }
 
-    constexpr Bits &operator|=(Bits other)
+    constexpr Bits &operator|=(const Bits &other) noexcept
     {
-        wide::bitOr(data(), other.data(), size());
+        wide::bitOr(data_, other.data_, size_);
         return *this;
     }
 
-    constexpr Bits &operator^=(Bits other)
+    constexpr Bits &operator^=(const Bits &other) noexcept
     {
-        wide::bitXor(data(), other.data(), size());
+        wide::bitXor(data_, other.data_, size_);
         return *this;
     }
 
-    constexpr Bits &operator<<=(valueType shift)
+    constexpr Bits &operator<<=(std::size_t shift) noexcept
     {
-        wide::leftShift(data(), shift, size());
+        wide::leftShift(data_, shift, size_);
         fixBack();
         return *this;
     }
 
-    constexpr Bits &operator>>=(valueType shift)
+    constexpr Bits &operator>>=(std::size_t shift) noexcept
     {
-        wide::rightShift(data(), shift, size());
+        wide::rightShift(data_, shift, size_);
         return *this;
     }
 
     // BINARY OPERATORS ================================================================================================
 
-    constexpr Bits operator&(Bits other)
+    constexpr Bits operator&(Bits other) const noexcept
     {
-        wide::bitAnd(other.data(), data(), size());
-        return other;
+        return other &= *this;
     }
 
-    constexpr Bits operator|(Bits other)
+    constexpr Bits operator|(Bits other) const noexcept
     {
-        wide::bitOr(other.data(), data(), size());
-        return other;
+        return other |= *this;
     }
 
-    constexpr Bits operator^(Bits other)
+    constexpr Bits operator^(Bits other) const noexcept
     {
-        wide::bitXor(other.data(), data(), size());
-        return other;
+        return other ^= *this;
     }
 
-    constexpr Bits operator<<(valueType shift)
+    constexpr Bits operator<<(std::size_t shift) const noexcept
     {
         Bits copy = *this;
-        wide::leftShift(copy.data(), shift, size());
-        copy.fixBack();
-        return copy;
+        return copy <<= shift;
     }
 
-    constexpr Bits operator>>(valueType shift)
+    constexpr Bits operator>>(std::size_t shift) const noexcept
     {
         Bits copy = *this;
-        wide::rightShift(copy.data(), shift, size());
-        return copy;
+        return copy >>= shift;
+    }
+
+    constexpr bool operator==(const Bits &other) const noexcept
+    {
+        for (std::size_t i = 0; i < size_; ++i) {
+            if (data_[i] != other.data_[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    constexpr bool operator!=(const Bits &other) const noexcept
+    {
+        return not(*this == other);
+    }
+};
+
+// DYNAMIC BITSET ======================================================================================================
+
+namespace detail {
+
+/// An allocator which aligns its allocations to ALIGNMENT bytes.
+template <typename T, std::size_t ALIGNMENT>
+struct AlignedAllocator {
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, ALIGNMENT>;
+    };
+
+    AlignedAllocator() noexcept = default;
+
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, ALIGNMENT> &) noexcept
+    {
+    }
+
+    [[nodiscard]] T *allocate(std::size_t n)
+    {
+        return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t{ALIGNMENT}));
+    }
+
+    void deallocate(T *p, std::size_t) noexcept
+    {
+        ::operator delete(p, std::align_val_t{ALIGNMENT});
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, ALIGNMENT> &) const noexcept
+    {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, ALIGNMENT> &) const noexcept
+    {
+        return false;
     }
 };
 
-template class Bits<128>;
+}  // namespace detail
+
+/**
+ * @brief A bitset with a size that is chosen at runtime, where bit i is bit i % 64 of element i / 64.
+ * The elements are aligned to cache lines, and the bits past size() in the last element are always zero.
+ *
+ * Binary operations require both operands to have the same size.
+ */
+class DynamicBits {
+public:
+    using valueType = std::uint64_t;
+
+    /// The alignment of the elements in bytes, which is the size of a cache line and of an AVX-512 vector.
+    static constexpr std::size_t ALIGNMENT = 64;
+
+private:
+    std::vector<valueType, detail::AlignedAllocator<valueType, ALIGNMENT>> data_;
+    std::size_t size_ = 0;
+
+public:
+    /// Constructs an empty bitset.
+    DynamicBits() noexcept = default;
+
+    /**
+     * @brief Constructs a bitset of the given size, where every bit is set to value.
+     * @throws std::bad_alloc if the bits can't be allocated
+     */
+    explicit DynamicBits(std::size_t size, bool value = false)
+        : data_((size + 63) / 64, value ? ~valueType{0} : 0), size_(size)
+    {
+        fixBack();
+    }
+
+    /// Returns the number of bits.
+    std::size_t size() const noexcept
+    {
+        return size_;
+    }
+
+    bool empty() const noexcept
+    {
+        return size_ == 0;
+    }
+
+    /// Returns the number of elements.
+    std::size_t wordCount() const noexcept
+    {
+        return data_.size();
+    }
+
+    valueType *data() noexcept
+    {
+        return data_.data();
+    }
+
+    const valueType *data() const noexcept
+    {
+        return data_.data();
+    }
+
+    /**
+     * @brief Changes the number of bits.
+     * Bits past the new size are discarded, new bits are set to value.
+     * @throws std::bad_alloc if the bits can't be allocated
+     */
+    void resize(std::size_t size, bool value = false)
+    {
+        const std::size_t oldSize = size_;
+        data_.resize((size + 63) / 64, value ? ~valueType{0} : 0);
+        size_ = size;
+        if (value && size > oldSize && oldSize % 64 != 0) {
+            data_[oldSize / 64] |= ~valueType{0} << (oldSize % 64);
+        }
+        fixBack();
+    }
+
+    // SINGLE BITS =====================================================================================================
+
+    /// Returns bit i, where i < size().
+    bool operator[](std::size_t i) const noexcept
+    {
+        return (data_[i / 64] >> (i % 64)) & 1;
+    }
+
+    /// Returns bit i, where i < size().
+    bool test(std::size_t i) const noexcept
+    {
+        return (*this)[i];
+    }
+
+    /// Sets bit i to value, where i < size().
+    void set(std::size_t i, bool value = true) noexcept
+    {
+        const valueType bit = valueType{1} << (i % 64);
+        data_[i / 64] = value ? data_[i / 64] | bit : data_[i / 64] & ~bit;
+    }
+
+    /// Sets bit i to zero, where i < size().
+    void reset(std::size_t i) noexcept
+    {
+        data_[i / 64] &= ~(valueType{1} << (i % 64));
+    }
+
+    /// Inverts bit i, where i < size().
+    void flip(std::size_t i) noexcept
+    {
+        data_[i / 64] ^= valueType{1} << (i % 64);
+    }
+
+    // ALL BITS ========================================================================================================
+
+    void setAll() noexcept
+    {
+        for (valueType &word : data_) {
+            word = ~valueType{0};
+        }
+        fixBack();
+    }
+
+    void resetAll() noexcept
+    {
+        wide::bitClear(data_.data(), data_.size());
+    }
+
+    void flipAll() noexcept
+    {
+        wide::bitNot(data_.data(), data_.size());
+        fixBack();
+    }
+
+    /// Returns the number of one-bits.
+    std::size_t count() const noexcept
+    {
+        return wide::popCount(data_.data(), data_.size());
+    }
+
+    bool any() const noexcept
+    {
+        return wide::findNonZero(data_.data(), 0, data_.size()) != data_.size();
+    }
+
+    bool none() const noexcept
+    {
+        return not any();
+    }
+
+    bool all() const noexcept
+    {
+        return count() == size_;
+    }
+
+    /// Returns the position of the first one-bit, or size() if there is none.
+    std::size_t findFirst() const noexcept
+    {
+        return size_ == 0 ? size_ : findFrom(0);
+    }
+
+    /// Returns the position of the first one-bit after i, or size() if there is none.
+    std::size_t findNext(std::size_t i) const noexcept
+    {
+        return ++i >= size_ ? size_ : findFrom(i);
+    }
+
+    // OPERATORS =======================================================================================================
+
+    DynamicBits &operator&=(const DynamicBits &other) noexcept
+    {
+        wide::bitAnd(data_.data(), other.data_.data(), data_.size());
+        return *this;
+    }
+
+    DynamicBits &operator|=(const DynamicBits &other) noexcept
+    {
+        wide::bitOr(data_.data(), other.data_.data(), data_.size());
+        return *this;
+    }
+
+    DynamicBits &operator^=(const DynamicBits &other) noexcept
+    {
+        wide::bitXor(data_.data(), other.data_.data(), data_.size());
+        return *this;
+    }
+
+    /// Clears the bits which are set in other, which is the set difference.
+    DynamicBits &operator-=(const DynamicBits &other) noexcept
+    {
+        wide::bitAndNot(data_.data(), other.data_.data(), data_.size());
+        return *this;
+    }
+
+    /// Moves every bit i to i + shift, discarding the bits which are moved past size().
+    DynamicBits &operator<<=(std::size_t shift) noexcept
+    {
+        wide::leftShift(data_.data(), shift, data_.size());
+        fixBack();
+        return *this;
+    }
+
+    /// Moves every bit i to i - shift, discarding the bits which are moved below zero.
+    DynamicBits &operator>>=(std::size_t shift) noexcept
+    {
+        wide::rightShift(data_.data(), shift, data_.size());
+        return *this;
+    }
+
+    DynamicBits operator~() const
+    {
+        DynamicBits copy = *this;
+        copy.flipAll();
+        return copy;
+    }
+
+    DynamicBits operator&(const DynamicBits &other) const
+    {
+        DynamicBits copy = *this;
+        return copy &= other;
+    }
+
+    DynamicBits operator|(const DynamicBits &other) const
+    {
+        DynamicBits copy = *this;
+        return copy |= other;
+    }
+
+    DynamicBits operator^(const DynamicBits &other) const
+    {
+        DynamicBits copy = *this;
+        return copy ^= other;
+    }
+
+    DynamicBits operator-(const DynamicBits &other) const
+    {
+        DynamicBits copy = *this;
+        return copy -= other;
+    }
+
+    DynamicBits operator<<(std::size_t shift) const
+    {
+        DynamicBits copy = *this;
+        return copy <<= shift;
+    }
+
+    DynamicBits operator>>(std::size_t shift) const
+    {
+        DynamicBits copy = *this;
+        return copy >>= shift;
+    }
+
+    bool operator==(const DynamicBits &other) const noexcept
+    {
+        return size_ == other.size_ && data_ == other.data_;
+    }
+
+    bool operator!=(const DynamicBits &other) const noexcept
+    {
+        return not(*this == other);
+    }
+
+private:
+    void fixBack() noexcept
+    {
+        if (size_ % 64 != 0) {
+            data_.back() &= ~(~valueType{0} << (size_ % 64));
+        }
+    }
+
+    /// Returns the position of the first one-bit at i or later, where i < size().
+    std::size_t findFrom(std::size_t i) const noexcept
+    {
+        const valueType first = data_[i / 64] & (~valueType{0} << (i % 64));
+        if (first != 0) {
+            return i / 64 * 64 + countTrailingZeros(first);
+        }
+        const std::size_t word = wide::findNonZero(data_.data(), i / 64 + 1, data_.size());
+        return word == data_.size() ? size_ : word * 64 + countTrailingZeros(data_[word]);
+    }
+};
 
-}  // namespace voxelio::wide
+}  // namespace bitmanip::wide
 
-#endif  // WBITS_HPP
+#endif  // BITMANIP_WBITS_HPP
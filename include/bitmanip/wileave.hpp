@@ -1,23 +1,84 @@
-#ifndef VXIO_WILEAVE_HPP
-#define VXIO_WILEAVE_HPP
+#ifndef BITMANIP_WILEAVE_HPP
+#define BITMANIP_WILEAVE_HPP
 /*
  * wileave.hpp
  * -----------
  * This header provides wide bit interleaving and de-interleaving functions.
  */
 
-#include "ileave.hpp"
+#include "bitileave.hpp"
+#include "build.hpp"
+#include "builtin.hpp"
+#include "intdiv.hpp"
+#include "intlog.hpp"
 
-namespace voxelio::wide {
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace bitmanip::wide {
 
 // WIDE INTERLEAVING ===================================================================================================
 
-template <usize COUNT, typename Uint, std::enable_if_t<COUNT <= 8 && std::is_unsigned_v<Uint>, int> = 0>
-constexpr void ileave_const([[maybe_unused]] const Uint inputs[], [[maybe_unused]] uint64_t outputs[])
+namespace detail {
+
+/**
+ * @brief The number of bits of each input which are interleaved into a single word at once.
+ * For non-power-of-two counts, the resulting words don't line up with the output words.
+ */
+template <std::size_t COUNT>
+inline constexpr std::size_t WIDE_CHUNK_BITS = COUNT == 0 ? 64 : 64 / COUNT;
+
+/// Writes bits to the given bit index of a multi-word number. Bits which exceed the number are discarded.
+constexpr void orBitsAt(std::uint64_t words[], std::size_t size, std::size_t bitIndex, std::uint64_t bits) noexcept
+{
+    const std::size_t index = bitIndex / 64;
+    const std::size_t shift = bitIndex % 64;
+
+    words[index] |= bits << shift;
+    if (shift != 0 && index + 1 < size) {
+        words[index + 1] |= bits >> (64 - shift);
+    }
+}
+
+/// Reads 64 bits from the given bit index of a multi-word number. Bits which exceed the number are zero.
+[[nodiscard]] constexpr std::uint64_t readBitsAt(const std::uint64_t words[],
+                                                 std::size_t size,
+                                                 std::size_t bitIndex) noexcept
+{
+    const std::size_t index = bitIndex / 64;
+    const std::size_t shift = bitIndex % 64;
+
+    std::uint64_t result = words[index] >> shift;
+    if (shift != 0 && index + 1 < size) {
+        result |= words[index + 1] << (64 - shift);
+    }
+    return result;
+}
+
+template <std::size_t COUNT, typename Uint, std::size_t... I>
+[[nodiscard]] constexpr std::uint64_t ileaveChunk_impl(std::index_sequence<I...>,
+                                                       const Uint inputs[],
+                                                       std::size_t shift) noexcept
+{
+    constexpr std::uint32_t mask = (std::uint32_t{1} << WIDE_CHUNK_BITS<COUNT>) - 1;
+    return (ileaveZeros_const<COUNT - 1, I>(static_cast<std::uint32_t>(inputs[I] >> shift) & mask) | ...);
+}
+
+/// Interleaves WIDE_CHUNK_BITS<COUNT> bits of every input, starting at the given shift, into a single word.
+template <std::size_t COUNT, typename Uint>
+[[nodiscard]] constexpr std::uint64_t ileaveChunk(const Uint inputs[], std::size_t shift) noexcept
+{
+    return ileaveChunk_impl<COUNT>(std::make_index_sequence<COUNT>{}, inputs, shift);
+}
+
+}  // namespace detail
+
+template <std::size_t COUNT, typename Uint, std::enable_if_t<COUNT <= 8 && std::is_unsigned_v<Uint>, int> = 0>
+constexpr void ileave_const([[maybe_unused]] const Uint inputs[], [[maybe_unused]] std::uint64_t outputs[])
 {
-    constexpr usize inputBytes = COUNT * sizeof(Uint);
-    constexpr usize outputSize = voxelio::divCeil(inputBytes, sizeof(uint64_t));
-    // constexpr usize outputBytes = outputSize * sizeof (uint64_t);
+    constexpr std::size_t inputBytes = COUNT * sizeof(Uint);
+    constexpr std::size_t outputSize = bitmanip::divCeil(inputBytes, sizeof(std::uint64_t));
 
     if constexpr (COUNT == 0) {
         return;
@@ -28,49 +89,38 @@ constexpr void ileave_const([[maybe_unused]] const Uint inputs[], [[maybe_unused
     else {
         static_assert(outputSize != 0);
 
-        for (usize o = 0; o < outputSize; ++o) {
+        for (std::size_t o = 0; o < outputSize; ++o) {
             outputs[o] = 0;
         }
 
-        for (usize i = 0; i < COUNT; ++i) {
+        if constexpr (outputSize != 1 && not bitmanip::isPow2or0(COUNT)) {
+            constexpr std::size_t rshift = detail::WIDE_CHUNK_BITS<COUNT>;
+            constexpr std::size_t chunkCount = bitmanip::divCeil(sizeof(Uint) * 8, rshift);
+
+            // every chunk of rshift bits of all inputs is interleaved into a single word, which is then written at an
+            // arbitrary bit position of the output
+            for (std::size_t c = 0; c < chunkCount; ++c) {
+                const std::uint64_t result = detail::ileaveChunk<COUNT>(inputs, c * rshift);
+                detail::orBitsAt(outputs, outputSize, c * rshift * COUNT, result);
+            }
+            return;
+        }
+
+        for (std::size_t i = 0; i < COUNT; ++i) {
             Uint input = inputs[i];
             if constexpr (outputSize == 1) {
-                uint64_t result = ileaveZeros_const<COUNT - 1>(input) << i;
+                std::uint64_t result = ileaveZeros_const<COUNT - 1>(input) << i;
                 outputs[0] |= result;
             }
-            else if constexpr (voxelio::isPow2or0(COUNT)) {
-                constexpr usize rshift = sizeof(Uint) * 8 / outputSize;
+            else {
+                constexpr std::size_t rshift = sizeof(Uint) * 8 / outputSize;
 
-                for (usize j = 0; j < outputSize; ++j) {
-                    uint64_t result = ileaveZeros_const<COUNT - 1>(static_cast<uint32_t>(input)) << i;
+                for (std::size_t j = 0; j < outputSize; ++j) {
+                    std::uint64_t result = ileaveZeros_const<COUNT - 1>(static_cast<std::uint32_t>(input)) << i;
                     outputs[j] |= result;
                     input >>= rshift;
                 }
             }
-            else {
-                // writeIndex is the index of current byte to write
-                for (usize writeIndex = 0, nextIndex = 0; writeIndex < inputBytes; writeIndex = nextIndex) {
-                    // clang-format off
-                    nextIndex += COUNT;
-                    uint8_t nextByte = input & 0xff;                             // mask single byte
-                    uint64_t result = ileaveZeros_const<COUNT - 1>(nextByte) << i; // perform zero-interleaving
-
-                    usize outputIndex = writeIndex / sizeof(uint64_t);       // get index in output
-                    usize outputShift = writeIndex % sizeof(uint64_t) * 8;
-
-                    outputs[outputIndex] |= result << outputShift;            // write result to output
-
-                    usize nextOutputIndex = nextIndex / sizeof(uint64_t);    // get next index in output
-                    if (nextOutputIndex != outputIndex) {                     // detect spill
-                        usize spillIndex = nextIndex % sizeof(uint64_t);
-                        usize spillShift = (COUNT - spillIndex) * 8;
-                        outputs[nextOutputIndex] |= result >> spillShift;
-                    }
-
-                    input >>= 8;                                              // rightshift next byte into place
-                    // clang-format on
-                }
-            }
         }
     }
 }
@@ -78,13 +128,12 @@ constexpr void ileave_const([[maybe_unused]] const Uint inputs[], [[maybe_unused
 namespace detail {
 
 template <typename Uint>
-constexpr void ileave_naive(const Uint inputs[], uint64_t outputs[], usize count)
+constexpr void ileave_naive(const Uint inputs[], std::uint64_t outputs[], std::size_t count)
 {
     constexpr Uint singleInputBits = sizeof(Uint) * 8;
-    constexpr Uint singleOutputBits = sizeof(uint64_t) * 8;
+    constexpr Uint singleOutputBits = sizeof(std::uint64_t) * 8;
 
-    VXIO_DEBUG_ASSERT_LE(count, 8);
-    VXIO_ASSUME(count <= 8);
+    BITMANIP_ASSUME(count <= 8);
 
     if (count == 0) {
         return;
@@ -93,17 +142,17 @@ constexpr void ileave_naive(const Uint inputs[], uint64_t outputs[], usize count
         outputs[0] = inputs[0];
         return;
     }
-    const usize outputSize = voxelio::divCeil(count * sizeof(Uint), sizeof(uint64_t));
-    for (usize o = 0; o < outputSize; ++o) {
+    const std::size_t outputSize = bitmanip::divCeil(count * sizeof(Uint), sizeof(std::uint64_t));
+    for (std::size_t o = 0; o < outputSize; ++o) {
         outputs[o] = 0;
     }
 
-    const usize bits = count * singleInputBits;
+    const std::size_t bits = count * singleInputBits;
 
-    usize inputShift = 0;
-    usize outputIndex = 0;
+    std::size_t inputShift = 0;
+    std::size_t outputIndex = 0;
 
-    for (usize b = 0, i = 0, o = 0; b < bits; ++b, ++i, ++o) {
+    for (std::size_t b = 0, i = 0, o = 0; b < bits; ++b, ++i, ++o) {
         if (i == count) {
             i = 0;
             ++inputShift;
@@ -113,16 +162,15 @@ constexpr void ileave_naive(const Uint inputs[], uint64_t outputs[], usize count
             ++outputIndex;
         }
         bool bit = (inputs[i] >> inputShift) & 1;
-        outputs[outputIndex] |= uint64_t{bit} << o;
+        outputs[outputIndex] |= std::uint64_t{bit} << o;
     }
 }
 
 // alternative implementation adapting ileave_bytes_const to work with a runtime parameter
 template <typename Uint>
-constexpr void ileave_jmp(const Uint inputs[], uint64_t outputs[], usize count)
+constexpr void ileave_jmp(const Uint inputs[], std::uint64_t outputs[], std::size_t count)
 {
-    VXIO_DEBUG_ASSERT_LE(count, 8);
-    VXIO_ASSUME(count <= 8);
+    BITMANIP_ASSUME(count <= 8);
 
     switch (count) {
     case 0: wide::ileave_const<0>(inputs, outputs); return;
@@ -135,13 +183,13 @@ constexpr void ileave_jmp(const Uint inputs[], uint64_t outputs[], usize count)
     case 7: wide::ileave_const<7>(inputs, outputs); return;
     case 8: wide::ileave_const<8>(inputs, outputs); return;
     }
-    VXIO_DEBUG_ASSERT_UNREACHABLE();
+    BITMANIP_UNREACHABLE();
 }
 
 }  // namespace detail
 
 template <typename Uint, std::enable_if_t<std::is_unsigned_v<Uint>, int> = 0>
-constexpr void ileave(const Uint inputs[], uint64_t outputs[], usize count)
+constexpr void ileave(const Uint inputs[], std::uint64_t outputs[], std::size_t count)
 {
     wide::detail::ileave_jmp<Uint>(inputs, outputs, count);
 }
@@ -149,16 +197,29 @@ constexpr void ileave(const Uint inputs[], uint64_t outputs[], usize count)
 // WIDE DEINTERLEAVING =================================================================================================
 
 namespace detail {
-template <typename Uint>
-constexpr void dileave_naive(const uint64_t inputs[], Uint outputs[], usize count);
+
+template <std::size_t COUNT, typename Uint, std::size_t... I>
+constexpr void dileaveChunk_impl(std::index_sequence<I...>, std::uint64_t chunk, Uint outputs[], std::size_t shift)
+{
+    constexpr std::uint64_t mask = (std::uint64_t{1} << WIDE_CHUNK_BITS<COUNT>) - 1;
+    ((outputs[I] |= static_cast<Uint>((remIleavedBits_const<COUNT - 1, I>(chunk) & mask) << shift)), ...);
+}
+
+/// Inverse of ileaveChunk, which ORs the de-interleaved bits into the outputs at the given shift.
+template <std::size_t COUNT, typename Uint>
+constexpr void dileaveChunk(std::uint64_t chunk, Uint outputs[], std::size_t shift)
+{
+    dileaveChunk_impl<COUNT>(std::make_index_sequence<COUNT>{}, chunk, outputs, shift);
 }
 
-template <usize COUNT, typename Uint, std::enable_if_t<COUNT <= 8 && std::is_unsigned_v<Uint>, int> = 0>
-constexpr void dileave_const([[maybe_unused]] const uint64_t inputs[], [[maybe_unused]] Uint outputs[])
+}  // namespace detail
+
+template <std::size_t COUNT, typename Uint, std::enable_if_t<COUNT <= 8 && std::is_unsigned_v<Uint>, int> = 0>
+constexpr void dileave_const([[maybe_unused]] const std::uint64_t inputs[], [[maybe_unused]] Uint outputs[])
 {
-    constexpr usize outputBytes = COUNT * sizeof(Uint);
-    constexpr usize inputSize = voxelio::divCeil(outputBytes, sizeof(uint64_t));
-    // constexpr usize outputBytes = outputSize * sizeof (uint64_t);
+    constexpr std::size_t outputBytes = COUNT * sizeof(Uint);
+    constexpr std::size_t inputSize = bitmanip::divCeil(outputBytes, sizeof(std::uint64_t));
+    // constexpr std::size_t outputBytes = outputSize * sizeof (std::uint64_t);
 
     if constexpr (COUNT == 0) {
         return;
@@ -170,18 +231,18 @@ constexpr void dileave_const([[maybe_unused]] const uint64_t inputs[], [[maybe_u
         static_assert(inputSize != 0);
 
         if constexpr (inputSize == 1) {
-            for (usize o = 0; o < COUNT; ++o) {
-                uint64_t dileaved = remIleavedBits_const<COUNT - 1>(inputs[0] >> o);
+            for (std::size_t o = 0; o < COUNT; ++o) {
+                std::uint64_t dileaved = remIleavedBits_const<COUNT - 1>(inputs[0] >> o);
                 outputs[o] = static_cast<Uint>(dileaved);
             }
         }
-        else if constexpr (voxelio::isPow2or0(COUNT)) {
-            for (usize o = 0; o < COUNT; ++o) {
+        else if constexpr (bitmanip::isPow2or0(COUNT)) {
+            for (std::size_t o = 0; o < COUNT; ++o) {
                 Uint result = 0;
 
-                constexpr usize lshift = sizeof(Uint) * 8 / inputSize;
+                constexpr std::size_t lshift = sizeof(Uint) * 8 / inputSize;
 
-                for (usize j = inputSize; j != 0; --j) {
+                for (std::size_t j = inputSize; j != 0; --j) {
                     result <<= lshift;
                     result |= remIleavedBits_const<COUNT - 1>(inputs[j - 1] >> o);
                 }
@@ -190,7 +251,18 @@ constexpr void dileave_const([[maybe_unused]] const uint64_t inputs[], [[maybe_u
             }
         }
         else {
-            return wide::detail::dileave_naive(inputs, outputs, COUNT);
+            constexpr std::size_t lshift = detail::WIDE_CHUNK_BITS<COUNT>;
+            constexpr std::size_t chunkCount = bitmanip::divCeil(sizeof(Uint) * 8, lshift);
+
+            for (std::size_t o = 0; o < COUNT; ++o) {
+                outputs[o] = 0;
+            }
+            // the inverse of ileave_const: every chunk of COUNT * lshift bits is read from an arbitrary bit position
+            // and de-interleaved into lshift bits of each output
+            for (std::size_t c = 0; c < chunkCount; ++c) {
+                const std::uint64_t chunk = detail::readBitsAt(inputs, inputSize, c * lshift * COUNT);
+                detail::dileaveChunk<COUNT>(chunk, outputs, c * lshift);
+            }
         }
     }
 }
@@ -198,13 +270,12 @@ constexpr void dileave_const([[maybe_unused]] const uint64_t inputs[], [[maybe_u
 namespace detail {
 
 template <typename Uint>
-constexpr void dileave_naive(const uint64_t inputs[], Uint outputs[], usize count)
+constexpr void dileave_naive(const std::uint64_t inputs[], Uint outputs[], std::size_t count)
 {
-    constexpr Uint singleInputBits = sizeof(uint64_t) * 8;
+    constexpr Uint singleInputBits = sizeof(std::uint64_t) * 8;
     constexpr Uint singleOutputBits = sizeof(Uint) * 8;
 
-    VXIO_DEBUG_ASSERT_LE(count, 8);
-    VXIO_ASSUME(count <= 8);
+    BITMANIP_ASSUME(count <= 8);
 
     if (count == 0) {
         return;
@@ -213,16 +284,16 @@ constexpr void dileave_naive(const uint64_t inputs[], Uint outputs[], usize coun
         outputs[0] = static_cast<Uint>(inputs[0]);
         return;
     }
-    for (usize o = 0; o < count; ++o) {
+    for (std::size_t o = 0; o < count; ++o) {
         outputs[o] = 0;
     }
 
-    const usize bits = count * singleOutputBits;
+    const std::size_t bits = count * singleOutputBits;
 
-    usize inputIndex = 0;
-    usize outputShift = 0;
+    std::size_t inputIndex = 0;
+    std::size_t outputShift = 0;
 
-    for (usize b = 0, i = 0, o = 0; b < bits; ++b, ++i, ++o) {
+    for (std::size_t b = 0, i = 0, o = 0; b < bits; ++b, ++i, ++o) {
         if (i == singleInputBits) {
             i = 0;
             ++inputIndex;
@@ -237,10 +308,9 @@ constexpr void dileave_naive(const uint64_t inputs[], Uint outputs[], usize coun
 }
 
 template <typename Uint>
-constexpr void dileave_jmp(const uint64_t inputs[], Uint outputs[], usize count)
+constexpr void dileave_jmp(const std::uint64_t inputs[], Uint outputs[], std::size_t count)
 {
-    VXIO_DEBUG_ASSERT_LE(count, 8);
-    VXIO_ASSUME(count <= 8);
+    BITMANIP_ASSUME(count <= 8);
 
     switch (count) {
     case 0: wide::dileave_const<0>(inputs, outputs); return;
@@ -253,17 +323,17 @@ constexpr void dileave_jmp(const uint64_t inputs[], Uint outputs[], usize count)
     case 7: wide::dileave_const<7>(inputs, outputs); return;
     case 8: wide::dileave_const<8>(inputs, outputs); return;
     }
-    VXIO_DEBUG_ASSERT_UNREACHABLE();
+    BITMANIP_UNREACHABLE();
 }
 
 }  // namespace detail
 
 template <typename Uint, std::enable_if_t<std::is_unsigned_v<Uint>, int> = 0>
-constexpr void dileave(const uint64_t inputs[], Uint outputs[], usize count)
+constexpr void dileave(const std::uint64_t inputs[], Uint outputs[], std::size_t count)
 {
     wide::detail::dileave_jmp<Uint>(inputs, outputs, count);
 }
 
-}  // namespace voxelio::wide
+}  // namespace bitmanip::wide
 
-#endif  // WILEAVE_HPP
+#endif  // BITMANIP_WILEAVE_HPP
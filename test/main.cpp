@@ -9,7 +9,9 @@ namespace {
 
 int testFailureCount = 0;
 
-constexpr const char *TEST_ORDER[]{"traits", "bit", "bitcount", "bitileave", "bitrev", "bitrot", "intdiv", "intlog"};
+constexpr const char *TEST_ORDER[]{
+    "traits", "bit", "bitcount", "rankselect", "setbits", "wbits", "roaring", "bitileave", "ileavelayout", "bitrev",
+    "bitrot", "bittrans", "intdiv", "intlog", "morton", "hilbert", "shuffle"};
 
 void runTest(const Test &test) noexcept
 {
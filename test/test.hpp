@@ -3,8 +3,10 @@
 
 #include "assert.hpp"
 
+#include <cstdint>
 #include <cstring>
 #include <random>
+#include <vector>
 
 namespace bitmanip {
 
@@ -82,6 +84,23 @@ inline std::uint32_t hardwareSeed()
     return std::random_device{}();
 }
 
+/**
+ * @brief Returns random words whose bits are sparse (density 0), uniform (1) or dense (2).
+ * Any greater density picks one of the three for each word, which mixes zero, full and ordinary words.
+ */
+inline std::vector<std::uint64_t> makeRandomWords(fast_rng64 &rng, std::size_t count, unsigned density)
+{
+    std::vector<std::uint64_t> words(count);
+    for (std::uint64_t &w : words) {
+        switch (density > 2 ? rng() % 3 : density) {
+        case 0: w = rng() & rng() & rng() & rng() & rng(); break;
+        case 1: w = rng(); break;
+        default: w = rng() | rng() | rng() | rng(); break;
+        }
+    }
+    return words;
+}
+
 }  // namespace bitmanip
 
 #endif
@@ -0,0 +1,229 @@
+#include "bitmanip/bitcount.hpp"
+
+#include "test.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+namespace bitmanip {
+namespace {
+
+using detail::BitwiseOp;
+
+constexpr std::uint64_t POP_COUNT_WORDS[]{0, 1, 0xff, ~std::uint64_t{0}, 0x8000'0000'0000'0001};
+constexpr std::uint64_t POP_COUNT_MASKS[]{~std::uint64_t{0}, 0, 0x0f, 0xffff'0000'0000'0000, 1};
+
+/// Tests every implementation which is available on this CPU.
+template <BitwiseOp OP>
+void testPopCountImplementations(const std::uint64_t a[], const std::uint64_t b[], std::size_t count)
+{
+    std::size_t expected = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        expected += detail::popCount_naive(detail::applyBitwiseOp<OP>(a[i], b[i]));
+    }
+    BITMANIP_ASSERT_EQ(detail::popCount_dispatch<OP>(a, b, count), expected);
+    BITMANIP_ASSERT_EQ(detail::popCount_harleySeal<OP>(a, b, count), expected);
+#ifdef BITMANIP_HAS_SIMD_POPCOUNT
+    if (CPU_FEATURES.avx2) {
+        std::size_t result = 0;
+        const std::size_t done = detail::popCount_avx2<OP>(a, b, count, result);
+        BITMANIP_ASSERT_EQ(result + detail::popCount_loop<OP>(a + done, b + done, count - done), expected);
+    }
+    if (CPU_FEATURES.popcnt) {
+        BITMANIP_ASSERT_EQ(detail::popCount_popcnt<OP>(a, b, count), expected);
+    }
+    if (CPU_FEATURES.avx512vpopcntdq) {
+        BITMANIP_ASSERT_EQ(detail::popCount_avx512<OP>(a, b, count), expected);
+    }
+#endif
+}
+
+BITMANIP_TEST(bitcount, popCountBulk_manual)
+{
+    BITMANIP_STATIC_ASSERT_EQ(popCount(POP_COUNT_WORDS, 0), 0u);
+    BITMANIP_STATIC_ASSERT_EQ(popCount(POP_COUNT_WORDS, 5), 75u);
+    BITMANIP_ASSERT_EQ(popCount(POP_COUNT_WORDS, 5), 75u);
+    BITMANIP_ASSERT_EQ(detail::popCount_harleySeal<BitwiseOp::IDENTITY>(POP_COUNT_WORDS, POP_COUNT_WORDS, 5), 75u);
+}
+
+BITMANIP_TEST(bitcount, popCountBulk_matches_naive)
+{
+    fast_rng64 rng{12345};
+    const std::vector<std::uint64_t> words = makeRandomWords(rng, 1000, 3);
+
+    for (std::size_t offset : {0, 1, 3}) {
+        for (std::size_t count = 0; count + offset <= words.size(); count += count < 150 ? 1 : 97) {
+            const std::uint64_t *const input = words.data() + offset;
+            testPopCountImplementations<BitwiseOp::IDENTITY>(input, input, count);
+            BITMANIP_ASSERT_EQ(popCount(input, count), detail::popCount_loop<BitwiseOp::IDENTITY>(input, input, count));
+        }
+    }
+}
+
+BITMANIP_TEST(bitcount, popCountBulk_allOnes)
+{
+    const std::vector<std::uint64_t> words(4096 + 7, ~std::uint64_t{0});
+    BITMANIP_ASSERT_EQ(popCount(words.data(), words.size()), words.size() * 64);
+    testPopCountImplementations<BitwiseOp::IDENTITY>(words.data(), words.data(), words.size());
+}
+
+BITMANIP_TEST(bitcount, popCountFused_manual)
+{
+    BITMANIP_STATIC_ASSERT_EQ(popCountAnd(POP_COUNT_WORDS, POP_COUNT_MASKS, 5), 0u + 0 + 4 + 16 + 1);
+    BITMANIP_STATIC_ASSERT_EQ(popCountOr(POP_COUNT_WORDS, POP_COUNT_MASKS, 5), 64u + 1 + 8 + 64 + 2);
+    BITMANIP_STATIC_ASSERT_EQ(popCountXor(POP_COUNT_WORDS, POP_COUNT_MASKS, 5), 64u + 1 + 4 + 48 + 1);
+    BITMANIP_STATIC_ASSERT_EQ(popCountAndNot(POP_COUNT_WORDS, POP_COUNT_MASKS, 5), 0u + 1 + 4 + 48 + 1);
+    BITMANIP_ASSERT_EQ(popCountAnd(POP_COUNT_WORDS, POP_COUNT_MASKS, 5), 21u);
+    BITMANIP_ASSERT_EQ(popCountOr(POP_COUNT_WORDS, POP_COUNT_MASKS, 5), 139u);
+    BITMANIP_ASSERT_EQ(popCountXor(POP_COUNT_WORDS, POP_COUNT_MASKS, 5), 118u);
+    BITMANIP_ASSERT_EQ(popCountAndNot(POP_COUNT_WORDS, POP_COUNT_MASKS, 5), 54u);
+}
+
+BITMANIP_TEST(bitcount, popCountFused_matches_naive)
+{
+    fast_rng64 rng{12345};
+    const std::vector<std::uint64_t> a = makeRandomWords(rng, 600, 3);
+    const std::vector<std::uint64_t> b = makeRandomWords(rng, 600, 3);
+
+    for (std::size_t count = 0; count + 1 <= a.size(); count += count < 150 ? 1 : 61) {
+        // b is offset by one word, so that the two arrays are differently aligned
+        testPopCountImplementations<BitwiseOp::AND>(a.data(), b.data() + 1, count);
+        testPopCountImplementations<BitwiseOp::OR>(a.data(), b.data() + 1, count);
+        testPopCountImplementations<BitwiseOp::XOR>(a.data(), b.data() + 1, count);
+        testPopCountImplementations<BitwiseOp::AND_NOT>(a.data(), b.data() + 1, count);
+    }
+}
+
+BITMANIP_TEST(bitcount, popCountFused_identities)
+{
+    fast_rng64 rng{12345};
+    const std::vector<std::uint64_t> a = makeRandomWords(rng, 1000, 3);
+    const std::vector<std::uint64_t> b = makeRandomWords(rng, 1000, 3);
+    const std::size_t n = a.size();
+
+    const std::size_t intersection = popCountAnd(a.data(), b.data(), n);
+    BITMANIP_ASSERT_EQ(popCountOr(a.data(), b.data(), n), popCount(a.data(), n) + popCount(b.data(), n) - intersection);
+    BITMANIP_ASSERT_EQ(popCountXor(a.data(), b.data(), n), popCountOr(a.data(), b.data(), n) - intersection);
+    BITMANIP_ASSERT_EQ(popCountAndNot(a.data(), b.data(), n), popCount(a.data(), n) - intersection);
+    BITMANIP_ASSERT_EQ(popCountXor(a.data(), a.data(), n), 0u);
+    BITMANIP_ASSERT_EQ(popCountAnd(a.data(), a.data(), n), popCount(a.data(), n));
+}
+
+template <typename Uint>
+void testPositionalPopCount(fast_rng64 &rng)
+{
+    std::vector<Uint> words(3000);
+    for (Uint &w : words) {
+        w = static_cast<Uint>(rng() & rng());
+    }
+
+    for (std::size_t count = 0; count <= words.size(); count += count < 100 ? 1 : 293) {
+        std::uint64_t expected[bits_v<Uint>], actual[bits_v<Uint>];
+        detail::positionalPopCount_naive(words.data(), count, expected);
+
+        // previous contents must be replaced
+        std::fill(std::begin(actual), std::end(actual), 123);
+        positionalPopCount(words.data(), count, actual);
+        BITMANIP_ASSERT(std::equal(std::begin(actual), std::end(actual), std::begin(expected)));
+
+        detail::positionalPopCount_harleySeal(words.data(), count, actual);
+        BITMANIP_ASSERT(std::equal(std::begin(actual), std::end(actual), std::begin(expected)));
+#ifdef BITMANIP_HAS_SIMD_POPCOUNT
+        if (CPU_FEATURES.avx2) {
+            std::uint64_t simd[bits_v<Uint>]{};
+            const std::size_t done = detail::positionalPopCount_avx2(words.data(), count, simd);
+            detail::positionalPopCount_naive(words.data() + done, count - done, actual);
+            for (std::size_t b = 0; b < bits_v<Uint>; ++b) {
+                BITMANIP_ASSERT_EQ(simd[b] + actual[b], expected[b]);
+            }
+        }
+#endif
+    }
+}
+
+BITMANIP_TEST(bitcount, positionalPopCount_manual)
+{
+    constexpr std::uint8_t words[]{0b0000'0001, 0b1000'0011, 0b1000'0001};
+    std::uint64_t counts[8]{};
+    positionalPopCount(words, 3, counts);
+    BITMANIP_ASSERT_EQ(counts[0], 3u);
+    BITMANIP_ASSERT_EQ(counts[1], 1u);
+    BITMANIP_ASSERT_EQ(counts[2], 0u);
+    BITMANIP_ASSERT_EQ(counts[7], 2u);
+}
+
+BITMANIP_TEST(bitcount, positionalPopCount_matches_naive)
+{
+    fast_rng64 rng{12345};
+    testPositionalPopCount<std::uint8_t>(rng);
+    testPositionalPopCount<std::uint16_t>(rng);
+    testPositionalPopCount<std::uint32_t>(rng);
+    testPositionalPopCount<std::uint64_t>(rng);
+}
+
+BITMANIP_TEST(bitcount, positionalPopCount_allOnes)
+{
+    // more than 255 blocks of 16 vectors, so that the byte counters have to be flushed
+    const std::vector<std::uint8_t> words(16 * 64 * 300 + 5, 0xff);
+    std::uint64_t counts[8];
+    positionalPopCount(words.data(), words.size(), counts);
+    for (std::uint64_t c : counts) {
+        BITMANIP_ASSERT_EQ(c, words.size());
+    }
+#ifdef BITMANIP_HAS_SIMD_POPCOUNT
+    if (CPU_FEATURES.avx2) {
+        std::uint64_t simd[8]{};
+        const std::size_t done = detail::positionalPopCount_avx2(words.data(), words.size(), simd);
+        for (std::uint64_t c : simd) {
+            BITMANIP_ASSERT_EQ(c, done);
+        }
+    }
+#endif
+}
+
+BITMANIP_TEST(bitcount, selectBit_manual)
+{
+    BITMANIP_STATIC_ASSERT_EQ(selectBit(std::uint8_t{0b1011'0100}, 0), 2);
+    BITMANIP_STATIC_ASSERT_EQ(selectBit(std::uint8_t{0b1011'0100}, 2), 5);
+    BITMANIP_STATIC_ASSERT_EQ(selectBit(std::uint8_t{0b1011'0100}, 3), 7);
+    BITMANIP_STATIC_ASSERT_EQ(selectBit(std::uint8_t{0b1011'0100}, 4), 8);
+    BITMANIP_STATIC_ASSERT_EQ(selectBit(std::uint64_t{1} << 63, 0), 63);
+    BITMANIP_STATIC_ASSERT_EQ(selectBit(0u, 0), 32);
+    BITMANIP_STATIC_ASSERT_EQ(selectBit(~0ull, 63), 63);
+    BITMANIP_STATIC_ASSERT_EQ(selectBit(~0ull, 64), 64);
+    BITMANIP_ASSERT_EQ(selectBit(std::uint8_t{0b1011'0100}, 2), 5);
+    BITMANIP_ASSERT_EQ(selectBit(std::uint16_t{0x8000}, 0), 15);
+    BITMANIP_ASSERT_EQ(selectBit(std::uint16_t{0x8000}, 1), 16);
+    BITMANIP_ASSERT_EQ(selectBit(~0ull, 64), 64);
+}
+
+template <typename Uint>
+void testSelectBit(fast_rng64 &rng)
+{
+    for (std::size_t i = 0; i < 1000; ++i) {
+        // sparse, random and dense words
+        const std::uint64_t r = i % 3 == 0 ? rng() & rng() : i % 3 == 1 ? rng() : rng() | rng();
+        const auto input = static_cast<Uint>(r);
+        for (unsigned k = 0; k <= bits_v<Uint> + 1; ++k) {
+            const unsigned char expected = detail::selectBit_naive(input, k);
+            BITMANIP_ASSERT_EQ(selectBit(input, k), expected);
+            if (k < bits_v<Uint>) {
+                const unsigned char broadword = detail::selectBit_broadword(input, k);
+                BITMANIP_ASSERT_EQ(broadword, expected == bits_v<Uint> ? 64 : expected);
+            }
+        }
+    }
+}
+
+BITMANIP_TEST(bitcount, selectBit_matches_naive)
+{
+    fast_rng64 rng{12345};
+    testSelectBit<std::uint8_t>(rng);
+    testSelectBit<std::uint16_t>(rng);
+    testSelectBit<std::uint32_t>(rng);
+    testSelectBit<std::uint64_t>(rng);
+}
+
+}  // namespace
+}  // namespace bitmanip
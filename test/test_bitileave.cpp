@@ -1,4 +1,5 @@
 #include "bitmanip/bitileave.hpp"
+#include "bitmanip/wileave.hpp"
 
 #include "test.hpp"
 
@@ -274,5 +275,336 @@ BITMANIP_TEST(bitileave, dileave3_reverses_ileave3)
     }
 }
 
+BITMANIP_TEST(bitileave, ileaveBatch_soa_matches_ileave)
+{
+    // deliberately not a multiple of any vector width to test the scalar remainder
+    constexpr size_t count = 1024 + 7;
+
+    std::mt19937 rng{12345};
+    std::uniform_int_distribution<std::uint32_t> distr{0, std::numeric_limits<std::uint32_t>::max()};
+
+    std::uint32_t x[count], y[count], z[count];
+    for (size_t i = 0; i < count; ++i) {
+        x[i] = distr(rng);
+        y[i] = distr(rng);
+        z[i] = distr(rng);
+    }
+
+    unsigned long long actual[count];
+    ileaveBatch(x, y, actual, count);
+    for (size_t i = 0; i < count; ++i) {
+        BITMANIP_ASSERT_EQ(actual[i], ileave(x[i], y[i]));
+    }
+
+    ileaveBatch(x, y, z, actual, count);
+    for (size_t i = 0; i < count; ++i) {
+        BITMANIP_ASSERT_EQ(actual[i], ileave(x[i], y[i], z[i]));
+    }
+
+#ifdef BITMANIP_HAS_SIMD_ILEAVE_BATCH
+    const std::uint32_t *const inputs[] = {x, y, z};
+    const auto check2 = [&](size_t processed, size_t width) {
+        BITMANIP_ASSERT_EQ(processed, count / width * width);
+        for (size_t i = 0; i < processed; ++i) {
+            BITMANIP_ASSERT_EQ(actual[i], ileave(x[i], y[i]));
+        }
+    };
+    const auto check3 = [&](size_t processed, size_t width) {
+        BITMANIP_ASSERT_EQ(processed, count / width * width);
+        for (size_t i = 0; i < processed; ++i) {
+            BITMANIP_ASSERT_EQ(actual[i], ileave(x[i], y[i], z[i]));
+        }
+    };
+    if (CPU_FEATURES.avx2) {
+        check2(detail::ileaveBatch_soa_avx2<2>(inputs, actual, count), 4);
+        check3(detail::ileaveBatch_soa_avx2<3>(inputs, actual, count), 4);
+    }
+    if (CPU_FEATURES.avx512f) {
+        check2(detail::ileaveBatch_soa_avx512<2>(inputs, actual, count), 8);
+        check3(detail::ileaveBatch_soa_avx512<3>(inputs, actual, count), 8);
+    }
+#endif
+}
+
+BITMANIP_TEST(bitileave, ileaveBatch_aos_matches_ileave)
+{
+    constexpr size_t count = 1024 + 7;
+
+    std::mt19937 rng{12345};
+    std::uniform_int_distribution<std::uint32_t> distr{0, std::numeric_limits<std::uint32_t>::max()};
+
+    std::uint32_t points[count * 3];
+    for (size_t i = 0; i < count * 3; ++i) {
+        points[i] = distr(rng);
+    }
+
+    unsigned long long actual[count];
+    ileaveBatch<2>(points, actual, count);
+    for (size_t i = 0; i < count; ++i) {
+        BITMANIP_ASSERT_EQ(actual[i], ileave(points[i * 2], points[i * 2 + 1]));
+    }
+
+    ileaveBatch<3>(points, actual, count);
+    for (size_t i = 0; i < count; ++i) {
+        BITMANIP_ASSERT_EQ(actual[i], ileave(points[i * 3], points[i * 3 + 1], points[i * 3 + 2]));
+    }
+
+#ifdef BITMANIP_HAS_SIMD_ILEAVE_BATCH
+    const auto check2 = [&](size_t processed, size_t width) {
+        BITMANIP_ASSERT_EQ(processed, count / width * width);
+        for (size_t i = 0; i < processed; ++i) {
+            BITMANIP_ASSERT_EQ(actual[i], ileave(points[i * 2], points[i * 2 + 1]));
+        }
+    };
+    const auto check3 = [&](size_t processed, size_t width) {
+        BITMANIP_ASSERT_EQ(processed, count / width * width);
+        for (size_t i = 0; i < processed; ++i) {
+            BITMANIP_ASSERT_EQ(actual[i], ileave(points[i * 3], points[i * 3 + 1], points[i * 3 + 2]));
+        }
+    };
+    if (CPU_FEATURES.avx2) {
+        check2(detail::ileaveBatch_aos_avx2<2>(points, actual, count), 4);
+        check3(detail::ileaveBatch_aos_avx2<3>(points, actual, count), 4);
+    }
+    if (CPU_FEATURES.avx512f) {
+        check2(detail::ileaveBatch_aos_avx512<2>(points, actual, count), 8);
+        check3(detail::ileaveBatch_aos_avx512<3>(points, actual, count), 8);
+    }
+#endif
+
+    std::uint16_t narrow[] = {1, 2, 3, 4, 5, 6};
+    ileaveBatch<3>(narrow, actual, 2);
+    BITMANIP_ASSERT_EQ(actual[0], ileave(narrow[0], narrow[1], narrow[2]));
+    BITMANIP_ASSERT_EQ(actual[1], ileave(narrow[3], narrow[4], narrow[5]));
+}
+
+BITMANIP_TEST(bitileave, dileaveBatch_matches_dileave)
+{
+    constexpr size_t count = 1024 + 7;
+
+    fast_rng64 rng{12345};
+    std::uniform_int_distribution<std::uint64_t> distr;
+
+    unsigned long long codes[count];
+    for (size_t i = 0; i < count; ++i) {
+        codes[i] = distr(rng);
+    }
+
+    std::uint32_t x[count], y[count], z[count];
+    dileaveBatch(codes, x, y, count);
+    for (size_t i = 0; i < count; ++i) {
+        std::uint32_t expected[2];
+        dileave(codes[i], expected[0], expected[1]);
+        BITMANIP_ASSERT_EQ(x[i], expected[0]);
+        BITMANIP_ASSERT_EQ(y[i], expected[1]);
+    }
+
+    dileaveBatch(codes, x, y, z, count);
+    for (size_t i = 0; i < count; ++i) {
+        std::uint32_t expected[3];
+        dileave(codes[i], expected[0], expected[1], expected[2]);
+        BITMANIP_ASSERT_EQ(x[i], expected[0]);
+        BITMANIP_ASSERT_EQ(y[i], expected[1]);
+        BITMANIP_ASSERT_EQ(z[i], expected[2]);
+    }
+
+#ifdef BITMANIP_HAS_SIMD_ILEAVE_BATCH
+    std::uint32_t *const outputs[] = {x, y, z};
+    const auto check2 = [&](size_t processed, size_t width) {
+        BITMANIP_ASSERT_EQ(processed, count / width * width);
+        for (size_t i = 0; i < processed; ++i) {
+            std::uint32_t expected[2];
+            dileave(codes[i], expected[0], expected[1]);
+            BITMANIP_ASSERT_EQ(x[i], expected[0]);
+            BITMANIP_ASSERT_EQ(y[i], expected[1]);
+        }
+    };
+    const auto check3 = [&](size_t processed, size_t width) {
+        BITMANIP_ASSERT_EQ(processed, count / width * width);
+        for (size_t i = 0; i < processed; ++i) {
+            std::uint32_t expected[3];
+            dileave(codes[i], expected[0], expected[1], expected[2]);
+            BITMANIP_ASSERT_EQ(x[i], expected[0]);
+            BITMANIP_ASSERT_EQ(y[i], expected[1]);
+            BITMANIP_ASSERT_EQ(z[i], expected[2]);
+        }
+    };
+    if (CPU_FEATURES.avx2) {
+        check2(detail::dileaveBatch_soa_avx2<2>(codes, outputs, count), 4);
+        check3(detail::dileaveBatch_soa_avx2<3>(codes, outputs, count), 4);
+    }
+    if (CPU_FEATURES.avx512f) {
+        check2(detail::dileaveBatch_soa_avx512<2>(codes, outputs, count), 8);
+        check3(detail::dileaveBatch_soa_avx512<3>(codes, outputs, count), 8);
+    }
+#endif
+}
+
+BITMANIP_TEST(bitileave, ileaveZeros_builtin_matches_shift)
+{
+#ifdef BITMANIP_HAS_BUILTIN_ILEAVE_ZEROS
+    if (not CPU_FEATURES.bmi2) {
+        return;
+    }
+
+    fast_rng64 rng{12345};
+    std::uniform_int_distribution<std::uint64_t> distr;
+
+    for (size_t i = 0; i < 1024; ++i) {
+        const std::uint64_t input = distr(rng);
+        const auto input32 = static_cast<std::uint32_t>(input);
+
+        BITMANIP_ASSERT_EQ((detail::ileaveZeros_builtin<1, 1>(input32)), detail::ileaveZeros_shift<1>(input32) << 1);
+        BITMANIP_ASSERT_EQ(detail::ileaveZeros_builtin<2>(input32), detail::ileaveZeros_shift<2>(input32));
+        BITMANIP_ASSERT_EQ(detail::ileaveZeros_builtin<7>(input32), detail::ileaveZeros_shift<7>(input32));
+
+        BITMANIP_ASSERT_EQ((detail::remIleavedBits_builtin<1, 1>(input)), detail::remIleavedBits_shift<1>(input >> 1));
+        BITMANIP_ASSERT_EQ(detail::remIleavedBits_builtin<2>(input), detail::remIleavedBits_shift<2>(input));
+        BITMANIP_ASSERT_EQ(detail::remIleavedBits_builtin<7>(input), detail::remIleavedBits_shift<7>(input));
+    }
+#endif
+}
+
+BITMANIP_TEST(bitileave, cpuFeatures_consistent)
+{
+    BITMANIP_ASSERT(CPU_FEATURES.bmi2 || not CPU_FEATURES.fastPdep);
+    BITMANIP_ASSERT(CPU_FEATURES.avx512f || not CPU_FEATURES.avx512bw);
+    BITMANIP_ASSERT(CPU_FEATURES.ssse3 || not CPU_FEATURES.avx2);
+#ifdef __BMI2__
+    BITMANIP_ASSERT(CPU_FEATURES.bmi2);
+#endif
+}
+
+BITMANIP_TEST(bitileave, lut_matches_naive)
+{
+    BITMANIP_STATIC_ASSERT_EQ(detail::ileaveZeros_lut<1>(0xffff'ffff), 0x5555'5555'5555'5555u);
+    BITMANIP_STATIC_ASSERT_EQ(detail::ileaveZeros_lut<2>(0xffff'ffff), 0x9249'2492'4924'9249u);
+    BITMANIP_STATIC_ASSERT_EQ(detail::remIleavedBits_lut<1>(0x5555'5555'5555'5555), 0xffff'ffffu);
+    BITMANIP_STATIC_ASSERT_EQ(detail::remIleavedBits_lut<2>(0x9249'2492'4924'9249), 0x3fffffu);
+
+    fast_rng64 rng{12345};
+    std::uniform_int_distribution<std::uint64_t> distr;
+
+    for (size_t i = 0; i < 1024 * 8; ++i) {
+        const std::uint64_t input = distr(rng);
+        const auto input32 = static_cast<std::uint32_t>(input);
+
+        BITMANIP_ASSERT_EQ(detail::ileaveZeros_lut<1>(input32), detail::ileaveZeros_naive(input32, 1));
+        BITMANIP_ASSERT_EQ(detail::ileaveZeros_lut<2>(input32), detail::ileaveZeros_naive(input32, 2));
+        BITMANIP_ASSERT_EQ(detail::ileaveZeros_lut<3>(input32), detail::ileaveZeros_naive(input32, 3));
+        BITMANIP_ASSERT_EQ(detail::ileaveZeros_lut<5>(input32), detail::ileaveZeros_naive(input32, 5));
+        BITMANIP_ASSERT_EQ(detail::ileaveZeros_lut<7>(input32), detail::ileaveZeros_naive(input32, 7));
+
+        BITMANIP_ASSERT_EQ(detail::remIleavedBits_lut<1>(input), detail::remIleavedBits_naive(input, 1));
+        BITMANIP_ASSERT_EQ(detail::remIleavedBits_lut<2>(input), detail::remIleavedBits_naive(input, 2));
+        BITMANIP_ASSERT_EQ(detail::remIleavedBits_lut<3>(input), detail::remIleavedBits_naive(input, 3));
+        BITMANIP_ASSERT_EQ(detail::remIleavedBits_lut<5>(input), detail::remIleavedBits_naive(input, 5));
+        BITMANIP_ASSERT_EQ(detail::remIleavedBits_lut<7>(input), detail::remIleavedBits_naive(input, 7));
+    }
+}
+
+#ifdef BITMANIP_HAS_INT128
+BITMANIP_TEST(bitileave, ileave128_manual)
+{
+    constexpr uint128_t allX = ileave128(~std::uint64_t{0}, std::uint64_t{0});
+    BITMANIP_STATIC_ASSERT_EQ(static_cast<std::uint64_t>(allX), 0xaaaa'aaaa'aaaa'aaaau);
+    BITMANIP_STATIC_ASSERT_EQ(static_cast<std::uint64_t>(allX >> 64), 0xaaaa'aaaa'aaaa'aaaau);
+
+    constexpr std::uint64_t max42 = (std::uint64_t{1} << 42) - 1;
+    constexpr uint128_t allZ = ileave128(std::uint64_t{0}, std::uint64_t{0}, max42);
+    BITMANIP_STATIC_ASSERT_EQ(static_cast<std::uint64_t>(allZ), 0x9249'2492'4924'9249u);
+    BITMANIP_STATIC_ASSERT_EQ(static_cast<std::uint64_t>(allZ >> 64), 0x1249'2492'4924'9249u >> 1);
+
+    BITMANIP_STATIC_ASSERT_EQ(static_cast<std::uint64_t>(ileave128(0x1234u, 0xabcdu)), ileave(0x1234u, 0xabcdu));
+}
+
+BITMANIP_TEST(bitileave, ileave128_matches_wide_and_dileave128)
+{
+    fast_rng64 rng{12345};
+    std::uniform_int_distribution<std::uint64_t> distr;
+
+    for (size_t i = 0; i < 1024; ++i) {
+        // wide::ileave_const stores the first input in the lowest bits, unlike ileave128
+        const std::uint64_t v[3]{distr(rng) >> 22, distr(rng) >> 22, distr(rng) >> 22};
+        const std::uint64_t reversed[3]{v[2], v[1], v[0]};
+
+        std::uint64_t expected[3];
+        wide::ileave_const<3>(reversed, expected);
+
+        const uint128_t actual = ileave128(v[0], v[1], v[2]);
+        BITMANIP_ASSERT_EQ(static_cast<std::uint64_t>(actual), expected[0]);
+        BITMANIP_ASSERT_EQ(static_cast<std::uint64_t>(actual >> 64), expected[1]);
+
+        std::uint64_t x, y, z;
+        dileave128(actual, x, y, z);
+        BITMANIP_ASSERT_EQ(x, v[0]);
+        BITMANIP_ASSERT_EQ(y, v[1]);
+        BITMANIP_ASSERT_EQ(z, v[2]);
+
+        const uint128_t actual2 = ileave128(v[0] << 22 | v[1], v[2] << 22 | v[0]);
+        dileave128(actual2, x, y);
+        BITMANIP_ASSERT_EQ(x, v[0] << 22 | v[1]);
+        BITMANIP_ASSERT_EQ(y, v[2] << 22 | v[0]);
+    }
+}
+#endif
+
+BITMANIP_TEST(bitileave, wide_ileave_const_matches_naive)
+{
+    fast_rng64 rng{12345};
+    std::uniform_int_distribution<std::uint64_t> distr;
+
+    for (size_t i = 0; i < 1024; ++i) {
+        std::uint64_t inputs[8];
+        for (auto &input : inputs) {
+            input = distr(rng);
+        }
+
+        std::uint64_t expected[8], actual[8], dileaved[8];
+        for (std::size_t count = 1; count <= 8; ++count) {
+            wide::detail::ileave_naive(inputs, expected, count);
+            wide::ileave(inputs, actual, count);
+            BITMANIP_ASSERT_EQ(std::memcmp(expected, actual, count * sizeof(std::uint64_t)), 0);
+
+            wide::dileave(actual, dileaved, count);
+            BITMANIP_ASSERT_EQ(std::memcmp(inputs, dileaved, count * sizeof(std::uint64_t)), 0);
+        }
+    }
+}
+
+template <typename Uint>
+void test_wide_ileave_const_matches_naive()
+{
+    fast_rng64 rng{12345};
+
+    for (size_t i = 0; i < 256; ++i) {
+        Uint inputs[8];
+        for (auto &input : inputs) {
+            input = static_cast<Uint>(rng());
+        }
+
+        std::uint64_t expected[8], actual[8];
+        Uint dileaved[8], dileavedNaive[8];
+        for (std::size_t count = 2; count <= 8; ++count) {
+            const std::size_t outputSize = divCeil(count * sizeof(Uint), sizeof(std::uint64_t));
+            wide::detail::ileave_naive(inputs, expected, count);
+            wide::ileave(inputs, actual, count);
+            BITMANIP_ASSERT_EQ(std::memcmp(expected, actual, outputSize * sizeof(std::uint64_t)), 0);
+
+            wide::dileave(actual, dileaved, count);
+            wide::detail::dileave_naive(actual, dileavedNaive, count);
+            BITMANIP_ASSERT_EQ(std::memcmp(inputs, dileaved, count * sizeof(Uint)), 0);
+            BITMANIP_ASSERT_EQ(std::memcmp(inputs, dileavedNaive, count * sizeof(Uint)), 0);
+        }
+    }
+}
+
+BITMANIP_TEST(bitileave, wide_ileave_const_matches_naive_narrow)
+{
+    test_wide_ileave_const_matches_naive<std::uint8_t>();
+    test_wide_ileave_const_matches_naive<std::uint16_t>();
+    test_wide_ileave_const_matches_naive<std::uint32_t>();
+}
+
 }  // namespace
 }  // namespace bitmanip
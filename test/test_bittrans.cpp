@@ -0,0 +1,93 @@
+#include "bitmanip/bittrans.hpp"
+
+#include "test.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace bitmanip {
+namespace {
+
+BITMANIP_TEST(bittrans, transpose8x8_manual)
+{
+    BITMANIP_STATIC_ASSERT_EQ(transpose8x8(0x0000'0000'0000'00ffu), 0x0101'0101'0101'0101u);
+    BITMANIP_STATIC_ASSERT_EQ(transpose8x8(0x8040'2010'0804'0201u), 0x8040'2010'0804'0201u);
+    BITMANIP_STATIC_ASSERT_EQ(transpose8x8(0x0000'0000'0000'0002u), 0x0000'0000'0000'0100u);
+}
+
+BITMANIP_TEST(bittrans, transpose8x8_matches_naive)
+{
+    fast_rng64 rng{12345};
+
+    for (std::size_t count : {0, 1, 2, 3, 4, 5, 7, 8, 100}) {
+        std::vector<std::uint64_t> in(count), out(count);
+        for (std::uint64_t &x : in) {
+            x = rng();
+        }
+        transpose8x8Batch(in.data(), out.data(), count);
+        for (std::size_t i = 0; i < count; ++i) {
+            BITMANIP_ASSERT_EQ(out[i], detail::transpose8x8_naive(in[i]));
+            BITMANIP_ASSERT_EQ(transpose8x8(in[i]), out[i]);
+            BITMANIP_ASSERT_EQ(transpose8x8(out[i]), in[i]);
+        }
+        transpose8x8Batch(out.data(), out.data(), count);
+        BITMANIP_ASSERT(out == in);
+    }
+}
+
+constexpr std::uint64_t rowOfTransposedColumn5(unsigned row)
+{
+    std::uint64_t matrix[64]{};
+    for (unsigned i = 0; i < 64; ++i) {
+        matrix[i] = std::uint64_t{1} << 5;
+    }
+    transpose64x64(matrix);
+    return matrix[row];
+}
+
+BITMANIP_TEST(bittrans, transpose64x64_manual)
+{
+    // a matrix whose column 5 is set turns into a matrix whose row 5 is set
+    BITMANIP_STATIC_ASSERT_EQ(rowOfTransposedColumn5(5), ~std::uint64_t{0});
+    BITMANIP_STATIC_ASSERT_EQ(rowOfTransposedColumn5(4), 0u);
+
+    std::uint64_t matrix[64]{};
+    matrix[3] = std::uint64_t{1} << 60;
+    transpose64x64(matrix);
+    BITMANIP_ASSERT_EQ(matrix[60], std::uint64_t{1} << 3);
+    BITMANIP_ASSERT_EQ(std::count(matrix, matrix + 64, 0u), 63);
+}
+
+BITMANIP_TEST(bittrans, transpose64x64_matches_naive)
+{
+    fast_rng64 rng{12345};
+
+    constexpr std::size_t count = 5;
+    std::vector<std::uint64_t> original(64 * count), expected, actual;
+    for (std::uint64_t &x : original) {
+        x = rng();
+    }
+
+    expected = original;
+    for (std::size_t i = 0; i < count; ++i) {
+        detail::transpose64x64_naive(expected.data() + i * 64);
+    }
+
+    actual = original;
+    transpose64x64Batch(actual.data(), count);
+    BITMANIP_ASSERT(actual == expected);
+
+    actual = original;
+    for (std::size_t i = 0; i < count; ++i) {
+        transpose64x64(actual.data() + i * 64);
+    }
+    BITMANIP_ASSERT(actual == expected);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        detail::transpose64x64_shift(actual.data() + i * 64);
+    }
+    BITMANIP_ASSERT(actual == original);
+}
+
+}  // namespace
+}  // namespace bitmanip
@@ -0,0 +1,123 @@
+#include "bitmanip/hilbert.hpp"
+
+#include "test.hpp"
+
+#include <vector>
+
+namespace bitmanip {
+namespace {
+
+constexpr std::uint32_t HILBERT_MASK_3 = (std::uint32_t{1} << 21) - 1;
+
+BITMANIP_TEST(hilbert, hilbertEncode_manual)
+{
+    BITMANIP_STATIC_ASSERT_EQ(hilbertEncode(0u, 0u), 0u);
+    BITMANIP_STATIC_ASSERT_EQ(hilbertEncode(0u, 0u, 0u), 0u);
+    BITMANIP_STATIC_ASSERT_EQ(mortonToHilbert<2>(0b10u), 0b01u);
+    BITMANIP_STATIC_ASSERT_EQ(hilbertToMorton<2>(0b01u), 0b10u);
+    // the first 2x2 block of the curve is traversed as (0, 0), (1, 0), (1, 1), (0, 1)
+    BITMANIP_STATIC_ASSERT_EQ(hilbertEncode(1u, 0u), 1u);
+    BITMANIP_STATIC_ASSERT_EQ(hilbertEncode(1u, 1u), 2u);
+    BITMANIP_STATIC_ASSERT_EQ(hilbertEncode(0u, 1u), 3u);
+}
+
+BITMANIP_TEST(hilbert, hilbertEncode_matches_naive)
+{
+    fast_rng32 rng{12345};
+
+    for (std::size_t i = 0; i < 1024 * 16; ++i) {
+        std::uint32_t p2[2]{rng(), rng()};
+        std::uint32_t p3[3]{rng() & HILBERT_MASK_3, rng() & HILBERT_MASK_3, rng() & HILBERT_MASK_3};
+
+        const auto h2 = hilbertEncode(p2[0], p2[1]);
+        const auto h3 = hilbertEncode(p3[0], p3[1], p3[2]);
+        BITMANIP_ASSERT_EQ(h2, detail::mortonToHilbert_naive<2>(ileave(p2[0], p2[1])));
+        BITMANIP_ASSERT_EQ(h3, detail::mortonToHilbert_naive<3>(ileave(p3[0], p3[1], p3[2])));
+        BITMANIP_ASSERT_EQ(h2, detail::hilbertEncode_naive<2>(p2));
+        BITMANIP_ASSERT_EQ(h3, detail::hilbertEncode_naive<3>(p3));
+    }
+}
+
+BITMANIP_TEST(hilbert, hilbertDecode_roundtrip)
+{
+    fast_rng64 rng{12345};
+
+    for (std::size_t i = 0; i < 1024 * 16; ++i) {
+        const unsigned long long index2 = rng();
+        const unsigned long long index3 = rng() >> 1;
+
+        std::uint32_t x, y, z, naive[3];
+        hilbertDecode(index2, x, y);
+        BITMANIP_ASSERT_EQ(hilbertEncode(x, y), index2);
+        detail::hilbertDecode_naive<2>(index2, naive);
+        BITMANIP_ASSERT_EQ(x, naive[0]);
+        BITMANIP_ASSERT_EQ(y, naive[1]);
+
+        hilbertDecode(index3, x, y, z);
+        BITMANIP_ASSERT_EQ(hilbertEncode(x, y, z), index3);
+        detail::hilbertDecode_naive<3>(index3, naive);
+        BITMANIP_ASSERT_EQ(x, naive[0]);
+        BITMANIP_ASSERT_EQ(y, naive[1]);
+        BITMANIP_ASSERT_EQ(z, naive[2]);
+    }
+}
+
+BITMANIP_TEST(hilbert, hilbertDecode_consecutiveIndicesAreNeighbors)
+{
+    const auto distance = [](std::uint32_t a, std::uint32_t b) -> std::uint32_t {
+        return a > b ? a - b : b - a;
+    };
+
+    fast_rng64 rng{12345};
+
+    for (std::size_t i = 0; i < 1024 * 16; ++i) {
+        const unsigned long long index2 = rng() >> 1;
+        const unsigned long long index3 = rng() >> 2;
+
+        std::uint32_t x0, y0, z0, x1, y1, z1;
+        hilbertDecode(index2, x0, y0);
+        hilbertDecode(index2 + 1, x1, y1);
+        BITMANIP_ASSERT_EQ(distance(x0, x1) + distance(y0, y1), 1u);
+
+        hilbertDecode(index3, x0, y0, z0);
+        hilbertDecode(index3 + 1, x1, y1, z1);
+        BITMANIP_ASSERT_EQ(distance(x0, x1) + distance(y0, y1) + distance(z0, z1), 1u);
+    }
+}
+
+BITMANIP_TEST(hilbert, hilbertBatch_matches_hilbert)
+{
+    constexpr std::size_t count = 1000;
+
+    fast_rng32 rng{12345};
+    std::vector<std::uint32_t> x(count), y(count), z(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        x[i] = rng();
+        y[i] = rng();
+        z[i] = rng();
+    }
+
+    std::vector<unsigned long long> indices2(count), indices3(count);
+    hilbertEncodeBatch(x.data(), y.data(), indices2.data(), count);
+    hilbertEncodeBatch(x.data(), y.data(), z.data(), indices3.data(), count);
+    for (std::size_t i = 0; i < count; ++i) {
+        BITMANIP_ASSERT_EQ(indices2[i], hilbertEncode(x[i], y[i]));
+        BITMANIP_ASSERT_EQ(indices3[i], hilbertEncode(x[i], y[i], z[i]));
+    }
+
+    std::vector<std::uint32_t> outX(count), outY(count), outZ(count);
+    hilbertDecodeBatch(indices2.data(), outX.data(), outY.data(), count);
+    for (std::size_t i = 0; i < count; ++i) {
+        BITMANIP_ASSERT_EQ(outX[i], x[i]);
+        BITMANIP_ASSERT_EQ(outY[i], y[i]);
+    }
+    hilbertDecodeBatch(indices3.data(), outX.data(), outY.data(), outZ.data(), count);
+    for (std::size_t i = 0; i < count; ++i) {
+        BITMANIP_ASSERT_EQ(outX[i], x[i] & HILBERT_MASK_3);
+        BITMANIP_ASSERT_EQ(outY[i], y[i] & HILBERT_MASK_3);
+        BITMANIP_ASSERT_EQ(outZ[i], z[i] & HILBERT_MASK_3);
+    }
+}
+
+}  // namespace
+}  // namespace bitmanip
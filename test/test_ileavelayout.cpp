@@ -0,0 +1,79 @@
+#include "bitmanip/ileavelayout.hpp"
+
+#include "test.hpp"
+
+namespace bitmanip {
+namespace {
+
+BITMANIP_TEST(ileavelayout, depositBits_extractBits_const_matches_naive)
+{
+    BITMANIP_STATIC_ASSERT_EQ(depositBits_const<0b1010>(0b11), 0b1010u);
+    BITMANIP_STATIC_ASSERT_EQ(extractBits_const<0b1010>(0b1000), 0b10u);
+
+    fast_rng64 rng{12345};
+    for (std::size_t i = 0; i < 1000; ++i) {
+        const std::uint64_t input = rng();
+        BITMANIP_ASSERT_EQ(depositBits_const<0x9249'2492'4924'9249>(input),
+                           detail::depositBits_naive(input, 0x9249'2492'4924'9249));
+        BITMANIP_ASSERT_EQ(extractBits_const<0x9249'2492'4924'9249>(input),
+                           detail::extractBits_naive(input, 0x9249'2492'4924'9249));
+        BITMANIP_ASSERT_EQ(depositBits_const<0xf0f0'0001'8000'ff00>(input),
+                           detail::depositBits_naive(input, 0xf0f0'0001'8000'ff00));
+        BITMANIP_ASSERT_EQ(extractBits_const<0xf0f0'0001'8000'ff00>(input),
+                           detail::extractBits_naive(input, 0xf0f0'0001'8000'ff00));
+        BITMANIP_ASSERT_EQ(detail::depositBits_shift_impl<0x8888'8888'8888'8888>(std::make_index_sequence<6>{}, input),
+                           detail::depositBits_naive(input, 0x8888'8888'8888'8888));
+        BITMANIP_ASSERT_EQ(detail::extractBits_shift_impl<0x3333'3333'3333'3333>(std::make_index_sequence<6>{}, input),
+                           detail::extractBits_naive(input, 0x3333'3333'3333'3333));
+        BITMANIP_ASSERT_EQ(detail::depositBits_shift_impl<0x8000'0000'0000'0001>(std::make_index_sequence<6>{}, input),
+                           detail::depositBits_naive(input, 0x8000'0000'0000'0001));
+        BITMANIP_ASSERT_EQ(detail::extractBits_shift_impl<0x8000'0000'0000'0001>(std::make_index_sequence<6>{}, input),
+                           detail::extractBits_naive(input, 0x8000'0000'0000'0001));
+    }
+}
+
+BITMANIP_TEST(ileavelayout, ileaveLayout_manual)
+{
+    using Asymmetric = IleaveLayout<0, 1, 2, 2>;
+    BITMANIP_STATIC_ASSERT_EQ(Asymmetric::AXIS_COUNT, 3u);
+    BITMANIP_STATIC_ASSERT_EQ(Asymmetric::MASKS[0], 0x8888'8888'8888'8888u);
+    BITMANIP_STATIC_ASSERT_EQ(Asymmetric::MASKS[2], 0x3333'3333'3333'3333u);
+    BITMANIP_STATIC_ASSERT((IleaveLayout<0, 1, 2>::SYMMETRIC));
+    BITMANIP_STATIC_ASSERT((not IleaveLayout<1, 0>::SYMMETRIC));
+
+    BITMANIP_STATIC_ASSERT_EQ(ileaveLayout<Asymmetric>(1u, 1u, 0b11u), 0b1111u);
+    BITMANIP_STATIC_ASSERT_EQ(ileaveLayout<Asymmetric>(0u, 0u, 0b100u), 0b1'0000u);
+    BITMANIP_STATIC_ASSERT_EQ((ileaveLayout<IleaveLayout<1, 0>>(0b11u, 0u)), 0b0101u);
+    BITMANIP_STATIC_ASSERT_EQ(ileaveLayout<IleaveLayout<0>>(123u), 123u);
+}
+
+template <typename Layout, std::size_t... I>
+void ileaveLayout_check(std::index_sequence<I...>, const std::uint32_t args[])
+{
+    const unsigned long long expected = (detail::depositBits_naive(args[I], Layout::MASKS[I]) | ...);
+    BITMANIP_ASSERT_EQ(ileaveLayout<Layout>(args[I]...), expected);
+
+    std::uint32_t out[sizeof...(I)]{};
+    dileaveLayout<Layout>(expected, out[I]...);
+    BITMANIP_ASSERT(((out[I] == static_cast<std::uint32_t>(detail::extractBits_naive(expected, Layout::MASKS[I]))) &&
+                     ...));
+}
+
+BITMANIP_TEST(ileavelayout, ileaveLayout_matches_naive)
+{
+    fast_rng32 rng{12345};
+    for (std::size_t i = 0; i < 1000; ++i) {
+        const std::uint32_t x = rng(), y = rng(), z = rng();
+        const std::uint32_t args[]{x, y, z};
+        ileaveLayout_check<IleaveLayout<0, 1, 2>>(std::make_index_sequence<3>{}, args);
+        ileaveLayout_check<IleaveLayout<2, 0, 1>>(std::make_index_sequence<3>{}, args);
+        ileaveLayout_check<IleaveLayout<0, 1, 2, 2>>(std::make_index_sequence<3>{}, args);
+        ileaveLayout_check<IleaveLayout<1, 0, 1, 1, 0>>(std::make_index_sequence<2>{}, args);
+        ileaveLayout_check<IleaveLayout<0, 1>>(std::make_index_sequence<2>{}, args);
+        BITMANIP_ASSERT_EQ((ileaveLayout<IleaveLayout<0, 1, 2>>(x, y, z)), ileave(x, y, z));
+        BITMANIP_ASSERT_EQ((ileaveLayout<IleaveLayout<2, 1, 0>>(x, y, z)), ileave(z, y, x));
+    }
+}
+
+}  // namespace
+}  // namespace bitmanip
@@ -0,0 +1,368 @@
+#include "bitmanip/morton.hpp"
+#include "bitmanip/mortonarray.hpp"
+#include "bitmanip/mortonsort.hpp"
+#include "bitmanip/mortontree.hpp"
+
+#include "test.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace bitmanip {
+namespace {
+
+BITMANIP_TEST(morton, mortonAxisMask_manual)
+{
+    BITMANIP_STATIC_ASSERT_EQ((mortonAxisMask<0, 2>()), 0xaaaa'aaaa'aaaa'aaaau);
+    BITMANIP_STATIC_ASSERT_EQ((mortonAxisMask<1, 2>()), 0x5555'5555'5555'5555u);
+    BITMANIP_STATIC_ASSERT_EQ((mortonAxisMask<2, 3>()), 0x9249'2492'4924'9249u);
+    BITMANIP_STATIC_ASSERT_EQ((mortonAxisMask<0, 3>() | mortonAxisMask<1, 3>() | mortonAxisMask<2, 3>()),
+                              ~std::uint64_t{0});
+}
+
+BITMANIP_TEST(morton, mortonIncAxis_manual)
+{
+    BITMANIP_STATIC_ASSERT_EQ((mortonIncAxis<1, 2>(ileave(5u, 7u))), ileave(5u, 8u));
+    BITMANIP_STATIC_ASSERT_EQ((mortonIncAxis<0, 3>(ileave(3u, 1u, 2u))), ileave(4u, 1u, 2u));
+    BITMANIP_STATIC_ASSERT_EQ((mortonDecAxis<2, 3>(ileave(3u, 1u, 2u))), ileave(3u, 1u, 1u));
+    BITMANIP_STATIC_ASSERT_EQ((mortonDecAxis<1, 2>(ileave(3u, 0u))), ileave(3u, 0xffff'ffffu));
+    BITMANIP_STATIC_ASSERT_EQ((mortonIncAxis<1, 2>(ileave(3u, 0xffff'ffffu))), ileave(3u, 0u));
+}
+
+BITMANIP_TEST(morton, mortonAdd_mortonSub_random)
+{
+    fast_rng32 rng{12345};
+    std::uniform_int_distribution<std::uint32_t> distr{0, (1u << 21) - 1};
+
+    constexpr std::uint32_t mask21 = (1u << 21) - 1;
+
+    for (size_t i = 0; i < 1024 * 8; ++i) {
+        const std::uint32_t ax = distr(rng), ay = distr(rng), az = distr(rng);
+        const std::uint32_t bx = distr(rng), by = distr(rng), bz = distr(rng);
+        const auto a = ileave(ax, ay, az), b = ileave(bx, by, bz);
+
+        std::uint32_t x, y, z;
+        dileave(mortonAdd<3>(a, b), x, y, z);
+        BITMANIP_ASSERT_EQ(x, (ax + bx) & mask21);
+        BITMANIP_ASSERT_EQ(y, (ay + by) & mask21);
+        // the lowest axis has one more bit in a 64-bit code
+        BITMANIP_ASSERT_EQ(z, (az + bz) & (mask21 << 1 | 1));
+
+        dileave(mortonSub<3>(a, b), x, y, z);
+        BITMANIP_ASSERT_EQ(x, (ax - bx) & mask21);
+        BITMANIP_ASSERT_EQ(y, (ay - by) & mask21);
+        BITMANIP_ASSERT_EQ(z, (az - bz) & (mask21 << 1 | 1));
+
+        const auto a2 = ileave(ax, ay), b2 = ileave(bx, by);
+        BITMANIP_ASSERT_EQ(mortonAdd<2>(a2, b2), ileave(ax + bx, ay + by));
+        BITMANIP_ASSERT_EQ(mortonSub<2>(a2, b2), ileave(ax - bx, ay - by));
+    }
+}
+
+template <std::size_t DIMS>
+void test_mortonNextPrevInBox_bruteForce(unsigned size)
+{
+    fast_rng32 rng{12345};
+    std::uniform_int_distribution<std::uint32_t> distr{0, size - 1};
+
+    const unsigned long long codeCount = 1ull << (DIMS * log2floor(size));
+
+    for (size_t i = 0; i < 64; ++i) {
+        std::uint32_t lo[DIMS], hi[DIMS];
+        for (std::size_t d = 0; d < DIMS; ++d) {
+            lo[d] = distr(rng);
+            hi[d] = distr(rng);
+            if (lo[d] > hi[d]) {
+                std::swap(lo[d], hi[d]);
+            }
+        }
+        const auto min = ileave(lo), max = ileave(hi);
+
+        for (unsigned long long code = 0; code < codeCount; ++code) {
+            unsigned long long expectedNext = 0, expectedPrev = 0;
+            bool hasNext = false, hasPrev = false;
+            for (unsigned long long c = code; c < codeCount && not hasNext; ++c) {
+                hasNext = mortonInBox<DIMS>(c, min, max);
+                expectedNext = c;
+            }
+            for (unsigned long long c = code + 1; c-- != 0 && not hasPrev;) {
+                hasPrev = mortonInBox<DIMS>(c, min, max);
+                expectedPrev = c;
+            }
+
+            unsigned long long actual = 0;
+            BITMANIP_ASSERT_EQ(mortonNextInBox<DIMS>(code, min, max, actual), hasNext);
+            if (hasNext) {
+                BITMANIP_ASSERT_EQ(actual, expectedNext);
+            }
+            BITMANIP_ASSERT_EQ(mortonPrevInBox<DIMS>(code, min, max, actual), hasPrev);
+            if (hasPrev) {
+                BITMANIP_ASSERT_EQ(actual, expectedPrev);
+            }
+        }
+    }
+}
+
+BITMANIP_TEST(morton, mortonNextPrevInBox_bruteForce)
+{
+    test_mortonNextPrevInBox_bruteForce<2>(32);
+    test_mortonNextPrevInBox_bruteForce<3>(8);
+}
+
+BITMANIP_TEST(morton, mortonSort_matches_stableSort)
+{
+    constexpr std::size_t count = 5000;
+
+    fast_rng32 rng{12345};
+    // small coordinates with many duplicates, so that stability and skipped passes are tested
+    std::uniform_int_distribution<std::uint32_t> distr{0, 63};
+
+    std::vector<std::uint32_t> points(count * 3);
+    for (std::uint32_t &p : points) {
+        p = distr(rng);
+    }
+
+    std::vector<MortonSortEntry> expected(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        expected[i] = {ileave(points[i * 3], points[i * 3 + 1], points[i * 3 + 2]), i};
+    }
+    std::stable_sort(expected.begin(), expected.end(), [](const MortonSortEntry &a, const MortonSortEntry &b) {
+        return a.key < b.key;
+    });
+
+    for (unsigned threadCount : {1u, 4u}) {
+        std::vector<MortonSortEntry> actual(count), scratch(count);
+        mortonSort<3>(points.data(), count, actual.data(), scratch.data(), threadCount);
+        for (std::size_t i = 0; i < count; ++i) {
+            BITMANIP_ASSERT_EQ(actual[i].key, expected[i].key);
+            BITMANIP_ASSERT_EQ(actual[i].index, expected[i].index);
+        }
+    }
+}
+
+BITMANIP_TEST(morton, mortonRadixSort_random)
+{
+    constexpr std::size_t count = 5000;
+
+    fast_rng64 rng{12345};
+    std::vector<MortonSortEntry> entries(count), scratch(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        entries[i] = {rng(), i};
+    }
+    std::vector<MortonSortEntry> expected = entries;
+    std::stable_sort(expected.begin(), expected.end(), [](const MortonSortEntry &a, const MortonSortEntry &b) {
+        return a.key < b.key;
+    });
+
+    mortonRadixSort(entries.data(), scratch.data(), count);
+    for (std::size_t i = 0; i < count; ++i) {
+        BITMANIP_ASSERT_EQ(entries[i].key, expected[i].key);
+        BITMANIP_ASSERT_EQ(entries[i].index, expected[i].index);
+    }
+}
+
+template <std::size_t DIMS, MortonStencil STENCIL>
+void mortonNeighbors_matches_dileave(std::uint64_t seed)
+{
+    constexpr std::size_t size = MORTON_STENCIL_SIZE<DIMS, STENCIL>;
+    fast_rng64 rng{seed};
+
+    std::uint32_t max[DIMS];
+    for (std::size_t i = 0; i < DIMS; ++i) {
+        max[i] = static_cast<std::uint32_t>(rng() % 5);
+    }
+    const unsigned long long maxCode = ileave<DIMS>(max);
+
+    for (std::size_t iteration = 0; iteration < 200; ++iteration) {
+        std::uint32_t cell[DIMS];
+        for (std::size_t i = 0; i < DIMS; ++i) {
+            cell[i] = static_cast<std::uint32_t>(rng() % (max[i] + 1));
+        }
+
+        unsigned long long out[size];
+        const unsigned long long mask = mortonNeighbors<DIMS, STENCIL>(ileave<DIMS>(cell), maxCode, out);
+
+        for (std::size_t n = 0; n < size; ++n) {
+            int offset[DIMS]{};
+            if constexpr (STENCIL == MortonStencil::FACES) {
+                offset[n / 2] = n % 2 == 0 ? -1 : 1;
+            }
+            else {
+                const std::size_t k = n < size / 2 ? n : n + 1;
+                for (std::size_t i = DIMS, digits = k; i-- != 0; digits /= 3) {
+                    offset[i] = static_cast<int>(digits % 3) - 1;
+                }
+            }
+
+            std::uint32_t neighbor[DIMS];
+            bool inside = true;
+            for (std::size_t i = 0; i < DIMS; ++i) {
+                const int coordinate = static_cast<int>(cell[i]) + offset[i];
+                neighbor[i] = static_cast<std::uint32_t>(coordinate);
+                inside &= coordinate >= 0 && coordinate <= static_cast<int>(max[i]);
+            }
+            BITMANIP_ASSERT_EQ((mask >> n) & 1, static_cast<unsigned long long>(inside));
+            if (inside) {
+                BITMANIP_ASSERT_EQ(out[n], ileave<DIMS>(neighbor));
+            }
+        }
+    }
+}
+
+BITMANIP_TEST(morton, mortonNeighbors_matches_dileave)
+{
+    BITMANIP_STATIC_ASSERT_EQ((MORTON_STENCIL_SIZE<3, MortonStencil::FULL>), 26u);
+    BITMANIP_STATIC_ASSERT_EQ((MORTON_STENCIL_SIZE<3, MortonStencil::FACES>), 6u);
+
+    mortonNeighbors_matches_dileave<2, MortonStencil::FACES>(1);
+    mortonNeighbors_matches_dileave<2, MortonStencil::FULL>(2);
+    mortonNeighbors_matches_dileave<3, MortonStencil::FACES>(3);
+    mortonNeighbors_matches_dileave<3, MortonStencil::FULL>(4);
+
+    const unsigned long long codes[]{ileave(1u, 1u, 1u), ileave(0u, 3u, 2u)};
+    unsigned long long batch[2 * 26], single[26], masks[2];
+    mortonNeighborsBatch<3>(codes, ileave(3u, 3u, 3u), batch, masks, 2);
+    for (std::size_t i = 0; i < 2; ++i) {
+        BITMANIP_ASSERT_EQ(masks[i], mortonNeighbors<3>(codes[i], ileave(3u, 3u, 3u), single));
+        BITMANIP_ASSERT(std::equal(single, single + 26, batch + i * 26));
+    }
+    BITMANIP_ASSERT_EQ(masks[0], (1ull << 26) - 1);
+}
+
+BITMANIP_TEST(morton, mortonArray3_neighbors)
+{
+    using Array = MortonArray3<int, 3>;
+
+    BITMANIP_STATIC_ASSERT_EQ(Array::indexOf(0, 0, 1), 1u);
+    BITMANIP_STATIC_ASSERT_EQ(Array::indexOf(1, 0, 0), 4u);
+    BITMANIP_STATIC_ASSERT_EQ(Array::next<2>(Array::indexOf(0, 0, 7)), Array::indexOf(0, 0, 0));
+    BITMANIP_STATIC_ASSERT_EQ(Array::prev<0>(Array::indexOf(0, 5, 3)), Array::indexOf(7, 5, 3));
+
+    for (std::uint32_t x = 0; x < Array::SIZE; ++x) {
+        for (std::uint32_t y = 0; y < Array::SIZE; ++y) {
+            for (std::uint32_t z = 0; z < Array::SIZE; ++z) {
+                const std::size_t index = Array::indexOf(x, y, z);
+                const std::uint32_t x1 = (x + 1) % Array::SIZE, y1 = (y + 1) % Array::SIZE;
+                BITMANIP_ASSERT_EQ(Array::next<0>(index), Array::indexOf(x1, y, z));
+                BITMANIP_ASSERT_EQ(Array::next<1>(index), Array::indexOf(x, y1, z));
+                BITMANIP_ASSERT_EQ(Array::prev<1>(Array::next<1>(index)), index);
+
+                std::uint32_t cx, cy, cz;
+                Array::coordinatesOf(index, cx, cy, cz);
+                BITMANIP_ASSERT_EQ(cx, x);
+                BITMANIP_ASSERT_EQ(cy, y);
+                BITMANIP_ASSERT_EQ(cz, z);
+            }
+        }
+    }
+}
+
+BITMANIP_TEST(morton, mortonArray3_rowMajor_roundTrip)
+{
+    using Array = MortonArray3<std::uint32_t, 4>;
+    constexpr std::uint32_t size = Array::SIZE;
+
+    std::vector<std::uint32_t> rowMajor(Array::VOLUME);
+    for (std::uint32_t i = 0; i < rowMajor.size(); ++i) {
+        rowMajor[i] = i;
+    }
+
+    Array array;
+    array.fromRowMajor(rowMajor.data());
+    for (std::uint32_t x = 0; x < size; ++x) {
+        for (std::uint32_t y = 0; y < size; ++y) {
+            for (std::uint32_t z = 0; z < size; ++z) {
+                BITMANIP_ASSERT_EQ(array(x, y, z), (x * size + y) * size + z);
+            }
+        }
+    }
+
+    std::vector<std::uint32_t> copy(Array::VOLUME);
+    array.toRowMajor(copy.data());
+    BITMANIP_ASSERT(copy == rowMajor);
+}
+
+BITMANIP_TEST(morton, mortonTree_keys_manual)
+{
+    constexpr unsigned long long code = ileave(std::uint32_t{5} << 18, std::uint32_t{3} << 18, std::uint32_t{6} << 18);
+    // the digits of the code are 0b101, 0b011 and 0b110 on the first three levels
+    BITMANIP_STATIC_ASSERT_EQ(mortonTreeKey<3>(code, 0), 1u);
+    BITMANIP_STATIC_ASSERT_EQ(mortonTreeKey<3>(code, 1), 0b1'101u);
+    BITMANIP_STATIC_ASSERT_EQ(mortonTreeKey<3>(code, 3), 0b1'101'011'110u);
+    BITMANIP_STATIC_ASSERT_EQ(mortonTreeLevel<3>(0b1'101'011'110u), 3u);
+    BITMANIP_STATIC_ASSERT_EQ(mortonTreeParent<3>(0b1'101'011'110u), 0b1'101'011u);
+    BITMANIP_STATIC_ASSERT_EQ(mortonTreeChild<3>(0b1'101u, 0b011), 0b1'101'011u);
+    BITMANIP_STATIC_ASSERT_EQ(mortonTreeSibling<3>(0b1'101'011u, 0b111), 0b1'101'111u);
+    BITMANIP_STATIC_ASSERT_EQ(mortonTreeFirstCode<3>(0b1'101u), 0b101ull << 60);
+    BITMANIP_STATIC_ASSERT_EQ(mortonTreeLastCode<3>(0b1'101u), (0b110ull << 60) - 1);
+    BITMANIP_STATIC_ASSERT_EQ(mortonTreeLastCode<2>(1u), ~0ull);
+    BITMANIP_STATIC_ASSERT_EQ(mortonCommonLevel<3>(code, code), MORTON_TREE_MAX_LEVEL<3>);
+    BITMANIP_STATIC_ASSERT_EQ(mortonCommonLevel<3>(code, code ^ (1ull << 58)), 1u);
+    BITMANIP_STATIC_ASSERT_EQ(mortonCommonLevel<2>(0, 1ull << 63), 0u);
+}
+
+template <std::size_t DIMS>
+void mortonTreeBuild_reference(const std::vector<unsigned long long> &codes,
+                               unsigned long long key,
+                               std::size_t maxLeafSize,
+                               std::vector<MortonTreeNode> &nodes)
+{
+    const auto begin = std::lower_bound(codes.begin(), codes.end(), mortonTreeFirstCode<DIMS>(key));
+    const auto end = std::upper_bound(codes.begin(), codes.end(), mortonTreeLastCode<DIMS>(key));
+    if (begin == end) {
+        return;
+    }
+    const std::size_t index = nodes.size();
+    const auto first = static_cast<std::size_t>(begin - codes.begin());
+    const auto last = static_cast<std::size_t>(end - codes.begin());
+    nodes.push_back({key, first, last, 0});
+    if (last - first > maxLeafSize && mortonTreeLevel<DIMS>(key) < MORTON_TREE_MAX_LEVEL<DIMS>) {
+        for (unsigned i = 0; i < (1u << DIMS); ++i) {
+            mortonTreeBuild_reference<DIMS>(codes, mortonTreeChild<DIMS>(key, i), maxLeafSize, nodes);
+        }
+    }
+    nodes[index].next = nodes.size();
+}
+
+template <std::size_t DIMS>
+void mortonTreeBuild_matches_reference(std::uint64_t seed)
+{
+    fast_rng64 rng{seed};
+
+    for (std::size_t count : {0, 1, 2, 50, 1000}) {
+        std::vector<unsigned long long> codes(count);
+        for (unsigned long long &code : codes) {
+            // few distinct upper bits, so that the tree gets deep, and some duplicates
+            code = rng() % 4 == 0 ? 0x1234'5678'9abc'def0 >> (64 - MORTON_CODE_BITS<DIMS>)
+                                  : (rng() >> (64 - MORTON_CODE_BITS<DIMS>)) & ~(0xffull << 40);
+        }
+        std::sort(codes.begin(), codes.end());
+
+        for (std::size_t maxLeafSize : {1, 3, 16}) {
+            std::vector<MortonTreeNode> expected;
+            if (count != 0) {
+                mortonTreeBuild_reference<DIMS>(codes, 1, maxLeafSize, expected);
+            }
+            for (unsigned threadCount : {1, 3, 8}) {
+                std::vector<MortonTreeNode> actual;
+                mortonTreeBuild<DIMS>(codes.data(), count, maxLeafSize, actual, threadCount);
+                BITMANIP_ASSERT_EQ(actual.size(), expected.size());
+                for (std::size_t i = 0; i < expected.size(); ++i) {
+                    BITMANIP_ASSERT_EQ(actual[i].key, expected[i].key);
+                    BITMANIP_ASSERT_EQ(actual[i].begin, expected[i].begin);
+                    BITMANIP_ASSERT_EQ(actual[i].end, expected[i].end);
+                    BITMANIP_ASSERT_EQ(actual[i].next, expected[i].next);
+                }
+            }
+        }
+    }
+}
+
+BITMANIP_TEST(morton, mortonTreeBuild_matches_reference)
+{
+    mortonTreeBuild_matches_reference<2>(12345);
+    mortonTreeBuild_matches_reference<3>(67890);
+}
+
+}  // namespace
+}  // namespace bitmanip
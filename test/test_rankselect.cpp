@@ -0,0 +1,88 @@
+#include "bitmanip/rankselect.hpp"
+
+#include "test.hpp"
+
+#include <vector>
+
+namespace bitmanip {
+namespace {
+
+void testRankSelect(const std::vector<std::uint64_t> &words, std::size_t bitCount, unsigned threadCount)
+{
+    const RankSelectBitVector vector{words, bitCount, threadCount};
+    BITMANIP_ASSERT_EQ(vector.size(), bitCount);
+
+    std::size_t rank = 0;
+    for (std::size_t i = 0; i < bitCount; ++i) {
+        const bool bit = (words[i / 64] >> (i % 64)) & 1;
+        BITMANIP_ASSERT_EQ(vector[i], bit);
+        BITMANIP_ASSERT_EQ(vector.rank1(i), rank);
+        BITMANIP_ASSERT_EQ(vector.rank0(i), i - rank);
+        if (bit) {
+            BITMANIP_ASSERT_EQ(vector.select1(rank), i);
+            ++rank;
+        }
+    }
+    BITMANIP_ASSERT_EQ(vector.rank1(bitCount), rank);
+    BITMANIP_ASSERT_EQ(vector.count(), rank);
+    BITMANIP_ASSERT_EQ(vector.select1(rank), bitCount);
+}
+
+BITMANIP_TEST(rankselect, rankSelect_manual)
+{
+    const RankSelectBitVector vector{{0b1011'0100, 0, 1}, 129};
+    BITMANIP_ASSERT_EQ(vector.count(), 5u);
+    BITMANIP_ASSERT_EQ(vector.rank1(0), 0u);
+    BITMANIP_ASSERT_EQ(vector.rank1(3), 1u);
+    BITMANIP_ASSERT_EQ(vector.rank1(128), 4u);
+    BITMANIP_ASSERT_EQ(vector.rank1(129), 5u);
+    BITMANIP_ASSERT_EQ(vector.select1(0), 2u);
+    BITMANIP_ASSERT_EQ(vector.select1(3), 7u);
+    BITMANIP_ASSERT_EQ(vector.select1(4), 128u);
+    BITMANIP_ASSERT_EQ(vector.select1(5), 129u);
+
+    // bits past the size are ignored
+    const RankSelectBitVector truncated{{~std::uint64_t{0}}, 3};
+    BITMANIP_ASSERT_EQ(truncated.count(), 3u);
+    BITMANIP_ASSERT_EQ(truncated.select1(3), 3u);
+
+    const RankSelectBitVector empty;
+    BITMANIP_ASSERT_EQ(empty.size(), 0u);
+    BITMANIP_ASSERT_EQ(empty.count(), 0u);
+    BITMANIP_ASSERT_EQ(empty.rank1(0), 0u);
+    BITMANIP_ASSERT_EQ(empty.rank0(0), 0u);
+    BITMANIP_ASSERT_EQ(empty.select1(0), 0u);
+}
+
+BITMANIP_TEST(rankselect, rankSelect_matches_naive)
+{
+    fast_rng64 rng{12345};
+
+    for (unsigned density = 0; density < 3; ++density) {
+        const std::vector<std::uint64_t> words = makeRandomWords(rng, 2000, density);
+        for (std::size_t bitCount : {0, 1, 63, 64, 65, 511, 512, 2047, 2048, 2049, 50'000, 2000 * 64}) {
+            testRankSelect(words, bitCount, 1);
+        }
+    }
+}
+
+BITMANIP_TEST(rankselect, rankSelect_parallel)
+{
+    fast_rng64 rng{12345};
+    // enough one-bits for many select samples
+    const std::vector<std::uint64_t> words = makeRandomWords(rng, 20'000, 2);
+    for (unsigned threadCount : {2, 3, 8}) {
+        testRankSelect(words, words.size() * 64 - 5, threadCount);
+    }
+}
+
+BITMANIP_TEST(rankselect, rankSelect_overhead)
+{
+    const std::vector<std::uint64_t> words(1 << 16, ~std::uint64_t{0});
+    const RankSelectBitVector vector{words, words.size() * 64};
+    BITMANIP_ASSERT(vector.indexBytes() * 100 < words.size() * 8 * 4);
+    BITMANIP_ASSERT_EQ(vector.select1(vector.count() - 1), vector.size() - 1);
+}
+
+}  // namespace
+}  // namespace bitmanip
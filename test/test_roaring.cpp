@@ -0,0 +1,201 @@
+#include "bitmanip/roaring.hpp"
+
+#include "test.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+namespace bitmanip {
+namespace {
+
+std::vector<std::uint16_t> makeSortedValues(fast_rng64 &rng, std::size_t count, std::uint64_t range)
+{
+    std::vector<std::uint16_t> result(count);
+    for (std::uint16_t &v : result) {
+        v = static_cast<std::uint16_t>(rng() % range);
+    }
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+}
+
+/// Returns sorted values where every chunk is sparse, dense or made of runs.
+std::vector<std::uint32_t> makeMixedValues(fast_rng64 &rng, unsigned chunkCount)
+{
+    std::vector<std::uint32_t> result;
+    for (std::uint32_t chunk = 0; chunk < chunkCount; ++chunk) {
+        const std::uint32_t high = static_cast<std::uint32_t>(rng() % 3) * 0x1'0000 + chunk * 0x3'0000;
+        switch (rng() % 4) {
+        case 0: {
+            for (std::uint16_t v : makeSortedValues(rng, 1 + rng() % 100, 0x1'0000)) {
+                result.push_back(high | v);
+            }
+            break;
+        }
+        case 1: {
+            for (std::uint16_t v : makeSortedValues(rng, 3000 + rng() % 40000, 0x1'0000)) {
+                result.push_back(high | v);
+            }
+            break;
+        }
+        case 2: {
+            for (auto start = static_cast<std::uint32_t>(rng() % 1000); start < 0x1'0000;
+                 start += static_cast<std::uint32_t>(1000 + rng() % 3000)) {
+                for (std::uint32_t v = start; v < std::min(start + 500, std::uint32_t{0x1'0000}); ++v) {
+                    result.push_back(high | v);
+                }
+            }
+            break;
+        }
+        default: break;
+        }
+    }
+    return result;
+}
+
+std::vector<std::uint32_t> toVector(const RoaringBitmap &bitmap)
+{
+    std::vector<std::uint32_t> result;
+    bitmap.forEach([&result](std::uint32_t v) {
+        result.push_back(v);
+    });
+    return result;
+}
+
+BITMANIP_TEST(roaring, arrays_match_naive)
+{
+    fast_rng64 rng{12345};
+
+    for (std::size_t na : {0, 5, 8, 100, 4000}) {
+        for (std::size_t nb : {0, 7, 16, 100, 4000}) {
+            const std::vector<std::uint16_t> a = makeSortedValues(rng, na, na + nb + 1);
+            const std::vector<std::uint16_t> b = makeSortedValues(rng, nb, na + nb + 1);
+
+            std::vector<std::uint16_t> expectedAnd, expectedAndNot, expectedOr;
+            std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expectedAnd));
+            std::set_difference(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expectedAndNot));
+            std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expectedOr));
+
+            std::vector<std::uint16_t> out(a.size() + b.size() + detail::ROARING_ARRAY_PADDING);
+            const auto check = [&](std::size_t n, const std::vector<std::uint16_t> &expected) {
+                BITMANIP_ASSERT(std::vector<std::uint16_t>(out.begin(), out.begin() + static_cast<long>(n)) ==
+                                expected);
+            };
+
+            check(detail::intersectArrays(a.data(), a.size(), b.data(), b.size(), out.data()), expectedAnd);
+            check(detail::intersectArrays_scalar(a.data(), a.size(), b.data(), b.size(), out.data()), expectedAnd);
+            check(detail::intersectArrays_gallop(a.data(), a.size(), b.data(), b.size(), out.data()), expectedAnd);
+            check(detail::subtractArrays(a.data(), a.size(), b.data(), b.size(), out.data()), expectedAndNot);
+            check(detail::subtractArrays_scalar(a.data(), a.size(), b.data(), b.size(), out.data()), expectedAndNot);
+            check(detail::subtractArrays_gallop(a.data(), a.size(), b.data(), b.size(), out.data()), expectedAndNot);
+            check(detail::uniteArrays(a.data(), a.size(), b.data(), b.size(), out.data()), expectedOr);
+#ifdef BITMANIP_HAS_SIMD_ROARING
+            if (CPU_FEATURES.ssse3 && CPU_FEATURES.popcnt) {
+                check(detail::intersectArrays_ssse3(a.data(), a.size(), b.data(), b.size(), out.data()), expectedAnd);
+                check(detail::subtractArrays_ssse3(a.data(), a.size(), b.data(), b.size(), out.data()),
+                      expectedAndNot);
+            }
+#endif
+        }
+    }
+}
+
+BITMANIP_TEST(roaring, manual)
+{
+    RoaringBitmap bitmap;
+    BITMANIP_ASSERT(bitmap.empty());
+    BITMANIP_ASSERT(bitmap.add(7));
+    BITMANIP_ASSERT(not bitmap.add(7));
+    BITMANIP_ASSERT(bitmap.add(0xffff'ffff));
+    BITMANIP_ASSERT(bitmap.contains(7));
+    BITMANIP_ASSERT(bitmap.contains(0xffff'ffff));
+    BITMANIP_ASSERT(not bitmap.contains(8));
+    BITMANIP_ASSERT_EQ(bitmap.count(), 2u);
+
+    // an array container becomes a bitmap container and back
+    for (std::uint32_t v = 0x1'0000; v < 0x1'0000 + 5000; ++v) {
+        bitmap.add(v);
+    }
+    BITMANIP_ASSERT_EQ(bitmap.count(), 5002u);
+    for (std::uint32_t v = 0x1'0000; v < 0x1'0000 + 4990; ++v) {
+        BITMANIP_ASSERT(bitmap.remove(v));
+    }
+    BITMANIP_ASSERT(not bitmap.remove(0x1'0000));
+    BITMANIP_ASSERT_EQ(bitmap.count(), 12u);
+    BITMANIP_ASSERT(bitmap.contains(0x1'0000 + 4990));
+
+    // runs are smaller than 5000 values and stay equal to the same values in other containers
+    std::vector<std::uint32_t> values;
+    for (std::uint32_t v = 0x5'0000; v < 0x5'0000 + 5000; ++v) {
+        values.push_back(v);
+    }
+    RoaringBitmap runs{values.data(), values.size()};
+    const RoaringBitmap plain = runs;
+    const std::size_t plainBytes = runs.memoryBytes();
+    runs.runOptimize();
+    BITMANIP_ASSERT(runs.memoryBytes() < plainBytes);
+    BITMANIP_ASSERT(runs == plain);
+    BITMANIP_ASSERT(runs.contains(0x5'0000 + 4999));
+    BITMANIP_ASSERT(not runs.contains(0x5'0000 + 5000));
+    BITMANIP_ASSERT(runs.remove(0x5'0000 + 100));
+    BITMANIP_ASSERT(runs != plain);
+    BITMANIP_ASSERT_EQ(runs.count(), 4999u);
+    BITMANIP_ASSERT(runs.add(0x5'0000 + 100));
+    BITMANIP_ASSERT(runs == plain);
+}
+
+BITMANIP_TEST(roaring, setOperations_match_naive)
+{
+    fast_rng64 rng{12345};
+
+    for (unsigned iteration = 0; iteration < 8; ++iteration) {
+        const std::vector<std::uint32_t> a = makeMixedValues(rng, 6);
+        const std::vector<std::uint32_t> b = makeMixedValues(rng, 6);
+        RoaringBitmap x{a.data(), a.size()}, y{b.data(), b.size()};
+        if (iteration % 2 == 1) {
+            x.runOptimize();
+        }
+        if (iteration % 4 >= 2) {
+            y.runOptimize();
+        }
+        BITMANIP_ASSERT(toVector(x) == a);
+        BITMANIP_ASSERT_EQ(x.count(), a.size());
+        for (std::size_t i = 0; i < a.size(); i += 97) {
+            BITMANIP_ASSERT(x.contains(a[i]));
+        }
+
+        std::vector<std::uint32_t> expected;
+        std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+        BITMANIP_ASSERT(toVector(x & y) == expected);
+        BITMANIP_ASSERT((x & y) == RoaringBitmap(expected.data(), expected.size()));
+
+        expected.clear();
+        std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+        BITMANIP_ASSERT(toVector(x | y) == expected);
+        BITMANIP_ASSERT((x | y) == RoaringBitmap(expected.data(), expected.size()));
+
+        expected.clear();
+        std::set_difference(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+        BITMANIP_ASSERT(toVector(x - y) == expected);
+        x -= y;
+        BITMANIP_ASSERT(x == RoaringBitmap(expected.data(), expected.size()));
+    }
+}
+
+BITMANIP_TEST(roaring, sparse_smaller_than_bits)
+{
+    fast_rng64 rng{12345};
+    std::vector<std::uint32_t> values(10'000);
+    for (std::uint32_t &v : values) {
+        v = static_cast<std::uint32_t>(rng() % (std::uint64_t{1} << 28));
+    }
+    std::sort(values.begin(), values.end());
+
+    RoaringBitmap bitmap{values.data(), values.size()};
+    const wide::DynamicBits bits{std::size_t{1} << 28};
+    BITMANIP_ASSERT(bitmap.memoryBytes() * 10 < bits.wordCount() * sizeof(std::uint64_t));
+}
+
+}  // namespace
+}  // namespace bitmanip
@@ -0,0 +1,105 @@
+#include "bitmanip/setbits.hpp"
+
+#include "test.hpp"
+
+#include <vector>
+
+namespace bitmanip {
+namespace {
+
+std::vector<std::uint32_t> decodeSetBits_naive(const std::vector<std::uint64_t> &words)
+{
+    std::vector<std::uint32_t> result;
+    for (std::size_t i = 0; i < words.size() * 64; ++i) {
+        if ((words[i / 64] >> (i % 64)) & 1) {
+            result.push_back(static_cast<std::uint32_t>(i));
+        }
+    }
+    return result;
+}
+
+BITMANIP_TEST(setbits, decodeSetBits_manual)
+{
+    const std::uint64_t words[]{0b1001, 0, std::uint64_t{1} << 63};
+    std::uint32_t out[3 + DECODE_SET_BITS_PADDING];
+    BITMANIP_ASSERT_EQ(decodeSetBits(words, 3, out), 3u);
+    BITMANIP_ASSERT_EQ(out[0], 0u);
+    BITMANIP_ASSERT_EQ(out[1], 3u);
+    BITMANIP_ASSERT_EQ(out[2], 191u);
+    BITMANIP_ASSERT_EQ(decodeSetBits(words, 0, out), 0u);
+}
+
+BITMANIP_TEST(setbits, decodeSetBits_matches_naive)
+{
+    fast_rng64 rng{12345};
+
+    for (unsigned density = 0; density < 3; ++density) {
+        for (std::size_t count : {0, 1, 2, 15, 16, 17, 100}) {
+            const std::vector<std::uint64_t> words = makeRandomWords(rng, count, density);
+            const std::vector<std::uint32_t> expected = decodeSetBits_naive(words);
+            std::vector<std::uint32_t> out(count * 64 + DECODE_SET_BITS_PADDING);
+
+            out.resize(detail::decodeSetBits_ctz(words.data(), count, out.data()));
+            BITMANIP_ASSERT(out == expected);
+#ifdef BITMANIP_HAS_SIMD_SET_BITS
+            if (CPU_FEATURES.avx2 && CPU_FEATURES.popcnt) {
+                out.resize(count * 64 + DECODE_SET_BITS_PADDING);
+                out.resize(detail::decodeSetBits_avx2(words.data(), count, out.data()));
+                BITMANIP_ASSERT(out == expected);
+            }
+            if (CPU_FEATURES.avx512f && CPU_FEATURES.popcnt) {
+                out.resize(count * 64 + DECODE_SET_BITS_PADDING);
+                out.resize(detail::decodeSetBits_avx512(words.data(), count, out.data()));
+                BITMANIP_ASSERT(out == expected);
+            }
+#endif
+        }
+    }
+}
+
+BITMANIP_TEST(setbits, forEachSetBit_matches_naive)
+{
+    fast_rng64 rng{12345};
+
+    for (unsigned density = 0; density < 3; ++density) {
+        for (std::size_t count : {0, 1, 16, 17, 1000}) {
+            const std::vector<std::uint64_t> words = makeRandomWords(rng, count, density);
+            const std::vector<std::uint32_t> expected = decodeSetBits_naive(words);
+
+            std::vector<std::uint32_t> actual;
+            forEachSetBit(words.data(), count, [&actual](std::size_t i) {
+                actual.push_back(static_cast<std::uint32_t>(i));
+            });
+            BITMANIP_ASSERT(actual == expected);
+
+            actual.clear();
+            for (std::size_t i : SetBitRange{words.data(), count}) {
+                actual.push_back(static_cast<std::uint32_t>(i));
+            }
+            BITMANIP_ASSERT(actual == expected);
+        }
+    }
+}
+
+BITMANIP_TEST(setbits, setBitRange_resume)
+{
+    // the first 16 words are empty, so the range has to skip a whole chunk
+    std::vector<std::uint64_t> words(40);
+    words[16] = 0b110;
+    words[39] = std::uint64_t{1} << 63;
+
+    SetBitRange range{words.data(), words.size()};
+    SetBitIterator it = range.begin();
+    BITMANIP_ASSERT_EQ(*it++, 16u * 64 + 1);
+    BITMANIP_ASSERT_EQ(*it, 16u * 64 + 2);
+
+    // a new iterator continues at the current position
+    it = range.begin();
+    BITMANIP_ASSERT_EQ(*it, 16u * 64 + 2);
+    BITMANIP_ASSERT_EQ(*++it, 39u * 64 + 63);
+    BITMANIP_ASSERT(++it == range.end());
+    BITMANIP_ASSERT(range.begin() == range.end());
+}
+
+}  // namespace
+}  // namespace bitmanip
@@ -0,0 +1,76 @@
+#include "bitmanip/shuffle.hpp"
+
+#include "test.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace bitmanip {
+namespace {
+
+BITMANIP_TEST(shuffle, shuffleBytes_manual)
+{
+    const unsigned char elements[]{0x01, 0x02, 0x03, 0x11, 0x12, 0x13};
+    const unsigned char expected[]{0x01, 0x11, 0x02, 0x12, 0x03, 0x13};
+
+    unsigned char shuffled[6]{}, unshuffled[6]{};
+    shuffleBytes(elements, shuffled, 3, 2);
+    BITMANIP_ASSERT_EQ(std::memcmp(shuffled, expected, sizeof(expected)), 0);
+    unshuffleBytes(shuffled, unshuffled, 3, 2);
+    BITMANIP_ASSERT_EQ(std::memcmp(unshuffled, elements, sizeof(elements)), 0);
+}
+
+BITMANIP_TEST(shuffle, shuffleBytes_matches_naive)
+{
+    fast_rng32 rng{12345};
+
+    for (std::size_t elemSize = 1; elemSize <= 17; ++elemSize) {
+        for (std::size_t count : {0, 1, 15, 16, 17, 31, 32, 33, 48, 100, 1016}) {
+            std::vector<unsigned char> src(elemSize * count), expected(src.size()), actual(src.size());
+            for (unsigned char &b : src) {
+                b = static_cast<unsigned char>(rng());
+            }
+
+            detail::shuffleBytes_naive(src.data(), expected.data(), elemSize, count);
+            shuffleBytes(src.data(), actual.data(), elemSize, count);
+            BITMANIP_ASSERT(expected == actual);
+
+            unshuffleBytes(actual.data(), expected.data(), elemSize, count);
+            BITMANIP_ASSERT(expected == src);
+        }
+    }
+}
+
+BITMANIP_TEST(shuffle, shuffleBits_matches_definition)
+{
+    fast_rng32 rng{12345};
+
+    for (std::size_t elemSize = 1; elemSize <= 17; ++elemSize) {
+        for (std::size_t count : {0, 7, 8, 15, 16, 24, 32, 40, 100, 1016}) {
+            std::vector<unsigned char> src(elemSize * count), actual(src.size()), unshuffled(src.size());
+            for (unsigned char &b : src) {
+                b = static_cast<unsigned char>(rng());
+            }
+            shuffleBits(src.data(), actual.data(), elemSize, count);
+
+            const std::size_t n = count / 8 * 8;
+            std::vector<unsigned char> expected(src.size());
+            for (std::size_t i = 0; i < n; ++i) {
+                for (std::size_t k = 0; k < elemSize * 8; ++k) {
+                    const bool bit = (src[i * elemSize + k / 8] >> (k % 8)) & 1;
+                    const std::size_t target = k * n + i;
+                    expected[target / 8] |= static_cast<unsigned char>(bit << (target % 8));
+                }
+            }
+            std::copy(src.begin() + static_cast<std::ptrdiff_t>(n * elemSize), src.end(),
+                      expected.begin() + static_cast<std::ptrdiff_t>(n * elemSize));
+            BITMANIP_ASSERT(expected == actual);
+
+            unshuffleBits(actual.data(), unshuffled.data(), elemSize, count);
+            BITMANIP_ASSERT(unshuffled == src);
+        }
+    }
+}
+
+}  // namespace
+}  // namespace bitmanip
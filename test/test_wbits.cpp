@@ -0,0 +1,250 @@
+#include "bitmanip/wbits.hpp"
+
+#include "test.hpp"
+
+#include <vector>
+
+namespace bitmanip {
+namespace {
+
+template <typename Uint>
+std::vector<bool> toBools(const Uint words[], std::size_t count)
+{
+    std::vector<bool> result(count * bits_v<Uint>);
+    for (std::size_t i = 0; i < result.size(); ++i) {
+        result[i] = (words[i / bits_v<Uint>] >> (i % bits_v<Uint>)) & 1;
+    }
+    return result;
+}
+
+std::vector<bool> toBools(const wide::DynamicBits &bits)
+{
+    std::vector<bool> result(bits.size());
+    for (std::size_t i = 0; i < bits.size(); ++i) {
+        result[i] = bits[i];
+    }
+    return result;
+}
+
+template <typename Uint>
+void testShifts(fast_rng64 &rng)
+{
+    for (std::size_t count : {1, 2, 5, 8, 9, 17, 40}) {
+        std::vector<Uint> words(count);
+        for (Uint &w : words) {
+            w = static_cast<Uint>(rng());
+        }
+        const std::vector<bool> bools = toBools(words.data(), count);
+        const std::size_t totalBits = bools.size();
+
+        constexpr std::size_t typeBits = bits_v<Uint>;
+        for (std::size_t shift :
+             {std::size_t{0}, std::size_t{1}, typeBits - 1, typeBits, typeBits + 3, totalBits / 2 + 1, totalBits - 1,
+              totalBits, totalBits + 9}) {
+            std::vector<bool> expectedLeft(totalBits), expectedRight(totalBits);
+            for (std::size_t i = 0; i < totalBits; ++i) {
+                expectedLeft[i] = i >= shift && bools[i - shift];
+                expectedRight[i] = i + shift < totalBits && bools[i + shift];
+            }
+
+            std::vector<Uint> left = words;
+            wide::leftShift(left.data(), shift, count);
+            BITMANIP_ASSERT(toBools(left.data(), count) == expectedLeft);
+
+            std::vector<Uint> right = words;
+            wide::rightShift(right.data(), shift, count);
+            BITMANIP_ASSERT(toBools(right.data(), count) == expectedRight);
+        }
+    }
+}
+
+BITMANIP_TEST(wbits, shift_matches_naive)
+{
+    fast_rng64 rng{12345};
+    testShifts<std::uint8_t>(rng);
+    testShifts<std::uint32_t>(rng);
+    testShifts<std::uint64_t>(rng);
+}
+
+BITMANIP_TEST(wbits, bitwise_matches_naive)
+{
+    fast_rng64 rng{12345};
+
+    for (std::size_t count : {0, 1, 3, 4, 7, 8, 100}) {
+        std::vector<std::uint64_t> a(count), b(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            a[i] = rng();
+            b[i] = rng();
+        }
+
+        std::vector<std::uint64_t> actual = a;
+        wide::bitAnd(actual.data(), b.data(), count);
+        for (std::size_t i = 0; i < count; ++i) {
+            BITMANIP_ASSERT_EQ(actual[i], a[i] & b[i]);
+        }
+        actual = a;
+        wide::bitOr(actual.data(), b.data(), count);
+        for (std::size_t i = 0; i < count; ++i) {
+            BITMANIP_ASSERT_EQ(actual[i], a[i] | b[i]);
+        }
+        actual = a;
+        wide::bitXor(actual.data(), b.data(), count);
+        for (std::size_t i = 0; i < count; ++i) {
+            BITMANIP_ASSERT_EQ(actual[i], a[i] ^ b[i]);
+        }
+        actual = a;
+        wide::bitAndNot(actual.data(), b.data(), count);
+        for (std::size_t i = 0; i < count; ++i) {
+            BITMANIP_ASSERT_EQ(actual[i], a[i] & ~b[i]);
+        }
+        actual = a;
+        wide::bitNot(actual.data(), count);
+        for (std::size_t i = 0; i < count; ++i) {
+            BITMANIP_ASSERT_EQ(actual[i], ~a[i]);
+        }
+    }
+}
+
+constexpr wide::Bits<100> makeConstexprBits()
+{
+    wide::Bits<100> bits = 0b101;
+    bits <<= 98;
+    return bits;
+}
+
+BITMANIP_TEST(wbits, bits_manual)
+{
+    constexpr wide::Bits<100> bits = makeConstexprBits();
+    // the highest bit was shifted out of the 100 bits
+    BITMANIP_STATIC_ASSERT_EQ(bits.count(), 1u);
+    BITMANIP_STATIC_ASSERT_EQ(bits.data()[1], std::uint64_t{1} << 34);
+    BITMANIP_STATIC_ASSERT_EQ((~bits).count(), 99u);
+    constexpr wide::Bits<100> shifted = bits >> 98;
+    BITMANIP_STATIC_ASSERT_EQ(shifted.data()[0], 1u);
+    BITMANIP_ASSERT(bool(bits));
+    BITMANIP_ASSERT(not bool(bits & ~bits));
+    BITMANIP_ASSERT((bits | ~bits) == ~wide::Bits<100>{});
+}
+
+BITMANIP_TEST(wbits, dynamicBits_manual)
+{
+    wide::DynamicBits bits{130};
+    BITMANIP_ASSERT_EQ(bits.size(), 130u);
+    BITMANIP_ASSERT_EQ(bits.wordCount(), 3u);
+    BITMANIP_ASSERT_EQ(reinterpret_cast<std::uintptr_t>(bits.data()) % wide::DynamicBits::ALIGNMENT, 0u);
+    BITMANIP_ASSERT(bits.none());
+    BITMANIP_ASSERT_EQ(bits.findFirst(), 130u);
+
+    bits.set(3);
+    bits.set(64);
+    bits.set(129);
+    BITMANIP_ASSERT_EQ(bits.count(), 3u);
+    BITMANIP_ASSERT_EQ(bits.findFirst(), 3u);
+    BITMANIP_ASSERT_EQ(bits.findNext(3), 64u);
+    BITMANIP_ASSERT_EQ(bits.findNext(64), 129u);
+    BITMANIP_ASSERT_EQ(bits.findNext(129), 130u);
+
+    bits.flipAll();
+    BITMANIP_ASSERT_EQ(bits.count(), 127u);
+    BITMANIP_ASSERT(not bits.test(64));
+    bits.flip(64);
+    bits.set(3, true);
+    bits.set(129);
+    BITMANIP_ASSERT(bits.all());
+
+    // new bits are set past the old size, also within the old last word
+    bits.resetAll();
+    bits.resize(200, true);
+    BITMANIP_ASSERT_EQ(bits.count(), 70u);
+    BITMANIP_ASSERT_EQ(bits.findFirst(), 130u);
+    bits.resize(140);
+    BITMANIP_ASSERT_EQ(bits.count(), 10u);
+    bits.reset(130);
+    BITMANIP_ASSERT_EQ(bits.findFirst(), 131u);
+
+    bits <<= 5;
+    BITMANIP_ASSERT_EQ(bits.count(), 4u);
+    BITMANIP_ASSERT_EQ(bits.findFirst(), 136u);
+    bits >>= 136;
+    BITMANIP_ASSERT_EQ(bits.count(), 4u);
+    BITMANIP_ASSERT_EQ(bits.findFirst(), 0u);
+    BITMANIP_ASSERT(bits != wide::DynamicBits{140});
+    BITMANIP_ASSERT(bits == (bits | wide::DynamicBits{140}));
+
+    wide::DynamicBits empty;
+    BITMANIP_ASSERT_EQ(empty.findFirst(), 0u);
+    BITMANIP_ASSERT_EQ(empty.count(), 0u);
+    BITMANIP_ASSERT(not empty.any());
+    empty <<= 5;
+    empty >>= 5;
+    empty.flipAll();
+    BITMANIP_ASSERT(empty.none());
+    BITMANIP_ASSERT(empty.all());
+    BITMANIP_ASSERT_EQ(wide::DynamicBits{0}.findFirst(), 0u);
+}
+
+BITMANIP_TEST(wbits, dynamicBits_matches_naive)
+{
+    fast_rng64 rng{12345};
+
+    for (std::size_t size : {1, 63, 64, 65, 1000, 4099}) {
+        wide::DynamicBits a{size}, b{size};
+        std::vector<bool> expectedA(size), expectedB(size);
+        for (std::size_t i = 0; i < size; ++i) {
+            expectedA[i] = rng() % 3 == 0;
+            expectedB[i] = rng() % 2 == 0;
+            a.set(i, expectedA[i]);
+            b.set(i, expectedB[i]);
+        }
+
+        std::vector<bool> expected(size);
+        for (std::size_t i = 0; i < size; ++i) {
+            expected[i] = expectedA[i] && expectedB[i];
+        }
+        BITMANIP_ASSERT(toBools(a & b) == expected);
+        for (std::size_t i = 0; i < size; ++i) {
+            expected[i] = expectedA[i] || expectedB[i];
+        }
+        BITMANIP_ASSERT(toBools(a | b) == expected);
+        for (std::size_t i = 0; i < size; ++i) {
+            expected[i] = expectedA[i] != expectedB[i];
+        }
+        BITMANIP_ASSERT(toBools(a ^ b) == expected);
+        for (std::size_t i = 0; i < size; ++i) {
+            expected[i] = expectedA[i] && not expectedB[i];
+        }
+        BITMANIP_ASSERT(toBools(a - b) == expected);
+        for (std::size_t i = 0; i < size; ++i) {
+            expected[i] = not expectedA[i];
+        }
+        BITMANIP_ASSERT(toBools(~a) == expected);
+
+        for (std::size_t shift : {std::size_t{1}, std::size_t{64}, size / 3, size}) {
+            for (std::size_t i = 0; i < size; ++i) {
+                expected[i] = i >= shift && expectedA[i - shift];
+            }
+            BITMANIP_ASSERT(toBools(a << shift) == expected);
+            for (std::size_t i = 0; i < size; ++i) {
+                expected[i] = i + shift < size && expectedA[i + shift];
+            }
+            BITMANIP_ASSERT(toBools(a >> shift) == expected);
+        }
+
+        std::size_t expectedCount = 0;
+        std::vector<std::size_t> expectedPositions, positions;
+        for (std::size_t i = 0; i < size; ++i) {
+            expectedCount += expectedA[i];
+            if (expectedA[i]) {
+                expectedPositions.push_back(i);
+            }
+        }
+        for (std::size_t i = a.findFirst(); i != a.size(); i = a.findNext(i)) {
+            positions.push_back(i);
+        }
+        BITMANIP_ASSERT_EQ(a.count(), expectedCount);
+        BITMANIP_ASSERT(positions == expectedPositions);
+    }
+}
+
+}  // namespace
+}  // namespace bitmanip